@@ -0,0 +1,378 @@
+/*H**********************************************************************
+* FILENAME: batch.c
+*
+* DESCRIPTION:
+*   Solving a stream of mazes or queries on a pool of worker threads.
+*
+* PUBLIC FUNCTIONS:
+*   int batch_solve( threads )
+*   int batch_queries( threads )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+// Needed for pthreads
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "batch.h"
+#include "solver.h"
+
+/* Number of mazes handed to the workers at once. While the workers solve
+ * one chunk the main thread reads the next one. */
+#define CHUNK_SIZE 256
+
+/* A chunk holds either mazes to solve or start and destination indices of
+ * queries on the shared maze of the pool. */
+struct chunk {
+    struct maze *mazes[CHUNK_SIZE];
+    int64_t starts[CHUNK_SIZE];
+    int64_t finishes[CHUNK_SIZE];
+    int64_t results[CHUNK_SIZE];
+    size_t size;
+};
+
+struct pool {
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t done;
+    const struct maze *shared;
+    struct chunk *chunk;
+    size_t next;
+    size_t finished;
+    unsigned long generation;
+    bool quit;
+};
+
+/**
+ * Solve item 'i' of chunk 'c' with solver context 's'.
+ *
+ * @param p the pool.
+ * @param s the solver context of the worker.
+ * @param c the chunk.
+ * @param i index of the item in the chunk.
+ * @return
+ */
+static int64_t solve_item(const struct pool *p, struct solver *s,
+                          struct chunk *c, size_t i) {
+    if (s == NULL) return ERROR;
+
+    if (p->shared != NULL) {
+        return solver_bfs_query(s, p->shared, c->starts[i], c->finishes[i]);
+    }
+
+    return solver_bfs(s, c->mazes[i]);
+}
+
+/**
+ * Worker thread. Claims items from the current chunk until all are taken
+ * and then waits for the next chunk.
+ *
+ * @param arg the pool.
+ * @return
+ */
+static void *worker(void *arg) {
+    struct pool *p = arg;
+    struct solver *s = solver_init();
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&p->lock);
+
+    while (true) {
+        while (p->generation == seen && !p->quit) {
+            pthread_cond_wait(&p->work, &p->lock);
+        }
+
+        if (p->quit) break;
+
+        seen = p->generation;
+        struct chunk *c = p->chunk;
+
+        while (p->next < c->size) {
+            size_t i = p->next++;
+
+            pthread_mutex_unlock(&p->lock);
+            c->results[i] = solve_item(p, s, c, i);
+            pthread_mutex_lock(&p->lock);
+
+            if (++p->finished == c->size) pthread_cond_signal(&p->done);
+        }
+    }
+
+    pthread_mutex_unlock(&p->lock);
+    solver_cleanup(s);
+
+    return NULL;
+}
+
+/**
+ * Skip the empty lines before the next maze on stdin. Return 1 if the
+ * input ends there, 0 if a maze follows.
+ *
+ * @return
+ */
+static int end_of_mazes(void) {
+    int ch;
+
+    while ((ch = getc(stdin)) == '\n') continue;
+
+    if (ch == EOF) return 1;
+
+    ungetc(ch, stdin);
+
+    return 0;
+}
+
+/**
+ * Read up to CHUNK_SIZE mazes from stdin. Return 0 if the end of the input
+ * or a full chunk was reached, 1 if a maze could not be read, also when it
+ * is the last one.
+ *
+ * @param c the chunk.
+ * @return
+ */
+static int read_mazes(struct chunk *c) {
+    c->size = 0;
+
+    while (c->size < CHUNK_SIZE) {
+        if (end_of_mazes()) return ferror(stdin) ? 1 : 0;
+
+        struct maze *m = maze_read();
+
+        if (m == NULL) return 1;
+
+        c->mazes[c->size++] = m;
+    }
+
+    return 0;
+}
+
+/**
+ * Read up to CHUNK_SIZE queries on maze m from stdin. A query is a line
+ * with the row and column of the start and of the destination. Return 0
+ * if the end of the input or a full chunk was reached, 1 if a query could
+ * not be read or lies outside the maze.
+ *
+ * @param c the chunk.
+ * @param m the shared maze.
+ * @return
+ */
+static int read_queries(struct chunk *c, const struct maze *m) {
+    c->size = 0;
+
+    while (c->size < CHUNK_SIZE) {
+        int r1, c1, r2, c2;
+        int read = scanf("%d %d %d %d", &r1, &c1, &r2, &c2);
+
+        if (read == EOF) return 0;
+        if (read != 4) return 1;
+
+        if (!maze_valid_move(m, r1, c1) || !maze_valid_move(m, r2, c2)) {
+            return 1;
+        }
+
+        c->mazes[c->size] = NULL;
+        c->starts[c->size] = maze_index(m, r1, c1);
+        c->finishes[c->size] = maze_index(m, r2, c2);
+        c->size++;
+    }
+
+    return 0;
+}
+
+/**
+ * Read the next chunk of mazes, or of queries if the pool has a shared
+ * maze.
+ *
+ * @param p the pool.
+ * @param c the chunk.
+ * @return
+ */
+static int read_chunk(const struct pool *p, struct chunk *c) {
+    if (p->shared != NULL) return read_queries(c, p->shared);
+
+    return read_mazes(c);
+}
+
+/**
+ * Print the results of a chunk in input order and free its mazes.
+ *
+ * @param c the chunk.
+ */
+static void flush_chunk(struct chunk *c) {
+    for (size_t i = 0; i < c->size; i++) {
+        if (c->results[i] == ERROR) {
+            printf("bfs failed\n");
+        } else if (c->results[i] == NOT_FOUND) {
+            printf("no path found from start to destination\n");
+        } else {
+            printf("bfs found a path of length: %" PRId64 "\n", c->results[i]);
+        }
+
+        if (c->mazes[i] != NULL) maze_cleanup(c->mazes[i]);
+    }
+
+    c->size = 0;
+}
+
+/**
+ * Hand a chunk to the workers.
+ *
+ * @param p the pool.
+ * @param c the chunk.
+ */
+static void start_chunk(struct pool *p, struct chunk *c) {
+    pthread_mutex_lock(&p->lock);
+
+    p->chunk = c;
+    p->next = 0;
+    p->finished = 0;
+    p->generation++;
+
+    pthread_cond_broadcast(&p->work);
+    pthread_mutex_unlock(&p->lock);
+}
+
+/**
+ * Wait until the workers solved every maze of the current chunk.
+ *
+ * @param p the pool.
+ */
+static void wait_chunk(struct pool *p) {
+    pthread_mutex_lock(&p->lock);
+
+    while (p->finished < p->chunk->size) {
+        pthread_cond_wait(&p->done, &p->lock);
+    }
+
+    pthread_mutex_unlock(&p->lock);
+}
+
+/**
+ * Solve all mazes, or all queries on maze 'shared', from stdin with a pool
+ * of worker threads.
+ *
+ * @param shared the maze shared by all queries or NULL.
+ * @param threads number of worker threads.
+ * @return
+ */
+static int run_pool(const struct maze *shared, size_t threads) {
+    if (threads == 0) threads = 1;
+
+    pthread_t *tids = malloc(sizeof(pthread_t) * threads);
+    struct chunk *chunks = malloc(sizeof(struct chunk) * 2);
+
+    if (tids == NULL || chunks == NULL) {
+        free(tids);
+        free(chunks);
+
+        return 1;
+    }
+
+    struct pool p = {
+        .shared = shared,
+        .chunk = NULL,
+        .next = 0,
+        .finished = 0,
+        .generation = 0,
+        .quit = false
+    };
+
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.work, NULL);
+    pthread_cond_init(&p.done, NULL);
+
+    size_t started = 0;
+
+    while (started < threads) {
+        if (pthread_create(&tids[started], NULL, worker, &p) != 0) break;
+
+        started++;
+    }
+
+    int error = started == 0;
+    int current = 0;
+
+    chunks[current].size = 0;
+
+    if (!error) error = read_chunk(&p, &chunks[current]);
+
+    // Read the next chunk while the workers solve the current one.
+    while (chunks[current].size > 0) {
+        start_chunk(&p, &chunks[current]);
+
+        int next_error = error ? 0 : read_chunk(&p, &chunks[1 - current]);
+
+        if (error) chunks[1 - current].size = 0;
+
+        wait_chunk(&p);
+        flush_chunk(&chunks[current]);
+
+        error |= next_error;
+        current = 1 - current;
+    }
+
+    pthread_mutex_lock(&p.lock);
+    p.quit = true;
+    pthread_cond_broadcast(&p.work);
+    pthread_mutex_unlock(&p.lock);
+
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+
+    pthread_cond_destroy(&p.done);
+    pthread_cond_destroy(&p.work);
+    pthread_mutex_destroy(&p.lock);
+
+    free(chunks);
+    free(tids);
+
+    if (error) fprintf(stderr, "Error reading %s\n", shared ? "query" : "maze");
+
+    return error;
+}
+
+/**
+ * Solve all mazes on stdin with a pool of worker threads.
+ *
+ * @param threads number of worker threads.
+ * @return
+ */
+int batch_solve(size_t threads) {
+    return run_pool(NULL, threads);
+}
+
+/**
+ * Read one maze from stdin and solve all queries that follow it with a
+ * pool of worker threads sharing the maze.
+ *
+ * @param threads number of worker threads.
+ * @return
+ */
+int batch_queries(size_t threads) {
+    struct maze *m = maze_read();
+
+    // Every query expands cells of the same maze, so the masks pay off.
+    if (m == NULL || maze_build_masks(m) != 0) {
+        fprintf(stderr, "Error reading maze\n");
+
+        if (m != NULL) maze_cleanup(m);
+
+        return 1;
+    }
+
+    int error = run_pool(m, threads);
+
+    maze_cleanup(m);
+
+    return error;
+}
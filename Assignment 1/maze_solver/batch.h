@@ -0,0 +1,17 @@
+#include <stddef.h>
+
+/* Reads a stream of mazes separated by empty lines from stdin and solves
+ * them with a breadth-first search on a pool of 'threads' workers. Every
+ * worker keeps its own solver context, so buffers are reused between
+ * mazes. One result line is printed to stdout per maze, in input order.
+ * Returns 0 if every maze was read successfully, 1 otherwise. */
+int batch_solve(size_t threads);
+
+/* Reads one maze from stdin followed by an empty line and queries, one per
+ * line, with the row and column of a start and of a destination. The
+ * queries are solved with a breadth-first search on a pool of 'threads'
+ * workers that share the read-only maze. One result line is printed to
+ * stdout per query, in input order.
+ * Returns 0 if the maze and every query were read successfully, 1 otherwise.
+ */
+int batch_queries(size_t threads);
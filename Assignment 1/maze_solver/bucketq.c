@@ -0,0 +1,218 @@
+/*H**********************************************************************
+* FILENAME: bucketq.c
+*
+* DESCRIPTION:
+*   Bucket queue of maze cells keyed by integer distance (Dial).
+*
+* PUBLIC FUNCTIONS:
+*   struct bucketq *bucketq_init( cells, max_cost )
+*   void bucketq_cleanup( q )
+*   int bucketq_push( q, index, dist )
+*   int64_t bucketq_pop( q, dist )
+*   void bucketq_clear( q )
+*   size_t bucketq_size( q )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bucketq.h"
+
+#define NOT_QUEUED (-2)
+
+/* All queued distances lie in [current, current + max_cost], so a ring of
+ * max_cost + 1 buckets holds them without collisions. The cells of a
+ * bucket form a doubly linked list through 'next' and 'prev', which makes
+ * moving a cell to another bucket O(1). Cells are appended at the 'tail'
+ * and popped from the 'head', so equal distances leave in FIFO order. A
+ * cell that is not queued has 'prev' set to NOT_QUEUED; the first cell of
+ * a bucket has 'prev' -1 and the last one 'next' -1. */
+struct bucketq {
+    int64_t *head;
+    int64_t *tail;
+    int64_t *next;
+    int64_t *prev;
+    int64_t *dist;
+    size_t buckets;
+    size_t cells;
+    size_t size;
+    int64_t current;
+};
+
+/**
+ * Reserve bytes in memory for the bucket queue and its links.
+ *
+ * @param cells the number of cells that can be queued.
+ * @param max_cost the largest cost of a move.
+ * @return
+ */
+struct bucketq *bucketq_init(size_t cells, int max_cost) {
+    if (max_cost < 0) return NULL;
+
+    struct bucketq *q = malloc(sizeof(struct bucketq));
+
+    if (q == NULL) return NULL;
+
+    q->buckets = (size_t) max_cost + 1;
+    q->head = malloc(sizeof(int64_t) * q->buckets);
+    q->tail = malloc(sizeof(int64_t) * q->buckets);
+    q->next = malloc(sizeof(int64_t) * (cells ? cells : 1));
+    q->prev = malloc(sizeof(int64_t) * (cells ? cells : 1));
+    q->dist = malloc(sizeof(int64_t) * (cells ? cells : 1));
+
+    if (q->head == NULL || q->tail == NULL || q->next == NULL
+        || q->prev == NULL || q->dist == NULL) {
+        bucketq_cleanup(q);
+
+        return NULL;
+    }
+
+    for (size_t b = 0; b < q->buckets; b++) q->head[b] = q->tail[b] = -1;
+    for (size_t i = 0; i < cells; i++) q->prev[i] = NOT_QUEUED;
+
+    q->cells = cells;
+    q->size = 0;
+    q->current = 0;
+
+    return q;
+}
+
+/**
+ * Free memory from bucket queue and sub variables.
+ *
+ * @param q the bucket queue.
+ */
+void bucketq_cleanup(struct bucketq *q) {
+    if (q == NULL) return;
+
+    free(q->head);
+    free(q->tail);
+    free(q->next);
+    free(q->prev);
+    free(q->dist);
+
+    free(q);
+}
+
+/**
+ * Unlink a queued cell from its bucket.
+ *
+ * @param q the bucket queue.
+ * @param index the cell.
+ */
+static void unlink_cell(struct bucketq *q, int64_t index) {
+    int64_t next = q->next[index];
+    int64_t prev = q->prev[index];
+    size_t b = (size_t) q->dist[index] % q->buckets;
+
+    if (prev < 0) {
+        q->head[b] = next;
+    } else {
+        q->next[prev] = next;
+    }
+
+    if (next < 0) {
+        q->tail[b] = prev;
+    } else {
+        q->prev[next] = prev;
+    }
+
+    q->prev[index] = NOT_QUEUED;
+    q->size--;
+}
+
+/**
+ * Insert a cell or move a queued cell to another distance. Return 0 if
+ * successful else 1.
+ *
+ * @param q the bucket queue.
+ * @param index the cell.
+ * @param dist the distance of the cell.
+ * @return
+ */
+int bucketq_push(struct bucketq *q, int64_t index, int64_t dist) {
+    if (q == NULL || index < 0 || (size_t) index >= q->cells) return 1;
+
+    // Outside the window the ring buckets would mix up distances.
+    if (dist < q->current || dist - q->current >= (int64_t) q->buckets) {
+        return 1;
+    }
+
+    if (q->prev[index] != NOT_QUEUED) unlink_cell(q, index);
+
+    size_t b = (size_t) dist % q->buckets;
+
+    q->dist[index] = dist;
+    q->prev[index] = q->tail[b];
+    q->next[index] = -1;
+
+    if (q->tail[b] >= 0) {
+        q->next[q->tail[b]] = index;
+    } else {
+        q->head[b] = index;
+    }
+
+    q->tail[b] = index;
+    q->size++;
+
+    return 0;
+}
+
+/**
+ * Remove a cell with the smallest distance. If empty return -1.
+ *
+ * @param q the bucket queue.
+ * @param dist set to the distance of the cell if not NULL.
+ * @return
+ */
+int64_t bucketq_pop(struct bucketq *q, int64_t *dist) {
+    if (q == NULL || q->size == 0) return -1;
+
+    // At most 'buckets' steps, as the window always holds a queued cell.
+    while (q->head[(size_t) q->current % q->buckets] < 0) q->current++;
+
+    int64_t index = q->head[(size_t) q->current % q->buckets];
+
+    unlink_cell(q, index);
+
+    if (dist != NULL) *dist = q->current;
+
+    return index;
+}
+
+/**
+ * Empty the queue while keeping the reserved memory.
+ *
+ * @param q the bucket queue.
+ */
+void bucketq_clear(struct bucketq *q) {
+    if (q == NULL) return;
+
+    for (size_t b = 0; b < q->buckets; b++) {
+        for (int64_t i = q->head[b]; i >= 0; i = q->next[i]) {
+            q->prev[i] = NOT_QUEUED;
+        }
+
+        q->head[b] = q->tail[b] = -1;
+    }
+
+    q->size = 0;
+    q->current = 0;
+}
+
+/**
+ * Return the number of queued cells.
+ *
+ * @param q the bucket queue.
+ * @return
+ */
+size_t bucketq_size(const struct bucketq *q) {
+    if (q == NULL) return 0;
+
+    return q->size;
+}
@@ -0,0 +1,35 @@
+#include <stddef.h>
+#include <stdint.h>
+
+/* Handle to a bucket queue (Dial's algorithm) of maze cells keyed by their
+ * integer distance. Queued distances must lie in the window from the last
+ * popped distance up to 'max_cost' beyond it, which holds for Dijkstra's
+ * algorithm with move costs of at most 'max_cost'. Every cell is at most
+ * once in the queue and all operations take O(1) amortized time. */
+struct bucketq;
+
+/* Return a pointer to a bucket queue for cell indices in the range
+ * [0, 'cells') and move costs of at most 'max_cost' if successful,
+ * otherwise return NULL. */
+struct bucketq *bucketq_init(size_t cells, int max_cost);
+
+/* Cleanup bucket queue. */
+void bucketq_cleanup(struct bucketq *q);
+
+/* Insert cell 'index' with distance 'dist', or move it to 'dist' if the
+ * cell is already queued.
+ * Return 0 if successful, 1 otherwise. */
+int bucketq_push(struct bucketq *q, int64_t index, int64_t dist);
+
+/* Remove a cell with the smallest distance and return it. Cells with equal
+ * distances are removed in the order they were pushed. If 'dist' is not
+ * NULL it is set to the distance of the cell.
+ * Return the cell index if successful, -1 otherwise. */
+int64_t bucketq_pop(struct bucketq *q, int64_t *dist);
+
+/* Remove all cells from the queue without releasing its memory and reset
+ * the distance window to start at 0. */
+void bucketq_clear(struct bucketq *q);
+
+/* Return the number of cells in the queue. */
+size_t bucketq_size(const struct bucketq *q);
@@ -0,0 +1,203 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bucketq.h"
+
+/* For older versions of the check library */
+#ifndef ck_assert_ptr_nonnull
+#define ck_assert_ptr_nonnull(X) _ck_assert_ptr(X, !=, NULL)
+#endif
+#ifndef ck_assert_ptr_null
+#define ck_assert_ptr_null(X) _ck_assert_ptr(X, ==, NULL)
+#endif
+
+
+START_TEST(test_bucketq_init_cleanup) {
+    struct bucketq *q = bucketq_init(10, 3);
+    ck_assert_ptr_nonnull(q);
+    ck_assert_int_eq(bucketq_size(q), 0);
+    bucketq_cleanup(q);
+
+    ck_assert_ptr_null(bucketq_init(10, -1));
+}
+END_TEST
+
+START_TEST(test_bucketq_order) {
+    struct bucketq *q = bucketq_init(10, 3);
+    int64_t dist;
+    ck_assert_int_eq(bucketq_push(q, 5, 3), 0);
+    ck_assert_int_eq(bucketq_push(q, 2, 1), 0);
+    ck_assert_int_eq(bucketq_push(q, 7, 0), 0);
+
+    ck_assert_int_eq(bucketq_pop(q, &dist), 7);
+    ck_assert_int_eq(dist, 0);
+    ck_assert_int_eq(bucketq_pop(q, &dist), 2);
+    ck_assert_int_eq(dist, 1);
+    ck_assert_int_eq(bucketq_pop(q, NULL), 5);
+    ck_assert_int_eq(bucketq_size(q), 0);
+    bucketq_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_bucketq_fifo) {
+    struct bucketq *q = bucketq_init(10, 1);
+    ck_assert_int_eq(bucketq_push(q, 4, 1), 0);
+    ck_assert_int_eq(bucketq_push(q, 1, 1), 0);
+    ck_assert_int_eq(bucketq_push(q, 8, 1), 0);
+    ck_assert_int_eq(bucketq_push(q, 3, 1), 0);
+
+    /* Moving a cell to the same distance sends it to the back. */
+    ck_assert_int_eq(bucketq_push(q, 1, 1), 0);
+
+    ck_assert_int_eq(bucketq_pop(q, NULL), 4);
+    ck_assert_int_eq(bucketq_pop(q, NULL), 8);
+    ck_assert_int_eq(bucketq_pop(q, NULL), 3);
+    ck_assert_int_eq(bucketq_pop(q, NULL), 1);
+    bucketq_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_bucketq_move) {
+    struct bucketq *q = bucketq_init(10, 4);
+    int64_t dist;
+    ck_assert_int_eq(bucketq_push(q, 0, 2), 0);
+    ck_assert_int_eq(bucketq_push(q, 1, 4), 0);
+    ck_assert_int_eq(bucketq_push(q, 2, 4), 0);
+    ck_assert_int_eq(bucketq_push(q, 3, 4), 0);
+
+    /* Move the middle and the last cell of a bucket to a smaller one. */
+    ck_assert_int_eq(bucketq_push(q, 2, 1), 0);
+    ck_assert_int_eq(bucketq_push(q, 3, 1), 0);
+    ck_assert_int_eq(bucketq_size(q), 4);
+
+    ck_assert_int_eq(bucketq_pop(q, &dist), 2);
+    ck_assert_int_eq(dist, 1);
+    ck_assert_int_eq(bucketq_pop(q, &dist), 3);
+    ck_assert_int_eq(dist, 1);
+    ck_assert_int_eq(bucketq_pop(q, &dist), 0);
+    ck_assert_int_eq(dist, 2);
+    ck_assert_int_eq(bucketq_pop(q, &dist), 1);
+    ck_assert_int_eq(dist, 4);
+
+    /* The moved cells leave no stale entries behind. */
+    ck_assert_int_eq(bucketq_pop(q, NULL), -1);
+    ck_assert_int_eq(bucketq_size(q), 0);
+    bucketq_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_bucketq_clear) {
+    struct bucketq *q = bucketq_init(4, 2);
+    for (int64_t i = 0; i < 4; i++) {
+        ck_assert_int_eq(bucketq_push(q, i, i % 3), 0);
+    }
+    ck_assert_int_eq(bucketq_pop(q, NULL), 0);
+
+    bucketq_clear(q);
+    ck_assert_int_eq(bucketq_size(q), 0);
+    ck_assert_int_eq(bucketq_pop(q, NULL), -1);
+
+    /* The window starts at 0 again. */
+    ck_assert_int_eq(bucketq_push(q, 2, 0), 0);
+    ck_assert_int_eq(bucketq_push(q, 3, 0), 0);
+    ck_assert_int_eq(bucketq_pop(q, NULL), 2);
+    ck_assert_int_eq(bucketq_pop(q, NULL), 3);
+    bucketq_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_bucketq_wrap_around) {
+    const int64_t cells = 1000;
+    struct bucketq *q = bucketq_init((size_t) cells, 2);
+    int64_t dist;
+
+    /* Walk the window around the three buckets many times. */
+    ck_assert_int_eq(bucketq_push(q, 0, 0), 0);
+    for (int64_t i = 0; i < cells; i++) {
+        ck_assert_int_eq(bucketq_pop(q, &dist), i);
+        ck_assert_int_eq(dist, 2 * i);
+        ck_assert_int_eq(bucketq_size(q), 0);
+
+        if (i + 1 < cells) {
+            ck_assert_int_eq(bucketq_push(q, i + 1, dist + 2), 0);
+        }
+    }
+    bucketq_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_bucketq_window) {
+    struct bucketq *q = bucketq_init(10, 2);
+    ck_assert_int_eq(bucketq_push(q, 0, 3), 1);
+    ck_assert_int_eq(bucketq_push(q, 0, -1), 1);
+    ck_assert_int_eq(bucketq_push(q, 0, 2), 0);
+    ck_assert_int_eq(bucketq_pop(q, NULL), 0);
+
+    /* The window moved to [2, 4]. */
+    ck_assert_int_eq(bucketq_push(q, 1, 1), 1);
+    ck_assert_int_eq(bucketq_push(q, 1, 5), 1);
+    ck_assert_int_eq(bucketq_push(q, 1, 4), 0);
+    ck_assert_int_eq(bucketq_size(q), 1);
+    bucketq_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_bucketq_out_of_range) {
+    struct bucketq *q = bucketq_init(4, 1);
+    ck_assert_int_eq(bucketq_push(q, 4, 0), 1);
+    ck_assert_int_eq(bucketq_push(q, -1, 0), 1);
+    ck_assert_int_eq(bucketq_size(q), 0);
+    ck_assert_int_eq(bucketq_pop(q, NULL), -1);
+    bucketq_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_bucketq_null_ptr) {
+    int64_t dist;
+    bucketq_cleanup(NULL);
+    bucketq_clear(NULL);
+    ck_assert_int_eq(bucketq_push(NULL, 0, 0), 1);
+    ck_assert_int_eq(bucketq_pop(NULL, &dist), -1);
+    ck_assert_int_eq(bucketq_size(NULL), 0);
+}
+END_TEST
+
+Suite *bucketq_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+    TCase *tc_limits;
+    s = suite_create("bucketq");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bucketq_init_cleanup);
+    tcase_add_test(tc_core, test_bucketq_order);
+    tcase_add_test(tc_core, test_bucketq_fifo);
+    tcase_add_test(tc_core, test_bucketq_move);
+    tcase_add_test(tc_core, test_bucketq_clear);
+
+    tc_limits = tcase_create("Limits");
+    tcase_add_test(tc_limits, test_bucketq_wrap_around);
+    tcase_add_test(tc_limits, test_bucketq_window);
+    tcase_add_test(tc_limits, test_bucketq_out_of_range);
+    tcase_add_test(tc_limits, test_bucketq_null_ptr);
+
+    suite_add_tcase(s, tc_core);
+    suite_add_tcase(s, tc_limits);
+
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = bucketq_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
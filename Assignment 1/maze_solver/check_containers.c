@@ -0,0 +1,250 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "containers.h"
+
+/* For older versions of the check library */
+#ifndef ck_assert_ptr_nonnull
+#define ck_assert_ptr_nonnull(X) _ck_assert_ptr(X, !=, NULL)
+#endif
+#ifndef ck_assert_ptr_null
+#define ck_assert_ptr_null(X) _ck_assert_ptr(X, ==, NULL)
+#endif
+
+/* An element as used by weighted searches. */
+struct item {
+    int64_t index;
+    int64_t dist;
+};
+
+DEFINE_STACK(item_stack, struct item)
+DEFINE_QUEUE(item_queue, struct item)
+DEFINE_DEQUE(item_deque, struct item)
+DEFINE_STACK(char_stack, char)
+
+
+START_TEST(test_stack_order) {
+    struct item_stack *s = item_stack_init(10);
+    ck_assert_ptr_nonnull(s);
+    ck_assert_int_eq(item_stack_push(s, (struct item) { 1, 10 }), 0);
+    ck_assert_int_eq(item_stack_push(s, (struct item) { 2, 20 }), 0);
+
+    struct item e;
+    ck_assert_int_eq(item_stack_peek(s, &e), 0);
+    ck_assert_int_eq(e.index, 2);
+    ck_assert_int_eq(item_stack_pop(s, &e), 0);
+    ck_assert_int_eq(e.index, 2);
+    ck_assert_int_eq(e.dist, 20);
+    ck_assert_int_eq(item_stack_pop(s, &e), 0);
+    ck_assert_int_eq(e.index, 1);
+    ck_assert_int_eq(e.dist, 10);
+    ck_assert_int_eq(item_stack_empty(s), 1);
+    item_stack_cleanup(s);
+}
+END_TEST
+
+START_TEST(test_queue_order) {
+    struct item_queue *q = item_queue_init(10);
+    ck_assert_ptr_nonnull(q);
+    ck_assert_int_eq(item_queue_push(q, (struct item) { 1, 10 }), 0);
+    ck_assert_int_eq(item_queue_push(q, (struct item) { 2, 20 }), 0);
+
+    struct item e;
+    ck_assert_int_eq(item_queue_peek(q, &e), 0);
+    ck_assert_int_eq(e.index, 1);
+    ck_assert_int_eq(item_queue_pop(q, &e), 0);
+    ck_assert_int_eq(e.index, 1);
+    ck_assert_int_eq(item_queue_pop(q, &e), 0);
+    ck_assert_int_eq(e.index, 2);
+    ck_assert_int_eq(e.dist, 20);
+    ck_assert_int_eq(item_queue_empty(q), 1);
+    item_queue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_deque_mixed) {
+    struct item_deque *d = item_deque_init(10);
+    ck_assert_ptr_nonnull(d);
+    ck_assert_int_eq(item_deque_push_back(d, (struct item) { 'b', 0 }), 0);
+    ck_assert_int_eq(item_deque_push_front(d, (struct item) { 'a', 0 }), 0);
+    ck_assert_int_eq(item_deque_push_back(d, (struct item) { 'c', 0 }), 0);
+
+    struct item e;
+    ck_assert_int_eq(item_deque_peek_front(d, &e), 0);
+    ck_assert_int_eq(e.index, 'a');
+    ck_assert_int_eq(item_deque_peek_back(d, &e), 0);
+    ck_assert_int_eq(e.index, 'c');
+    ck_assert_int_eq(item_deque_pop_back(d, &e), 0);
+    ck_assert_int_eq(e.index, 'c');
+    ck_assert_int_eq(item_deque_pop_front(d, &e), 0);
+    ck_assert_int_eq(e.index, 'a');
+    ck_assert_int_eq(item_deque_push_front(d, (struct item) { 'z', 0 }), 0);
+    ck_assert_int_eq(item_deque_pop_back(d, &e), 0);
+    ck_assert_int_eq(e.index, 'b');
+    ck_assert_int_eq(item_deque_pop_back(d, &e), 0);
+    ck_assert_int_eq(e.index, 'z');
+    item_deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_size_and_clear) {
+    struct item_queue *q = item_queue_init(10);
+    ck_assert_int_eq(item_queue_size(q), 0);
+    ck_assert_int_eq(item_queue_push(q, (struct item) { 1, 0 }), 0);
+    ck_assert_int_eq(item_queue_push(q, (struct item) { 2, 0 }), 0);
+    ck_assert_int_eq(item_queue_size(q), 2);
+    ck_assert_int_eq(item_queue_empty(q), 0);
+
+    item_queue_clear(q);
+    ck_assert_int_eq(item_queue_size(q), 0);
+    ck_assert_int_eq(item_queue_empty(q), 1);
+
+    struct item e;
+    ck_assert_int_eq(item_queue_push(q, (struct item) { 3, 0 }), 0);
+    ck_assert_int_eq(item_queue_pop(q, &e), 0);
+    ck_assert_int_eq(e.index, 3);
+    item_queue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_stack_grow) {
+    struct char_stack *s = char_stack_init(0);
+    ck_assert_ptr_nonnull(s);
+
+    for (int i = 0; i < 1000; i++) {
+        ck_assert_int_eq(char_stack_push(s, (char) ('a' + i % 26)), 0);
+    }
+
+    ck_assert_int_eq(char_stack_size(s), 1000);
+
+    for (int i = 999; i >= 0; i--) {
+        char c;
+        ck_assert_int_eq(char_stack_pop(s, &c), 0);
+        ck_assert_int_eq(c, 'a' + i % 26);
+    }
+
+    char_stack_cleanup(s);
+}
+END_TEST
+
+START_TEST(test_queue_grow_wrapped) {
+    struct item_queue *q = item_queue_init(4);
+    struct item e;
+
+    // Move the first element to the end of the buffer before it grows.
+    for (int64_t i = 0; i < 3; i++) {
+        ck_assert_int_eq(item_queue_push(q, (struct item) { i, 0 }), 0);
+        ck_assert_int_eq(item_queue_pop(q, &e), 0);
+    }
+
+    for (int64_t i = 0; i < 100; i++) {
+        ck_assert_int_eq(item_queue_push(q, (struct item) { i, -i }), 0);
+    }
+
+    for (int64_t i = 0; i < 100; i++) {
+        ck_assert_int_eq(item_queue_pop(q, &e), 0);
+        ck_assert_int_eq(e.index, i);
+        ck_assert_int_eq(e.dist, -i);
+    }
+
+    item_queue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_deque_grow_wrapped) {
+    struct item_deque *d = item_deque_init(2);
+    struct item e;
+
+    for (int64_t i = 0; i < 50; i++) {
+        ck_assert_int_eq(item_deque_push_front(d, (struct item) { i, 0 }), 0);
+    }
+
+    for (int64_t i = 0; i < 50; i++) {
+        ck_assert_int_eq(item_deque_pop_back(d, &e), 0);
+        ck_assert_int_eq(e.index, i);
+    }
+
+    item_deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_underflow) {
+    struct item_stack *s = item_stack_init(1);
+    struct item_queue *q = item_queue_init(1);
+    struct item_deque *d = item_deque_init(1);
+    struct item e = { 7, 7 };
+
+    ck_assert_int_eq(item_stack_pop(s, &e), 1);
+    ck_assert_int_eq(item_stack_peek(s, &e), 1);
+    ck_assert_int_eq(item_queue_pop(q, &e), 1);
+    ck_assert_int_eq(item_queue_peek(q, &e), 1);
+    ck_assert_int_eq(item_deque_pop_front(d, &e), 1);
+    ck_assert_int_eq(item_deque_pop_back(d, &e), 1);
+    ck_assert_int_eq(item_deque_peek_front(d, &e), 1);
+    ck_assert_int_eq(item_deque_peek_back(d, &e), 1);
+
+    // A failed pop leaves the output untouched.
+    ck_assert_int_eq(e.index, 7);
+
+    item_stack_cleanup(s);
+    item_queue_cleanup(q);
+    item_deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_null_ptr) {
+    struct item e = { 0, 0 };
+
+    ck_assert_int_eq(item_stack_push(NULL, e), 1);
+    ck_assert_int_eq(item_stack_pop(NULL, &e), 1);
+    ck_assert_int_eq(item_stack_empty(NULL), -1);
+    ck_assert_int_eq(item_queue_push(NULL, e), 1);
+    ck_assert_int_eq(item_queue_pop(NULL, &e), 1);
+    ck_assert_int_eq(item_queue_size(NULL), 0);
+    ck_assert_int_eq(item_deque_push_front(NULL, e), 1);
+    ck_assert_int_eq(item_deque_pop_back(NULL, &e), 1);
+    item_stack_cleanup(NULL);
+    item_queue_clear(NULL);
+    item_deque_stats(NULL);
+}
+END_TEST
+
+Suite *containers_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+    TCase *tc_limits;
+    s = suite_create("containers");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_stack_order);
+    tcase_add_test(tc_core, test_queue_order);
+    tcase_add_test(tc_core, test_deque_mixed);
+    tcase_add_test(tc_core, test_size_and_clear);
+
+    tc_limits = tcase_create("Limits");
+    tcase_add_test(tc_limits, test_stack_grow);
+    tcase_add_test(tc_limits, test_queue_grow_wrapped);
+    tcase_add_test(tc_limits, test_deque_grow_wrapped);
+    tcase_add_test(tc_limits, test_underflow);
+    tcase_add_test(tc_limits, test_null_ptr);
+
+    suite_add_tcase(s, tc_core);
+    suite_add_tcase(s, tc_limits);
+
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = containers_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
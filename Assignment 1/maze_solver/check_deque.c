@@ -0,0 +1,208 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "deque.h"
+
+/* For older versions of the check library */
+#ifndef ck_assert_ptr_nonnull
+#define ck_assert_ptr_nonnull(X) _ck_assert_ptr(X, !=, NULL)
+#endif
+#ifndef ck_assert_ptr_null
+#define ck_assert_ptr_null(X) _ck_assert_ptr(X, ==, NULL)
+#endif
+
+
+START_TEST(test_deque_init_cleanup) {
+    struct deque *d = deque_init(10);
+    ck_assert_ptr_nonnull(d);
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_push_return) {
+    struct deque *d = deque_init(10);
+    ck_assert_int_eq(deque_push_back(d, 'x'), 0);
+    ck_assert_int_eq(deque_push_front(d, 'y'), 0);
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_back_order) {
+    struct deque *d = deque_init(10);
+    ck_assert_int_eq(deque_push_back(d, 'x'), 0);
+    ck_assert_int_eq(deque_push_back(d, 'y'), 0);
+    ck_assert_int_eq(deque_push_back(d, 'z'), 0);
+
+    ck_assert_int_eq(deque_pop_front(d), 'x');
+    ck_assert_int_eq(deque_pop_front(d), 'y');
+    ck_assert_int_eq(deque_pop_front(d), 'z');
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_front_order) {
+    struct deque *d = deque_init(10);
+    ck_assert_int_eq(deque_push_front(d, 'x'), 0);
+    ck_assert_int_eq(deque_push_front(d, 'y'), 0);
+    ck_assert_int_eq(deque_push_front(d, 'z'), 0);
+
+    ck_assert_int_eq(deque_pop_front(d), 'z');
+    ck_assert_int_eq(deque_pop_front(d), 'y');
+    ck_assert_int_eq(deque_pop_front(d), 'x');
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_mixed) {
+    struct deque *d = deque_init(10);
+    ck_assert_int_eq(deque_push_back(d, 'b'), 0);
+    ck_assert_int_eq(deque_push_front(d, 'a'), 0);
+    ck_assert_int_eq(deque_push_back(d, 'c'), 0);
+
+    ck_assert_int_eq(deque_peek_front(d), 'a');
+    ck_assert_int_eq(deque_pop_back(d), 'c');
+    ck_assert_int_eq(deque_pop_front(d), 'a');
+    ck_assert_int_eq(deque_push_front(d, 'z'), 0);
+    ck_assert_int_eq(deque_pop_back(d), 'b');
+    ck_assert_int_eq(deque_pop_back(d), 'z');
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_empty) {
+    struct deque *d = deque_init(10);
+    ck_assert_int_eq(deque_empty(d), 1);
+
+    ck_assert_int_eq(deque_push_front(d, 'x'), 0);
+    ck_assert_int_eq(deque_empty(d), 0);
+    ck_assert_int_eq(deque_size(d), 1);
+
+    ck_assert_int_eq(deque_pop_back(d), 'x');
+    ck_assert_int_eq(deque_empty(d), 1);
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_clear) {
+    struct deque *d = deque_init(4);
+    for (int i = 0; i < 3; i++) {
+        ck_assert_int_eq(deque_push_front(d, i), 0);
+    }
+
+    deque_clear(d);
+    ck_assert_int_eq(deque_empty(d), 1);
+    ck_assert_int_eq(deque_pop_front(d), -1);
+
+    ck_assert_int_eq(deque_push_back(d, 'x'), 0);
+    ck_assert_int_eq(deque_pop_front(d), 'x');
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_grow_wrapped) {
+    struct deque *d = deque_init(4);
+    /* Wrap the ring buffer around before it has to grow. */
+    for (int i = 0; i < 3; i++) {
+        ck_assert_int_eq(deque_push_back(d, i), 0);
+    }
+    ck_assert_int_eq(deque_pop_front(d), 0);
+    ck_assert_int_eq(deque_pop_front(d), 1);
+
+    for (int i = 3; i < 20; i++) {
+        ck_assert_int_eq(deque_push_back(d, i), 0);
+    }
+    for (int i = 1; i <= 10; i++) {
+        ck_assert_int_eq(deque_push_front(d, -i), 0);
+    }
+
+    for (int i = 10; i >= 1; i--) {
+        ck_assert_int_eq(deque_pop_front(d), -i);
+    }
+    for (int i = 2; i < 20; i++) {
+        ck_assert_int_eq(deque_pop_front(d), i);
+    }
+    ck_assert_int_eq(deque_empty(d), 1);
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_zero_size_deque) {
+    struct deque *d = deque_init(0);
+    for (int i = 0; i < 100000; i++) {
+        ck_assert_int_eq(deque_push_front(d, i), 0);
+    }
+
+    for (int i = 0; i < 100000; i++) {
+        ck_assert_int_eq(deque_pop_back(d), i);
+    }
+
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_underflow) {
+    struct deque *d = deque_init(10);
+    for (int i = 0; i < 10; i++) {
+        ck_assert_int_eq(deque_pop_front(d), -1);
+        ck_assert_int_eq(deque_pop_back(d), -1);
+    }
+    ck_assert_int_eq(deque_peek_front(d), -1);
+    deque_cleanup(d);
+}
+END_TEST
+
+START_TEST(test_deque_null_ptr) {
+    deque_cleanup(NULL);
+    deque_stats(NULL);
+    deque_clear(NULL);
+    ck_assert_int_eq(deque_push_front(NULL, 'x'), 1);
+    ck_assert_int_eq(deque_push_back(NULL, 'x'), 1);
+    ck_assert_int_eq(deque_pop_front(NULL), -1);
+    ck_assert_int_eq(deque_pop_back(NULL), -1);
+    ck_assert_int_eq(deque_peek_front(NULL), -1);
+    ck_assert_int_eq(deque_empty(NULL), -1);
+    ck_assert_int_eq(deque_size(NULL), 0);
+}
+END_TEST
+
+Suite *deque_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+    TCase *tc_limits;
+    s = suite_create("deque");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_deque_init_cleanup);
+    tcase_add_test(tc_core, test_deque_push_return);
+    tcase_add_test(tc_core, test_deque_back_order);
+    tcase_add_test(tc_core, test_deque_front_order);
+    tcase_add_test(tc_core, test_deque_mixed);
+    tcase_add_test(tc_core, test_deque_empty);
+    tcase_add_test(tc_core, test_deque_clear);
+
+    tc_limits = tcase_create("Limits");
+    tcase_add_test(tc_limits, test_deque_grow_wrapped);
+    tcase_add_test(tc_limits, test_deque_zero_size_deque);
+    tcase_add_test(tc_limits, test_deque_underflow);
+    tcase_add_test(tc_limits, test_deque_null_ptr);
+
+    suite_add_tcase(s, tc_core);
+    suite_add_tcase(s, tc_limits);
+
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = deque_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
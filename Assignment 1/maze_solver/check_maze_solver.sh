@@ -48,8 +48,8 @@ function run_and_check_length() {
     fi
 
     # NOTE: error message is not correct when no path is found with ret val 0
-    "$PROG" < "$input" | grep "found a path of length:" > tmp || true
-    if grep "found a path of length:" "$ref_output" | diff - tmp > /dev/null;
+    "$PROG" < "$input" | grep "found a path of" > tmp || true
+    if grep "found a path of" "$ref_output" | diff - tmp > /dev/null;
     then
         echo "correct"
     else
@@ -120,6 +120,9 @@ do
     if [[ $PROG == *maze_solver_bfs ]];
     then
         ref="$input.bfs_ref"
+    elif [[ $PROG == *maze_solver_dijkstra ]];
+    then
+        ref="$input.dijkstra_ref"
     else
         ref="$input.dfs_ref"
     fi
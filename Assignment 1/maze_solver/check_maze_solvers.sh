@@ -1,7 +1,8 @@
 #! /usr/bin/env bash
 
 # Check path length and path for all single_path files for both BFS and DFS
-inputs="mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt"
+inputs="mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+mazes/maze_7x15_rectangular.txt"
 
 echo "Checking the path length reported by the solvers for single path mazes..."
 ./check_maze_solver.sh ./maze_solver_bfs length 0 $inputs
@@ -32,3 +33,290 @@ echo "Checking the path length for special mazes..."
 # Check if mazes with no path are handled correctly
 ./check_maze_solver.sh ./maze_solver_bfs length 1 mazes/maze_impossible.txt
 
+
+# Weighted mazes: the cheapest path differs from the shortest one
+echo
+echo "Checking weighted mazes..."
+./check_maze_solver.sh ./maze_solver_dijkstra length 0 mazes/maze_9x9_weighted.txt
+./check_maze_solver.sh ./maze_solver_dijkstra path 0 mazes/maze_9x9_weighted.txt
+
+# Without weights Dijkstra finds a path as short as the one of BFS
+inputs="mazes/maze_7x7_single_path.txt mazes/maze_15x15_multiple_paths.txt
+mazes/maze_7x15_rectangular.txt"
+for input in $inputs
+do
+    echo -n "Checking unweighted $(basename "$input"): "
+    if diff <(./maze_solver_dijkstra < "$input" | head -n 1) \
+            <(head -n 1 "$input.bfs_ref" | sed 's/bfs/dijkstra/;s/length/cost/') \
+            > /dev/null;
+    then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+./check_maze_solver.sh ./maze_solver_dijkstra length 1 mazes/maze_impossible.txt
+
+# Conveyor cells are free: 0-1 BFS must agree with Dijkstra
+echo
+echo "Checking zero-cost moves..."
+inputs="mazes/maze_9x9_conveyor.txt"
+./check_maze_solver.sh ./maze_solver_dijkstra path 0 $inputs
+for input in $inputs mazes/maze_7x7_single_path.txt mazes/maze_7x15_rectangular.txt
+do
+    echo -n "Checking 0-1 bfs on $(basename "$input"): "
+    if diff <(./maze_solver_bfs --zero-one < "$input" | sed 's/bfs/dijkstra/') \
+            <(./maze_solver_dijkstra < "$input") > /dev/null;
+    then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+
+
+# Distance field to the nearest of several destinations
+echo
+echo "Checking the distance field of ./maze_solver_field..."
+input=mazes/maze_9x9_exits.txt
+echo -n "Checking $(basename "$input"): "
+if diff <(./maze_solver_field --u16 < "$input" | od -An -tu2 -w18) \
+        "$input.field_ref" > /dev/null;
+then
+    echo "correct"
+else
+    echo "not correct"
+fi
+
+
+# Hierarchical planning: single path mazes have only one possible length,
+# and a saved abstraction must give the same results as a fresh one
+echo
+echo "Checking hierarchical planning of ./maze_solver_hpa..."
+abstraction=$(mktemp)
+rm -f "$abstraction"
+inputs="mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+mazes/maze_7x15_rectangular.txt"
+for input in $inputs
+do
+    echo -n "Checking $(basename "$input"): "
+    length=$(head -n 1 "$input.bfs_ref" | sed 's/bfs/hpa/')
+    if diff <(./maze_solver_hpa --cluster 4 < "$input" | head -n 1) \
+            <(echo "$length") > /dev/null \
+        && diff <(./maze_solver_hpa --cluster 4 --abstraction "$abstraction" < "$input") \
+                <(./maze_solver_hpa --cluster 4 --abstraction "$abstraction" < "$input") \
+                > /dev/null;
+    then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+    rm -f "$abstraction"
+done
+
+# A saved abstraction whose first entrance lies in another cluster must be
+# rejected and rebuilt; the node count sits at byte 24, the cells at 40
+input="mazes/maze_15x15_multiple_paths.txt"
+echo -n "Checking a corrupted abstraction of $(basename "$input"): "
+./maze_solver_hpa --cluster 4 --abstraction "$abstraction" < "$input" \
+    > /dev/null
+cp "$abstraction" "$abstraction.orig"
+nodes=$(od -An -t d8 -j 24 -N 8 "$abstraction" | tr -d ' ')
+dd if="$abstraction.orig" of="$abstraction" bs=1 skip=$((40 + 8 * (nodes - 1))) \
+    seek=40 count=8 conv=notrunc 2> /dev/null
+if ./maze_solver_hpa --cluster 4 --abstraction "$abstraction" < "$input" \
+        > /dev/null \
+    && cmp -s "$abstraction" "$abstraction.orig";
+then
+    echo "correct"
+else
+    echo "not correct"
+fi
+rm -f "$abstraction" "$abstraction.orig"
+
+
+# Anytime planning: without a deadline the search ends with the shortest
+# path and a bound of 1, and a generous deadline must not change that
+echo
+echo "Checking anytime planning of ./maze_solver_ara..."
+inputs="mazes/maze_7x7_single_path.txt mazes/maze_15x15_multiple_paths.txt
+mazes/maze_7x15_rectangular.txt mazes/maze_7x7_open.txt"
+for input in $inputs
+do
+    echo -n "Checking $(basename "$input"): "
+    expected=$(head -n 1 "$input.bfs_ref" | sed 's/bfs/ara/';
+               echo "suboptimality bound: 1.00")
+    if diff <(./maze_solver_ara < "$input" | head -n 2) \
+            <(echo "$expected") > /dev/null \
+        && diff <(./maze_solver_ara --deadline-ms 10000 < "$input" | head -n 2) \
+                <(echo "$expected") > /dev/null;
+    then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+./check_maze_solver.sh ./maze_solver_ara length 1 mazes/maze_impossible.txt \
+    mazes/maze_5x5_walled_start.txt
+
+
+# External-memory BFS: a tiny memory limit forces many sorted runs per
+# level, and a packed file must give the same result as the text maze
+echo
+echo "Checking external-memory bfs of ./maze_solver_external..."
+packed=$(mktemp)
+inputs="mazes/maze_7x7_single_path.txt mazes/maze_15x15_multiple_paths.txt
+mazes/maze_7x15_rectangular.txt mazes/maze_7x7_open.txt mazes/maze_impossible.txt"
+for input in $inputs
+do
+    echo -n "Checking $(basename "$input"): "
+    if ./maze_solver_external --pack "$packed" < "$input" \
+        && diff <(./maze_solver_external --mem-limit 64 < "$input" 2> /dev/null) \
+                <(head -n 1 "$input.bfs_ref") > /dev/null \
+        && diff <(./maze_solver_external "$packed" 2> /dev/null) \
+                <(head -n 1 "$input.bfs_ref") > /dev/null;
+    then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+rm -f "$packed"
+
+
+# Layered mazes: stairs lead to the layers above and below, and every
+# solver must find a path as short as the one of BFS
+echo
+echo "Checking layered mazes..."
+input=mazes/maze_7x7_layers.txt
+./check_maze_solver.sh ./maze_solver_bfs length 0 $input
+./check_maze_solver.sh ./maze_solver_bfs path 0 $input
+for solver in dijkstra ara lpa
+do
+    echo -n "Checking $solver on $(basename "$input"): "
+    length=$(head -n 1 "$input.bfs_ref" | sed "s/bfs/$solver/")
+    if diff <(./maze_solver_$solver < "$input" | head -n 1 | sed 's/cost/length/') \
+            <(echo "$length") > /dev/null;
+    then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+echo -n "Checking dfs on $(basename "$input"): "
+if ./maze_solver_dfs < "$input" | grep -q "dfs found a path";
+then
+    echo "correct"
+else
+    echo "not correct"
+fi
+
+
+# Sharded search: the result must not depend on the number of bands, even
+# with more bands than rows
+echo
+echo "Checking sharded bfs of ./maze_solver_bfs..."
+inputs="mazes/maze_7x7_single_path.txt mazes/maze_15x15_multiple_paths.txt
+mazes/maze_7x15_rectangular.txt mazes/maze_impossible.txt mazes/maze_7x7_layers.txt"
+for input in $inputs
+do
+    echo -n "Checking $(basename "$input"): "
+    correct=true
+    for bands in 1 2 3 64
+    do
+        if ! diff <(./maze_solver_bfs --bands $bands < "$input" 2> /dev/null | head -n 1) \
+                <(head -n 1 "$input.bfs_ref") > /dev/null;
+        then
+            correct=false
+        fi
+    done
+    if $correct && diff <(./maze_solver_bfs --bands 3 < "$input" 2> /dev/null) \
+                        <(./maze_solver_bfs < "$input") > /dev/null;
+    then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+
+
+# Batch mode must report the same results, in input order, as separate runs
+echo
+echo "Checking batch mode of ./maze_solver_bfs..."
+inputs="mazes/maze_7x7_single_path.txt mazes/maze_15x15_multiple_paths.txt
+mazes/maze_impossible.txt mazes/maze_7x7_open.txt"
+echo -n "Checking batch of $(echo $inputs | wc -w) mazes: "
+if diff <(for input in $inputs; do cat "$input"; echo; done \
+            | ./maze_solver_bfs --batch --threads 2) \
+        <(for input in $inputs; do ./maze_solver_bfs < "$input" | head -n 1; done) \
+        > /dev/null;
+then
+    echo "correct"
+else
+    echo "not correct"
+fi
+
+# A last maze without its final newline is an error, not the end of input
+input=mazes/maze_7x7_single_path.txt
+echo -n "Checking batch with a truncated last maze: "
+if (cat "$input"; echo; head -c -1 "$input") \
+        | ./maze_solver_bfs --batch > /dev/null 2>&1;
+then
+    echo "not correct"
+else
+    echo "correct"
+fi
+
+# Queries on a shared maze: start to destination and back, an empty path
+# and paths from and to a wall
+echo
+echo "Checking query mode of ./maze_solver_bfs..."
+input=mazes/maze_15x15_multiple_paths.txt
+echo -n "Checking queries on $(basename "$input"): "
+if diff <( (cat "$input"; echo; echo "1 1 13 13"; echo "13 13 1 1"; echo "1 1 1 1";
+            echo "1 2 1 1"; echo "1 1 1 2") \
+            | ./maze_solver_bfs --queries --threads 2) \
+        <(head -n 1 "$input.bfs_ref"; head -n 1 "$input.bfs_ref";
+          echo "bfs found a path of length: 0";
+          echo "no path found from start to destination";
+          echo "no path found from start to destination") > /dev/null;
+then
+    echo "correct"
+else
+    echo "not correct"
+fi
+input=mazes/maze_5x5_walled_start.txt
+echo -n "Checking a start in a wall of $(basename "$input"): "
+correct=true
+for bands in 0 1 2
+do
+    if ./maze_solver_bfs --bands $bands < "$input" > /dev/null 2>&1 \
+        || ! ./maze_solver_bfs --bands $bands < "$input" 2> /dev/null \
+            | grep -q "no path found from start to destination";
+    then
+        correct=false
+    fi
+done
+if $correct;
+then
+    echo "correct"
+else
+    echo "not correct"
+fi
+
+# Re-planning: closing and reopening a cell must give the original length
+echo
+echo "Checking re-planning of ./maze_solver_lpa..."
+for input in mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt
+do
+    echo -n "Checking updates on $(basename "$input"): "
+    length=$(head -n 1 "$input.bfs_ref" | sed 's/bfs/lpa/')
+    if diff <( (cat "$input"; echo; echo "3 3"; echo "3 3") \
+                | ./maze_solver_lpa | grep "found a path" | sort -u) \
+            <(echo "$length") > /dev/null;
+    then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
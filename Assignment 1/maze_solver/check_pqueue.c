@@ -0,0 +1,201 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pqueue.h"
+
+/* For older versions of the check library */
+#ifndef ck_assert_ptr_nonnull
+#define ck_assert_ptr_nonnull(X) _ck_assert_ptr(X, !=, NULL)
+#endif
+#ifndef ck_assert_ptr_null
+#define ck_assert_ptr_null(X) _ck_assert_ptr(X, ==, NULL)
+#endif
+
+
+START_TEST(test_pqueue_init_cleanup) {
+    struct pqueue *q = pqueue_init(10);
+    ck_assert_ptr_nonnull(q);
+    ck_assert_int_eq(pqueue_size(q), 0);
+    pqueue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_pqueue_order) {
+    struct pqueue *q = pqueue_init(10);
+    ck_assert_int_eq(pqueue_push(q, 3, 5, 0), 0);
+    ck_assert_int_eq(pqueue_push(q, 1, 2, 0), 0);
+    ck_assert_int_eq(pqueue_push(q, 7, 9, 0), 0);
+    ck_assert_int_eq(pqueue_push(q, 4, 1, 0), 0);
+
+    ck_assert_int_eq(pqueue_pop(q), 4);
+    ck_assert_int_eq(pqueue_pop(q), 1);
+    ck_assert_int_eq(pqueue_pop(q), 3);
+    ck_assert_int_eq(pqueue_pop(q), 7);
+    ck_assert_int_eq(pqueue_size(q), 0);
+    pqueue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_pqueue_second_key) {
+    struct pqueue *q = pqueue_init(10);
+    int64_t k1, k2;
+    ck_assert_int_eq(pqueue_push(q, 0, 4, 8), 0);
+    ck_assert_int_eq(pqueue_push(q, 1, 4, 2), 0);
+    ck_assert_int_eq(pqueue_push(q, 2, 5, 0), 0);
+
+    ck_assert_int_eq(pqueue_top_key(q, &k1, &k2), 0);
+    ck_assert_int_eq(k1, 4);
+    ck_assert_int_eq(k2, 2);
+    ck_assert_int_eq(pqueue_pop(q), 1);
+    ck_assert_int_eq(pqueue_pop(q), 0);
+    ck_assert_int_eq(pqueue_pop(q), 2);
+    pqueue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_pqueue_change_key) {
+    struct pqueue *q = pqueue_init(10);
+    for (int64_t i = 0; i < 5; i++) {
+        ck_assert_int_eq(pqueue_push(q, i, 10 + i, 0), 0);
+    }
+
+    /* Decrease the key of the last cell and increase that of the first. */
+    ck_assert_int_eq(pqueue_push(q, 4, 1, 0), 0);
+    ck_assert_int_eq(pqueue_push(q, 0, 20, 0), 0);
+    ck_assert_int_eq(pqueue_size(q), 5);
+
+    ck_assert_int_eq(pqueue_pop(q), 4);
+    ck_assert_int_eq(pqueue_pop(q), 1);
+    ck_assert_int_eq(pqueue_pop(q), 2);
+    ck_assert_int_eq(pqueue_pop(q), 3);
+    ck_assert_int_eq(pqueue_pop(q), 0);
+    pqueue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_pqueue_remove) {
+    struct pqueue *q = pqueue_init(10);
+    for (int64_t i = 0; i < 6; i++) {
+        ck_assert_int_eq(pqueue_push(q, i, i, 0), 0);
+    }
+
+    /* Remove the top, a leaf and a cell in between. */
+    pqueue_remove(q, 0);
+    pqueue_remove(q, 5);
+    pqueue_remove(q, 2);
+    pqueue_remove(q, 2);
+    ck_assert(!pqueue_contains(q, 2));
+    ck_assert(pqueue_contains(q, 3));
+    ck_assert_int_eq(pqueue_size(q), 3);
+
+    ck_assert_int_eq(pqueue_pop(q), 1);
+    ck_assert_int_eq(pqueue_pop(q), 3);
+    ck_assert_int_eq(pqueue_pop(q), 4);
+    ck_assert_int_eq(pqueue_pop(q), -1);
+
+    /* A removed cell can be queued again. */
+    ck_assert_int_eq(pqueue_push(q, 2, 0, 0), 0);
+    ck_assert_int_eq(pqueue_pop(q), 2);
+    pqueue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_pqueue_clear) {
+    struct pqueue *q = pqueue_init(4);
+    for (int64_t i = 0; i < 4; i++) {
+        ck_assert_int_eq(pqueue_push(q, i, -i, 0), 0);
+    }
+
+    pqueue_clear(q);
+    ck_assert_int_eq(pqueue_size(q), 0);
+    ck_assert(!pqueue_contains(q, 3));
+    ck_assert_int_eq(pqueue_pop(q), -1);
+
+    ck_assert_int_eq(pqueue_push(q, 3, 0, 0), 0);
+    ck_assert_int_eq(pqueue_pop(q), 3);
+    pqueue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_pqueue_full) {
+    const int64_t cells = 100000;
+    struct pqueue *q = pqueue_init((size_t) cells);
+
+    /* Fill every cell with keys in a scrambled order. */
+    for (int64_t i = 0; i < cells; i++) {
+        int64_t index = (i * 7919) % cells;
+        ck_assert_int_eq(pqueue_push(q, index, cells - index, 0), 0);
+    }
+    ck_assert_int_eq(pqueue_size(q), cells);
+
+    for (int64_t i = cells - 1; i >= 0; i--) {
+        ck_assert_int_eq(pqueue_pop(q), i);
+    }
+    pqueue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_pqueue_out_of_range) {
+    struct pqueue *q = pqueue_init(4);
+    int64_t k1, k2;
+    ck_assert_int_eq(pqueue_push(q, 4, 0, 0), 1);
+    ck_assert_int_eq(pqueue_push(q, -1, 0, 0), 1);
+    ck_assert(!pqueue_contains(q, 4));
+    ck_assert_int_eq(pqueue_top_key(q, &k1, &k2), 1);
+    pqueue_remove(q, -1);
+    pqueue_cleanup(q);
+}
+END_TEST
+
+START_TEST(test_pqueue_null_ptr) {
+    int64_t k1, k2;
+    pqueue_cleanup(NULL);
+    pqueue_clear(NULL);
+    pqueue_remove(NULL, 0);
+    ck_assert_int_eq(pqueue_push(NULL, 0, 0, 0), 1);
+    ck_assert_int_eq(pqueue_pop(NULL), -1);
+    ck_assert_int_eq(pqueue_top_key(NULL, &k1, &k2), 1);
+    ck_assert(!pqueue_contains(NULL, 0));
+    ck_assert_int_eq(pqueue_size(NULL), 0);
+}
+END_TEST
+
+Suite *pqueue_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+    TCase *tc_limits;
+    s = suite_create("pqueue");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_pqueue_init_cleanup);
+    tcase_add_test(tc_core, test_pqueue_order);
+    tcase_add_test(tc_core, test_pqueue_second_key);
+    tcase_add_test(tc_core, test_pqueue_change_key);
+    tcase_add_test(tc_core, test_pqueue_remove);
+    tcase_add_test(tc_core, test_pqueue_clear);
+
+    tc_limits = tcase_create("Limits");
+    tcase_add_test(tc_limits, test_pqueue_full);
+    tcase_add_test(tc_limits, test_pqueue_out_of_range);
+    tcase_add_test(tc_limits, test_pqueue_null_ptr);
+
+    suite_add_tcase(s, tc_core);
+    suite_add_tcase(s, tc_limits);
+
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = pqueue_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
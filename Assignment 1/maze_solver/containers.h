@@ -0,0 +1,211 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Macro templates for containers of any element type, such as structs
+ * with an index and a distance. The container is generated for one type,
+ * so elements are stored by value without void pointers, and all
+ * functions are static inline without calls through function pointers.
+ *
+ *   DEFINE_STACK(name, type)  last in, first out
+ *   DEFINE_QUEUE(name, type)  first in, first out
+ *   DEFINE_DEQUE(name, type)  pushes and pops at both ends
+ *
+ * The macros are used at file scope, without a semicolon after them.
+ * Each defines 'struct name' and functions with the name as prefix:
+ *
+ *   struct name *name_init(size_t capacity)
+ *       Return a container with an initial capacity of 'capacity' if
+ *       successful, otherwise NULL. The container doubles its capacity
+ *       when it is full.
+ *   void name_cleanup(struct name *c)
+ *   void name_stats(const struct name *c)
+ *       Print statistics to stderr in the format:
+ *       'stats' num_of_pushes num_of_pops max_elements
+ *   int name_empty(const struct name *c)
+ *       Return 1 if empty, 0 if not and -1 if the operation fails.
+ *   void name_clear(struct name *c)
+ *       Remove all elements but keep the memory; statistics are kept.
+ *   size_t name_size(const struct name *c)
+ *
+ * A stack and a queue add name_push(c, e), name_pop(c, &e) and
+ * name_peek(c, &e). A deque adds name_push_front, name_push_back,
+ * name_pop_front, name_pop_back, name_peek_front and name_peek_back.
+ * Pushes return 0 if successful, 1 otherwise. Pops and peeks store the
+ * element in '*e' and return 0, or return 1 if the container is empty.
+ *
+ * All containers keep their elements in a ring buffer, like struct
+ * deque, so they share the growth and statistics code below. A stack
+ * only uses the ring from its start. */
+
+#define CONTAINER_UNUSED_ __attribute__((unused))
+
+/* The struct and the functions shared by all containers. */
+#define CONTAINER_COMMON_(name, type)                                       \
+    struct name {                                                           \
+        type *data;                                                         \
+        size_t pushes;                                                      \
+        size_t pops;                                                        \
+        size_t max;                                                         \
+        size_t first;                                                       \
+        size_t length;                                                      \
+        size_t capacity;                                                    \
+    };                                                                      \
+                                                                            \
+    static inline CONTAINER_UNUSED_ struct name *name##_init(               \
+        size_t capacity) {                                                  \
+        if (!capacity) capacity = 1;                                        \
+        struct name *c = malloc(sizeof(struct name));                       \
+        if (c == NULL) return NULL;                                         \
+        c->data = malloc(sizeof(type) * capacity);                          \
+        if (c->data == NULL) {                                              \
+            free(c);                                                        \
+            return NULL;                                                    \
+        }                                                                   \
+        c->pushes = 0;                                                      \
+        c->pops = 0;                                                        \
+        c->max = 0;                                                         \
+        c->first = 0;                                                       \
+        c->length = 0;                                                      \
+        c->capacity = capacity;                                             \
+        return c;                                                           \
+    }                                                                       \
+                                                                            \
+    static inline CONTAINER_UNUSED_ void name##_cleanup(struct name *c) {   \
+        if (c == NULL) return;                                              \
+        free(c->data);                                                      \
+        free(c);                                                            \
+    }                                                                       \
+                                                                            \
+    static inline CONTAINER_UNUSED_ void name##_stats(                      \
+        const struct name *c) {                                             \
+        if (c == NULL) return;                                              \
+        fprintf(stderr, "stats %zu %zu %zu\n", c->pushes, c->pops, c->max); \
+    }                                                                       \
+                                                                            \
+    /* Position in the buffer of the element 'i' places after the first,    \
+     * without a division. */                                               \
+    static inline CONTAINER_UNUSED_ size_t name##_slot(                     \
+        const struct name *c, size_t i) {                                   \
+        size_t slot = c->first + i;                                         \
+        return slot >= c->capacity ? slot - c->capacity : slot;             \
+    }                                                                       \
+                                                                            \
+    /* Double the capacity of a full container and unwrap the ring, so      \
+     * the first element is at the start of the new buffer. */              \
+    static inline CONTAINER_UNUSED_ int name##_grow(struct name *c) {       \
+        size_t capacity = c->capacity * 2;                                  \
+        type *data = malloc(sizeof(type) * capacity);                       \
+        if (data == NULL) return 1;                                         \
+        for (size_t i = 0; i < c->length; i++) {                            \
+            data[i] = c->data[name##_slot(c, i)];                           \
+        }                                                                   \
+        free(c->data);                                                      \
+        c->data = data;                                                     \
+        c->first = 0;                                                       \
+        c->capacity = capacity;                                             \
+        return 0;                                                           \
+    }                                                                       \
+                                                                            \
+    /* Count a push and track the largest number of stored elements. */     \
+    static inline CONTAINER_UNUSED_ void name##_count_push(                 \
+        struct name *c) {                                                   \
+        c->length++;                                                        \
+        c->pushes++;                                                        \
+        if (c->length > c->max) c->max = c->length;                         \
+    }                                                                       \
+                                                                            \
+    static inline CONTAINER_UNUSED_ int name##_empty(                       \
+        const struct name *c) {                                             \
+        if (c == NULL) return -1;                                           \
+        return c->length == 0 ? 1 : 0;                                      \
+    }                                                                       \
+                                                                            \
+    static inline CONTAINER_UNUSED_ void name##_clear(struct name *c) {     \
+        if (c == NULL) return;                                              \
+        c->first = 0;                                                       \
+        c->length = 0;                                                      \
+    }                                                                       \
+                                                                            \
+    static inline CONTAINER_UNUSED_ size_t name##_size(                     \
+        const struct name *c) {                                             \
+        if (c == NULL) return 0;                                            \
+        return c->length;                                                   \
+    }
+
+/* Push to the back of the ring. */
+#define CONTAINER_PUSH_BACK_(name, type, fn)                                \
+    static inline CONTAINER_UNUSED_ int fn(struct name *c, type e) {        \
+        if (c == NULL) return 1;                                            \
+        if (c->length == c->capacity && name##_grow(c) != 0) return 1;      \
+        c->data[name##_slot(c, c->length)] = e;                             \
+        name##_count_push(c);                                               \
+        return 0;                                                           \
+    }
+
+/* Pop from the back of the ring. */
+#define CONTAINER_POP_BACK_(name, type, fn)                                 \
+    static inline CONTAINER_UNUSED_ int fn(struct name *c, type *e) {       \
+        if (c == NULL || c->length == 0) return 1;                          \
+        c->length--;                                                        \
+        c->pops++;                                                          \
+        *e = c->data[name##_slot(c, c->length)];                            \
+        return 0;                                                           \
+    }
+
+/* Pop from the front of the ring. */
+#define CONTAINER_POP_FRONT_(name, type, fn)                                \
+    static inline CONTAINER_UNUSED_ int fn(struct name *c, type *e) {       \
+        if (c == NULL || c->length == 0) return 1;                          \
+        *e = c->data[c->first];                                             \
+        c->first = name##_slot(c, 1);                                       \
+        c->length--;                                                        \
+        c->pops++;                                                          \
+        return 0;                                                           \
+    }
+
+/* Read the element at the front or the back of the ring. */
+#define CONTAINER_PEEK_FRONT_(name, type, fn)                               \
+    static inline CONTAINER_UNUSED_ int fn(const struct name *c, type *e) { \
+        if (c == NULL || c->length == 0) return 1;                          \
+        *e = c->data[c->first];                                             \
+        return 0;                                                           \
+    }
+
+#define CONTAINER_PEEK_BACK_(name, type, fn)                                \
+    static inline CONTAINER_UNUSED_ int fn(const struct name *c, type *e) { \
+        if (c == NULL || c->length == 0) return 1;                          \
+        *e = c->data[name##_slot(c, c->length - 1)];                        \
+        return 0;                                                           \
+    }
+
+#define DEFINE_STACK(name, type)                                            \
+    CONTAINER_COMMON_(name, type)                                           \
+    CONTAINER_PUSH_BACK_(name, type, name##_push)                           \
+    CONTAINER_POP_BACK_(name, type, name##_pop)                             \
+    CONTAINER_PEEK_BACK_(name, type, name##_peek)
+
+#define DEFINE_QUEUE(name, type)                                            \
+    CONTAINER_COMMON_(name, type)                                           \
+    CONTAINER_PUSH_BACK_(name, type, name##_push)                           \
+    CONTAINER_POP_FRONT_(name, type, name##_pop)                            \
+    CONTAINER_PEEK_FRONT_(name, type, name##_peek)
+
+#define DEFINE_DEQUE(name, type)                                            \
+    CONTAINER_COMMON_(name, type)                                           \
+    CONTAINER_PUSH_BACK_(name, type, name##_push_back)                      \
+    CONTAINER_POP_BACK_(name, type, name##_pop_back)                        \
+    CONTAINER_POP_FRONT_(name, type, name##_pop_front)                      \
+    CONTAINER_PEEK_FRONT_(name, type, name##_peek_front)                    \
+    CONTAINER_PEEK_BACK_(name, type, name##_peek_back)                      \
+                                                                            \
+    static inline CONTAINER_UNUSED_ int name##_push_front(struct name *c,   \
+                                                          type e) {         \
+        if (c == NULL) return 1;                                            \
+        if (c->length == c->capacity && name##_grow(c) != 0) return 1;      \
+        c->first = name##_slot(c, c->capacity - 1);                         \
+        c->data[c->first] = e;                                              \
+        name##_count_push(c);                                               \
+        return 0;                                                           \
+    }
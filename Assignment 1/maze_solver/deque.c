@@ -0,0 +1,250 @@
+/*H**********************************************************************
+* FILENAME: deque.c
+*
+* DESCRIPTION:
+*   Double-ended queue datastructure.
+*
+* PUBLIC FUNCTIONS:
+*   struct deque *deque_init( capacity )
+*   void deque_cleanup( d )
+*   void deque_stats( d )
+*   int deque_push_front( d, e )
+*   int deque_push_back( d, e )
+*   int64_t deque_pop_front( d )
+*   int64_t deque_pop_back( d )
+*   int64_t deque_peek_front( d )
+*   int deque_empty( d )
+*   void deque_clear( d )
+*   size_t deque_size( d )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "deque.h"
+
+/* The items are stored in a ring buffer: the first item is at 'first' and
+ * the following items wrap around to the start of 'data'. */
+struct deque {
+    int64_t *data;
+    size_t pushes;
+    size_t pops;
+    size_t max;
+    size_t first;
+    size_t length;
+    size_t capacity;
+};
+
+/**
+ * Reserve bytes in memory for deque and variables if possible.
+ *
+ * @param capacity the initial amount of integers savable in deque.
+ * @return
+ */
+struct deque *deque_init(size_t capacity) {
+    if (!capacity) capacity = 1;
+
+    struct deque *d = malloc(sizeof(struct deque));
+
+    if (d == NULL) return NULL;
+
+    d->data = malloc(sizeof(int64_t) * capacity);
+
+    if (d->data == NULL) {
+        free(d);
+
+        return NULL;
+    }
+
+    d->pushes = 0;
+    d->pops = 0;
+    d->max = 0;
+    d->first = 0;
+    d->length = 0;
+    d->capacity = capacity;
+
+    return d;
+}
+
+/**
+ * Free memory from deque and sub variables.
+ *
+ * @param d the deque.
+ */
+void deque_cleanup(struct deque *d) {
+    if (d == NULL) return;
+
+    free(d->data);
+    free(d);
+}
+
+/**
+ * Shows stats about the deque.
+ *
+ * @param d the deque.
+ */
+void deque_stats(const struct deque *d) {
+    if (d == NULL) return;
+
+    fprintf(stderr, "stats %zu %zu %zu\n", d->pushes, d->pops, d->max);
+}
+
+/**
+ * Double the capacity of a full deque and unwrap the ring buffer, so the
+ * first item is at the start of the new buffer. Return 0 if successful
+ * else 1.
+ *
+ * @param d the deque.
+ * @return
+ */
+static int deque_grow(struct deque *d) {
+    size_t capacity = d->capacity * 2;
+    int64_t *data = malloc(sizeof(int64_t) * capacity);
+
+    if (data == NULL) return 1;
+
+    for (size_t i = 0; i < d->length; i++) {
+        data[i] = d->data[(d->first + i) % d->capacity];
+    }
+
+    free(d->data);
+    d->data = data;
+    d->first = 0;
+    d->capacity = capacity;
+
+    return 0;
+}
+
+/**
+ * Count a push and track the largest number of stored items.
+ *
+ * @param d the deque.
+ */
+static void deque_count_push(struct deque *d) {
+    d->length++;
+    d->pushes++;
+
+    if (d->length > d->max) d->max = d->length;
+}
+
+/**
+ * Push one item to the front of the deque. Return 0 if successful else 1.
+ *
+ * @param d the deque.
+ * @param e the item pushed into the deque.
+ * @return
+ */
+int deque_push_front(struct deque *d, int64_t e) {
+    if (d == NULL) return 1;
+    if (d->length == d->capacity && deque_grow(d) != 0) return 1;
+
+    d->first = (d->first + d->capacity - 1) % d->capacity;
+    d->data[d->first] = e;
+    deque_count_push(d);
+
+    return 0;
+}
+
+/**
+ * Push one item to the back of the deque. Return 0 if successful else 1.
+ *
+ * @param d the deque.
+ * @param e the item pushed into the deque.
+ * @return
+ */
+int deque_push_back(struct deque *d, int64_t e) {
+    if (d == NULL) return 1;
+    if (d->length == d->capacity && deque_grow(d) != 0) return 1;
+
+    d->data[(d->first + d->length) % d->capacity] = e;
+    deque_count_push(d);
+
+    return 0;
+}
+
+/**
+ * Remove the first item from the deque. If empty return -1.
+ *
+ * @param d the deque.
+ * @return
+ */
+int64_t deque_pop_front(struct deque *d) {
+    if (d == NULL || d->length == 0) return -1;
+
+    int64_t e = d->data[d->first];
+
+    d->first = (d->first + 1) % d->capacity;
+    d->length--;
+    d->pops++;
+
+    return e;
+}
+
+/**
+ * Remove the last item from the deque. If empty return -1.
+ *
+ * @param d the deque.
+ * @return
+ */
+int64_t deque_pop_back(struct deque *d) {
+    if (d == NULL || d->length == 0) return -1;
+
+    d->length--;
+    d->pops++;
+
+    return d->data[(d->first + d->length) % d->capacity];
+}
+
+/**
+ * Get first item of deque. If empty return -1.
+ *
+ * @param d the deque.
+ * @return
+ */
+int64_t deque_peek_front(const struct deque *d) {
+    if (d == NULL || d->length == 0) return -1;
+
+    return d->data[d->first];
+}
+
+/**
+ * Check if deque is empty or not.
+ *
+ * @param d the deque.
+ * @return
+ */
+int deque_empty(const struct deque *d) {
+    if (d == NULL) return -1;
+
+    return d->length == 0 ? 1 : 0;
+}
+
+/**
+ * Empty the deque while keeping the reserved memory.
+ *
+ * @param d the deque.
+ */
+void deque_clear(struct deque *d) {
+    if (d == NULL) return;
+
+    d->first = 0;
+    d->length = 0;
+}
+
+/**
+ * Return the current length of the deque.
+ *
+ * @param d the deque.
+ * @return
+ */
+size_t deque_size(const struct deque *d) {
+    if (d == NULL) return 0;
+
+    return d->length;
+}
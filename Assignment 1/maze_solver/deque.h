@@ -0,0 +1,48 @@
+#include <stddef.h>
+#include <stdint.h>
+
+/* Handle to double-ended queue */
+struct deque;
+
+/* Return a pointer to a deque data structure with an initial capacity of
+ * 'capacity' if successful, otherwise return NULL. The deque grows when
+ * the capacity is reached. */
+struct deque *deque_init(size_t capacity);
+
+/* Cleanup deque. */
+void deque_cleanup(struct deque *d);
+
+/* Print deque statistics to stderr.
+ * The format is: 'stats' num_of_pushes num_of_pops max_elements */
+void deque_stats(const struct deque *d);
+
+/* Push item to the front of the deque.
+ * Return 0 if successful, 1 otherwise. */
+int deque_push_front(struct deque *d, int64_t e);
+
+/* Push item to the back of the deque.
+ * Return 0 if successful, 1 otherwise. */
+int deque_push_back(struct deque *d, int64_t e);
+
+/* Remove the first item from the deque and return it.
+ * Return the first item if successful, -1 otherwise. */
+int64_t deque_pop_front(struct deque *d);
+
+/* Remove the last item from the deque and return it.
+ * Return the last item if successful, -1 otherwise. */
+int64_t deque_pop_back(struct deque *d);
+
+/* Return the first item from the deque. Leave deque unchanged.
+ * Return the first item if successful, -1 otherwise. */
+int64_t deque_peek_front(const struct deque *d);
+
+/* Return 1 if deque is empty, 0 if the deque contains any elements and
+ * return -1 if the operation fails. */
+int deque_empty(const struct deque *d);
+
+/* Remove all items from the deque without releasing its memory, so the
+ * deque can be reused. The statistics are not reset. */
+void deque_clear(struct deque *d);
+
+/* Return the number of elements stored in the deque. */
+size_t deque_size(const struct deque *d);
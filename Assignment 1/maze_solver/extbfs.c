@@ -0,0 +1,447 @@
+/*H**********************************************************************
+* FILENAME: extbfs.c
+*
+* DESCRIPTION:
+*   External-memory breadth-first search on packed maze files.
+*
+* PUBLIC FUNCTIONS:
+*   int64_t ext_bfs( p, tmpdir, mem_limit, report )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+// Needed for mkstemp(), fdopen() and unlink()
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "extbfs.h"
+#include "pqueue.h"
+
+/* Number of runs merged at once, which bounds the number of open files. */
+#define FAN_IN 64
+
+/* Sequential reader of a sorted file of cell indices. */
+struct cursor {
+    FILE *fp;
+    int64_t value;
+    bool valid;
+};
+
+struct extbfs {
+    struct packed *p;
+    const char *tmpdir;
+    int64_t *buf;
+    size_t buf_capacity;
+    size_t buf_len;
+    FILE *runs[FAN_IN];
+    size_t n_runs;
+    struct pqueue *heads;
+    unsigned char *band[3];
+    int band_row;
+    int64_t finish;
+    bool found;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+};
+
+/**
+ * Create an anonymous temporary file, removed when it is closed.
+ *
+ * @param tmpdir the directory or NULL for the default directory.
+ * @return
+ */
+static FILE *temp_file(const char *tmpdir) {
+    if (tmpdir == NULL) return tmpfile();
+
+    size_t len = strlen(tmpdir) + sizeof("/extbfsXXXXXX");
+    char *name = malloc(len);
+
+    if (name == NULL) return NULL;
+
+    snprintf(name, len, "%s/extbfsXXXXXX", tmpdir);
+
+    int fd = mkstemp(name);
+    FILE *fp = NULL;
+
+    if (fd != -1) {
+        unlink(name);
+        fp = fdopen(fd, "w+b");
+
+        if (fp == NULL) close(fd);
+    }
+
+    free(name);
+
+    return fp;
+}
+
+/**
+ * Read the next cell of a cursor. Return 0 if successful else 1.
+ *
+ * @param e the search.
+ * @param c the cursor.
+ * @return
+ */
+static int cursor_next(struct extbfs *e, struct cursor *c) {
+    c->valid = fread(&c->value, sizeof(int64_t), 1, c->fp) == 1;
+
+    if (c->valid) {
+        e->bytes_read += sizeof(int64_t);
+    }
+
+    return ferror(c->fp) != 0;
+}
+
+/**
+ * Rewind file fp and read its first cell. Return 0 if successful else 1.
+ *
+ * @param e the search.
+ * @param c the cursor.
+ * @param fp the file.
+ * @return
+ */
+static int cursor_open(struct extbfs *e, struct cursor *c, FILE *fp) {
+    c->fp = fp;
+
+    if (fseek(fp, 0, SEEK_SET) != 0) return 1;
+
+    return cursor_next(e, c);
+}
+
+/**
+ * Skip the cells of a cursor smaller than value and return true if the
+ * cursor then stands at value.
+ *
+ * @param e the search.
+ * @param c the cursor.
+ * @param value the cell.
+ * @param error set to true if a read fails.
+ * @return
+ */
+static bool cursor_contains(struct extbfs *e, struct cursor *c, int64_t value,
+                            bool *error) {
+    while (c->valid && c->value < value) {
+        if (cursor_next(e, c) != 0) *error = true;
+    }
+
+    return c->valid && c->value == value;
+}
+
+/**
+ * Append a cell to a file. Return 0 if successful else 1.
+ *
+ * @param e the search.
+ * @param fp the file.
+ * @param value the cell.
+ * @return
+ */
+static int write_cell(struct extbfs *e, FILE *fp, int64_t value) {
+    if (fwrite(&value, sizeof(int64_t), 1, fp) != 1) return 1;
+
+    e->bytes_written += sizeof(int64_t);
+
+    return 0;
+}
+
+/**
+ * Merge all runs into file out and close them. Duplicates are written
+ * once, and cells found in the levels 'prev' and 'prev2' are dropped when
+ * those are not NULL; writing the destination then sets the found flag.
+ * Return 0 if successful else 1.
+ *
+ * @param e the search.
+ * @param out the output file.
+ * @param prev the current level or NULL.
+ * @param prev2 the previous level or NULL.
+ * @param count set to the number of cells written.
+ * @return
+ */
+static int merge_runs(struct extbfs *e, FILE *out, FILE *prev, FILE *prev2,
+                      int64_t *count) {
+    struct cursor heads[FAN_IN];
+    struct cursor old, older;
+    bool error = false;
+
+    *count = 0;
+    pqueue_clear(e->heads);
+
+    if (prev != NULL && (cursor_open(e, &old, prev) != 0
+                         || cursor_open(e, &older, prev2) != 0)) {
+        error = true;
+    }
+
+    for (size_t i = 0; i < e->n_runs && !error; i++) {
+        error = cursor_open(e, &heads[i], e->runs[i]) != 0
+                || (heads[i].valid
+                    && pqueue_push(e->heads, (int64_t) i, heads[i].value, 0));
+    }
+
+    int64_t last = -1;
+
+    while (!error && pqueue_size(e->heads) > 0) {
+        int64_t i = pqueue_pop(e->heads);
+        int64_t value = heads[i].value;
+
+        error = cursor_next(e, &heads[i]) != 0
+                || (heads[i].valid
+                    && pqueue_push(e->heads, i, heads[i].value, 0) != 0);
+
+        if (value == last) continue;
+
+        last = value;
+
+        if (prev != NULL && (cursor_contains(e, &old, value, &error)
+                             || cursor_contains(e, &older, value, &error))) {
+            continue;
+        }
+
+        if (write_cell(e, out, value) != 0) error = true;
+        if (prev != NULL && value == e->finish) e->found = true;
+
+        (*count)++;
+    }
+
+    for (size_t i = 0; i < e->n_runs; i++) fclose(e->runs[i]);
+
+    e->n_runs = 0;
+
+    return error || fflush(out) != 0;
+}
+
+/**
+ * Compare two cells for qsort().
+ *
+ * @return
+ */
+static int compare_cells(const void *a, const void *b) {
+    int64_t x = *(const int64_t *) a;
+    int64_t y = *(const int64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * Sort the buffer and write it as a new run. When all run slots are taken
+ * the runs are first merged into one. Return 0 if successful else 1.
+ *
+ * @param e the search.
+ * @return
+ */
+static int flush_buffer(struct extbfs *e) {
+    if (e->buf_len == 0) return 0;
+
+    if (e->n_runs == FAN_IN) {
+        FILE *merged = temp_file(e->tmpdir);
+        int64_t count;
+
+        if (merged == NULL) return 1;
+
+        if (merge_runs(e, merged, NULL, NULL, &count) != 0) {
+            fclose(merged);
+
+            return 1;
+        }
+
+        e->runs[e->n_runs++] = merged;
+    }
+
+    FILE *run = temp_file(e->tmpdir);
+
+    if (run == NULL) return 1;
+
+    e->runs[e->n_runs++] = run;
+
+    qsort(e->buf, e->buf_len, sizeof(int64_t), compare_cells);
+
+    for (size_t i = 0; i < e->buf_len; i++) {
+        if (i > 0 && e->buf[i] == e->buf[i - 1]) continue;
+        if (write_cell(e, run, e->buf[i]) != 0) return 1;
+    }
+
+    e->buf_len = 0;
+
+    return fflush(run) != 0;
+}
+
+/**
+ * Make the band hold the rows r - 1, r and r + 1. Rows are visited in
+ * increasing order, so usually only one new row is read.
+ * Return 0 if successful else 1.
+ *
+ * @param e the search.
+ * @param r the middle row.
+ * @return
+ */
+static int load_band(struct extbfs *e, int r) {
+    if (r == e->band_row) return 0;
+
+    if (e->band_row >= 0 && r == e->band_row + 1) {
+        unsigned char *oldest = e->band[0];
+
+        e->band[0] = e->band[1];
+        e->band[1] = e->band[2];
+        e->band[2] = oldest;
+        e->band_row = r;
+
+        return packed_read_row(e->p, r + 1, e->band[2]);
+    }
+
+    e->band_row = r;
+
+    for (int i = 0; i < 3; i++) {
+        if (packed_read_row(e->p, r - 1 + i, e->band[i]) != 0) return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Collect the open neighbours of every cell of a level into sorted runs.
+ * Return 0 if successful else 1.
+ *
+ * @param e the search.
+ * @param level the level file.
+ * @return
+ */
+static int expand_level(struct extbfs *e, FILE *level) {
+    int width = packed_width(e->p);
+    int height = packed_height(e->p);
+    struct cursor c;
+
+    if (cursor_open(e, &c, level) != 0) return 1;
+
+    e->band_row = -1;
+
+    while (c.valid) {
+        int r = (int) (c.value / width);
+        int col = (int) (c.value % width);
+
+        if (load_band(e, r) != 0) return 1;
+
+        for (int d = 0; d < N_MOVES; d++) {
+            int nr = r + m_offsets[d][0];
+            int nc = col + m_offsets[d][1];
+
+            if (nr <= 0 || nr >= height - 1 || nc <= 0 || nc >= width - 1) {
+                continue;
+            }
+
+            if (!packed_open_cell(e->band[1 + m_offsets[d][0]], nc)) continue;
+
+            e->buf[e->buf_len++] = (int64_t) nr * width + nc;
+
+            if (e->buf_len == e->buf_capacity && flush_buffer(e) != 0) {
+                return 1;
+            }
+        }
+
+        if (cursor_next(e, &c) != 0) return 1;
+    }
+
+    return flush_buffer(e);
+}
+
+/**
+ * Free the buffers of the search and close its runs.
+ *
+ * @param e the search.
+ */
+static void cleanup(struct extbfs *e) {
+    for (size_t i = 0; i < e->n_runs; i++) fclose(e->runs[i]);
+    for (int i = 0; i < 3; i++) free(e->band[i]);
+
+    free(e->buf);
+    pqueue_cleanup(e->heads);
+}
+
+/**
+ * Search level by level until the destination is reached or a level is
+ * empty.
+ *
+ * @param p the packed maze.
+ * @param tmpdir the directory for temporary files or NULL.
+ * @param mem_limit the size of the neighbour buffer in bytes.
+ * @param report the file for the per level report or NULL.
+ * @return
+ */
+int64_t ext_bfs(struct packed *p, const char *tmpdir, size_t mem_limit,
+                FILE *report) {
+    if (p == NULL || mem_limit < EXTBFS_MIN_MEMORY) return ERROR;
+
+    int64_t start = packed_start(p);
+
+    if (start == packed_destination(p)) return 0;
+
+    struct extbfs e = { .p = p, .tmpdir = tmpdir, .n_runs = 0,
+                        .finish = packed_destination(p), .found = false,
+                        .bytes_read = 0, .bytes_written = 0 };
+
+    e.buf_capacity = mem_limit / sizeof(int64_t);
+    e.buf_len = 0;
+    e.buf = malloc(sizeof(int64_t) * e.buf_capacity);
+    e.heads = pqueue_init(FAN_IN);
+
+    for (int i = 0; i < 3; i++) e.band[i] = malloc(packed_row_bytes(p));
+
+    // Level -1 is empty, level 0 only holds the start.
+    FILE *prev2 = temp_file(tmpdir);
+    FILE *prev = temp_file(tmpdir);
+    int64_t result = ERROR;
+
+    if (e.buf == NULL || e.heads == NULL || e.band[0] == NULL
+        || e.band[1] == NULL || e.band[2] == NULL || prev2 == NULL
+        || prev == NULL || write_cell(&e, prev, start) != 0) {
+        goto done;
+    }
+
+    for (int64_t level = 1;; level++) {
+        uint64_t read_before = e.bytes_read + packed_bytes_read(p);
+        uint64_t written_before = e.bytes_written;
+        FILE *next = temp_file(tmpdir);
+        int64_t count;
+
+        if (next == NULL || expand_level(&e, prev) != 0
+            || merge_runs(&e, next, prev, prev2, &count) != 0) {
+            if (next != NULL) fclose(next);
+
+            goto done;
+        }
+
+        fclose(prev2);
+        prev2 = prev;
+        prev = next;
+
+        if (report != NULL) {
+            fprintf(report, "io %" PRId64 " %" PRId64 " %" PRIu64 " %" PRIu64
+                    "\n", level, count,
+                    e.bytes_read + packed_bytes_read(p) - read_before,
+                    e.bytes_written - written_before);
+        }
+
+        if (e.found) {
+            result = level;
+            break;
+        }
+
+        if (count == 0) {
+            result = NOT_FOUND;
+            break;
+        }
+    }
+
+done:
+    if (prev2 != NULL) fclose(prev2);
+    if (prev != NULL) fclose(prev);
+
+    cleanup(&e);
+
+    return result;
+}
@@ -0,0 +1,26 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "packed.h"
+#include "solver.h"
+
+/* Smallest memory limit accepted by ext_bfs(), in bytes. */
+#define EXTBFS_MIN_MEMORY 64
+
+/* External-memory breadth-first search from the start to the destination
+ * of the packed maze 'p', for mazes larger than memory. Every BFS level is
+ * kept as a sorted file of cell indices. The next level is built by
+ * reading the current level in order together with a band of three maze
+ * rows, collecting the open neighbours in a buffer of 'mem_limit' bytes
+ * that is sorted and written as a run whenever it is full, and merging the
+ * runs while removing the cells of the current and previous level. Only
+ * the buffer, the band and one buffered block per open file are in
+ * memory. Temporary files are created in the directory 'tmpdir', or in
+ * the default temporary directory if it is NULL, and removed on return.
+ * If 'report' is not NULL one line is written to it per level in the
+ * format: 'io' level num_of_cells bytes_read bytes_written
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t ext_bfs(struct packed *p, const char *tmpdir, size_t mem_limit,
+                FILE *report);
@@ -0,0 +1,1070 @@
+/*H**********************************************************************
+* FILENAME: hpa.c
+*
+* DESCRIPTION:
+*   Hierarchical path planning (HPA*) on a cached cluster abstraction.
+*
+* PUBLIC FUNCTIONS:
+*   struct hpa *hpa_build( m, size )
+*   struct hpa *hpa_load( m, filename )
+*   int hpa_save( h, filename )
+*   void hpa_cleanup( h )
+*   int64_t hpa_query( h, start, finish )
+*   int hpa_mark_path( h, m )
+*   void hpa_stats( h )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hpa.h"
+#include "pqueue.h"
+
+/* Openings between two clusters of at least this many cells get an
+ * entrance at both ends, smaller ones a single entrance in the middle. */
+#define WIDE_OPENING 6
+
+/* First bytes of a saved abstraction. */
+#define MAGIC "HPA1"
+
+/* Parameters of the FNV-1a hash. */
+#define FNV_OFFSET UINT64_C(14695981039346656037)
+#define FNV_PRIME UINT64_C(1099511628211)
+
+/* A pair of integers: two cells of an entrance while building, or the
+ * cluster and cell of an entrance when sorting them. */
+struct pair {
+    int64_t a;
+    int64_t b;
+};
+
+/* Growable array of pairs. */
+struct pairs {
+    struct pair *data;
+    size_t size;
+    size_t capacity;
+};
+
+struct edge {
+    int64_t target;
+    int64_t cost;
+};
+
+/* Growable array of edges. */
+struct edges {
+    struct edge *data;
+    size_t size;
+    size_t capacity;
+};
+
+/* The entrances are the nodes of the abstract graph, sorted by cluster, so
+ * the entrances of cluster c are the nodes in [cluster_first[c],
+ * cluster_first[c + 1]). The edges of node u are in [edge_first[u],
+ * edge_first[u + 1]). Queries add two nodes, n_nodes for the start and
+ * n_nodes + 1 for the destination. */
+struct hpa {
+    const struct maze *m;
+    int size;
+    int cluster_rows;
+    int cluster_cols;
+    uint64_t hash;
+    int64_t n_nodes;
+    int64_t n_edges;
+    int64_t *cells;
+    int64_t *cluster_first;
+    int64_t *edge_first;
+    struct edge *edges;
+    int64_t max_cluster_nodes;
+
+    /* Scratch space of a query. */
+    int64_t *local_dist;
+    int64_t *local_prev;
+    int64_t *local_queue;
+    int64_t *finish_dist;
+    int64_t *g;
+    int64_t *prev;
+    uint32_t *epoch;
+    uint32_t current;
+    struct pqueue *open;
+    int64_t start;
+    int64_t finish;
+    bool found;
+    size_t expansions;
+};
+
+/* Cells of a cluster: rows [r0, r1) and columns [c0, c1). */
+struct box {
+    int r0;
+    int c0;
+    int r1;
+    int c1;
+};
+
+/**
+ * Append a pair to the array. Return 0 if successful else 1.
+ *
+ * @param p the array.
+ * @param a the first integer.
+ * @param b the second integer.
+ * @return
+ */
+static int pairs_push(struct pairs *p, int64_t a, int64_t b) {
+    if (p->size == p->capacity) {
+        size_t capacity = p->capacity ? p->capacity * 2 : 64;
+        struct pair *data = realloc(p->data, sizeof(struct pair) * capacity);
+
+        if (data == NULL) return 1;
+
+        p->data = data;
+        p->capacity = capacity;
+    }
+
+    p->data[p->size].a = a;
+    p->data[p->size].b = b;
+    p->size++;
+
+    return 0;
+}
+
+/**
+ * Append an edge to the array. Return 0 if successful else 1.
+ *
+ * @param e the array.
+ * @param target the node the edge leads to.
+ * @param cost the number of moves.
+ * @return
+ */
+static int edges_push(struct edges *e, int64_t target, int64_t cost) {
+    if (e->size == e->capacity) {
+        size_t capacity = e->capacity ? e->capacity * 2 : 64;
+        struct edge *data = realloc(e->data, sizeof(struct edge) * capacity);
+
+        if (data == NULL) return 1;
+
+        e->data = data;
+        e->capacity = capacity;
+    }
+
+    e->data[e->size].target = target;
+    e->data[e->size].cost = cost;
+    e->size++;
+
+    return 0;
+}
+
+/**
+ * Compare two pairs, first on a and then on b, for qsort.
+ *
+ * @return
+ */
+static int pair_compare(const void *x, const void *y) {
+    const struct pair *p = x;
+    const struct pair *q = y;
+
+    if (p->a != q->a) return p->a < q->a ? -1 : 1;
+    if (p->b != q->b) return p->b < q->b ? -1 : 1;
+
+    return 0;
+}
+
+/**
+ * Return true if (r, c) can be walked on.
+ *
+ * @param m the maze.
+ * @param r the row.
+ * @param c the column.
+ * @return
+ */
+static bool is_open(const struct maze *m, int r, int c) {
+    return maze_valid_move(m, r, c) && maze_get(m, r, c) != WALL;
+}
+
+/**
+ * Get the cluster of a cell.
+ *
+ * @param h the planner.
+ * @param cell the cell index.
+ * @return
+ */
+static int64_t cluster_of(const struct hpa *h, int64_t cell) {
+    int row = maze_row(h->m, cell) / h->size;
+    int col = maze_col(h->m, cell) / h->size;
+
+    return (int64_t) row * h->cluster_cols + col;
+}
+
+/**
+ * Get the cells of a cluster.
+ *
+ * @param h the planner.
+ * @param cluster the cluster.
+ * @return
+ */
+static struct box cluster_box(const struct hpa *h, int64_t cluster) {
+    struct box b;
+
+    b.r0 = (int) (cluster / h->cluster_cols) * h->size;
+    b.c0 = (int) (cluster % h->cluster_cols) * h->size;
+    b.r1 = b.r0 + h->size < maze_height(h->m) ? b.r0 + h->size
+                                              : maze_height(h->m);
+    b.c1 = b.c0 + h->size < maze_width(h->m) ? b.c0 + h->size
+                                             : maze_width(h->m);
+
+    return b;
+}
+
+/**
+ * Get the index of a cell inside the box of its cluster.
+ *
+ * @param h the planner.
+ * @param b the box.
+ * @param cell the cell index.
+ * @return
+ */
+static int64_t local_index(const struct hpa *h, const struct box *b,
+                           int64_t cell) {
+    int64_t row = maze_row(h->m, cell) - b->r0;
+    int64_t col = maze_col(h->m, cell) - b->c0;
+
+    return row * (b->c1 - b->c0) + col;
+}
+
+/**
+ * Breadth-first search from cell 'from' that stays inside a cluster. The
+ * distances and predecessors are stored per local index in local_dist
+ * and local_prev, -1 for cells that are not reached. Stops early when
+ * cell 'to' is reached, unless 'to' is negative.
+ *
+ * @param h the planner.
+ * @param cluster the cluster.
+ * @param from the cell to start from.
+ * @param to the cell to stop at.
+ */
+static void local_bfs(struct hpa *h, int64_t cluster, int64_t from,
+                      int64_t to) {
+    struct box b = cluster_box(h, cluster);
+    int64_t width = b.c1 - b.c0;
+    int64_t cells = (b.r1 - b.r0) * width;
+    int64_t target = to < 0 ? -1 : local_index(h, &b, to);
+
+    for (int64_t i = 0; i < cells; i++) h->local_dist[i] = -1;
+
+    size_t head = 0;
+    size_t tail = 0;
+    int64_t first = local_index(h, &b, from);
+
+    h->local_dist[first] = 0;
+    h->local_queue[tail++] = first;
+
+    while (head < tail) {
+        int64_t current = h->local_queue[head++];
+
+        if (current == target) return;
+
+        int row = b.r0 + (int) (current / width);
+        int col = b.c0 + (int) (current % width);
+
+        for (int d = 0; d < N_MOVES; d++) {
+            int new_row = row + m_offsets[d][0];
+            int new_col = col + m_offsets[d][1];
+
+            if (new_row < b.r0 || new_row >= b.r1 || new_col < b.c0
+                || new_col >= b.c1 || !is_open(h->m, new_row, new_col)) {
+                continue;
+            }
+
+            int64_t next = (new_row - b.r0) * width + (new_col - b.c0);
+
+            if (h->local_dist[next] >= 0) continue;
+
+            h->local_dist[next] = h->local_dist[current] + 1;
+            h->local_prev[next] = current;
+            h->local_queue[tail++] = next;
+        }
+    }
+}
+
+/**
+ * Add the entrances of an opening of 'length' cell pairs, starting with
+ * the pair (a, b). Successive pairs are 'step' indices apart. Return 0 if
+ * successful else 1.
+ *
+ * @param e the entrances.
+ * @param a the first cell on one side.
+ * @param b the first cell on the other side.
+ * @param step index distance between successive cells.
+ * @param length number of cell pairs.
+ * @return
+ */
+static int add_opening(struct pairs *e, int64_t a, int64_t b, int64_t step,
+                       int64_t length) {
+    if (length >= WIDE_OPENING) {
+        int64_t last = step * (length - 1);
+
+        return pairs_push(e, a, b) || pairs_push(e, a + last, b + last);
+    }
+
+    int64_t middle = step * ((length - 1) / 2);
+
+    return pairs_push(e, a + middle, b + middle);
+}
+
+/**
+ * Find the openings on the borders between clusters and add their
+ * entrances as pairs of cells on both sides of the border. Openings end at
+ * the corners of clusters, so every entrance connects two clusters.
+ * Return 0 if successful else 1.
+ *
+ * @param h the planner.
+ * @param e the entrances.
+ * @return
+ */
+static int find_entrances(const struct hpa *h, struct pairs *e) {
+    const struct maze *m = h->m;
+    int width = maze_width(m);
+    int height = maze_height(m);
+
+    // Borders between two columns of clusters.
+    for (int j = 1; j < h->cluster_cols; j++) {
+        int c = j * h->size - 1;
+        int64_t length = 0;
+
+        for (int r = 0; r <= height; r++) {
+            bool open = r < height && r % h->size != 0 && is_open(m, r, c)
+                        && is_open(m, r, c + 1);
+
+            if (open) {
+                length++;
+                continue;
+            }
+
+            if (length > 0) {
+                int first = r - (int) length;
+
+                if (add_opening(e, maze_index(m, first, c),
+                                maze_index(m, first, c + 1), width,
+                                length) != 0) {
+                    return 1;
+                }
+            }
+
+            // The first row of a cluster ends an opening, but may start
+            // a new one.
+            length = r < height && is_open(m, r, c) && is_open(m, r, c + 1);
+        }
+    }
+
+    // Borders between two rows of clusters.
+    for (int i = 1; i < h->cluster_rows; i++) {
+        int r = i * h->size - 1;
+        int64_t length = 0;
+
+        for (int c = 0; c <= width; c++) {
+            bool open = c < width && c % h->size != 0 && is_open(m, r, c)
+                        && is_open(m, r + 1, c);
+
+            if (open) {
+                length++;
+                continue;
+            }
+
+            if (length > 0) {
+                int first = c - (int) length;
+
+                if (add_opening(e, maze_index(m, r, first),
+                                maze_index(m, r + 1, first), 1,
+                                length) != 0) {
+                    return 1;
+                }
+            }
+
+            length = c < width && is_open(m, r, c) && is_open(m, r + 1, c);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Get the node of an entrance cell, or -1 if the cell is no entrance.
+ *
+ * @param h the planner.
+ * @param cell the cell index.
+ * @return
+ */
+static int64_t find_node(const struct hpa *h, int64_t cell) {
+    int64_t cluster = cluster_of(h, cell);
+    int64_t low = h->cluster_first[cluster];
+    int64_t high = h->cluster_first[cluster + 1];
+
+    // The entrances of a cluster are sorted by cell index.
+    while (low < high) {
+        int64_t middle = low + (high - low) / 2;
+
+        if (h->cells[middle] < cell) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low < h->cluster_first[cluster + 1] && h->cells[low] == cell ? low
+                                                                        : -1;
+}
+
+/**
+ * Hash of the size and the walls of a maze, used to check that a saved
+ * abstraction belongs to the maze (FNV-1a).
+ *
+ * @param m the maze.
+ * @return
+ */
+static uint64_t maze_hash(const struct maze *m) {
+    uint64_t hash = FNV_OFFSET;
+
+    hash = (hash ^ (uint64_t) maze_width(m)) * FNV_PRIME;
+    hash = (hash ^ (uint64_t) maze_height(m)) * FNV_PRIME;
+
+    for (int r = 0; r < maze_height(m); r++) {
+        for (int c = 0; c < maze_width(m); c++) {
+            uint64_t wall = maze_get(m, r, c) == WALL;
+
+            hash = (hash ^ wall) * FNV_PRIME;
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * Reserve an empty planner for maze m.
+ *
+ * @param m the maze.
+ * @param size the cluster size.
+ * @return
+ */
+static struct hpa *hpa_init(const struct maze *m, int size) {
+    struct hpa *h = calloc(1, sizeof(struct hpa));
+
+    if (h == NULL) return NULL;
+
+    h->m = m;
+    h->size = size;
+    h->cluster_rows = (maze_height(m) + size - 1) / size;
+    h->cluster_cols = (maze_width(m) + size - 1) / size;
+
+    return h;
+}
+
+/**
+ * Reserve the scratch space for queries once the abstract graph is known.
+ * Return 0 if successful else 1.
+ *
+ * @param h the planner.
+ * @return
+ */
+static int alloc_scratch(struct hpa *h) {
+    size_t local = (size_t) h->size * (size_t) h->size;
+    size_t nodes = (size_t) h->n_nodes + 2;
+    int64_t clusters = (int64_t) h->cluster_rows * h->cluster_cols;
+
+    h->max_cluster_nodes = 1;
+
+    for (int64_t c = 0; c < clusters; c++) {
+        int64_t n = h->cluster_first[c + 1] - h->cluster_first[c];
+
+        if (n > h->max_cluster_nodes) h->max_cluster_nodes = n;
+    }
+
+    // A planner that was just built already has the local buffers.
+    if (h->local_dist == NULL) {
+        h->local_dist = malloc(sizeof(int64_t) * local);
+        h->local_prev = malloc(sizeof(int64_t) * local);
+        h->local_queue = malloc(sizeof(int64_t) * local);
+    }
+
+    h->finish_dist = malloc(sizeof(int64_t)
+                            * (size_t) h->max_cluster_nodes);
+    h->g = malloc(sizeof(int64_t) * nodes);
+    h->prev = malloc(sizeof(int64_t) * nodes);
+    h->epoch = calloc(nodes, sizeof(uint32_t));
+    h->open = pqueue_init(nodes);
+
+    return h->local_dist == NULL || h->local_prev == NULL
+           || h->local_queue == NULL || h->finish_dist == NULL
+           || h->g == NULL || h->prev == NULL || h->epoch == NULL
+           || h->open == NULL;
+}
+
+/**
+ * Turn the entrances into the sorted nodes of the abstract graph. Return
+ * 0 if successful else 1.
+ *
+ * @param h the planner.
+ * @param e the entrances.
+ * @return
+ */
+static int build_nodes(struct hpa *h, const struct pairs *e) {
+    struct pairs keys = { NULL, 0, 0 };
+    int64_t clusters = (int64_t) h->cluster_rows * h->cluster_cols;
+
+    for (size_t i = 0; i < e->size; i++) {
+        if (pairs_push(&keys, cluster_of(h, e->data[i].a), e->data[i].a) != 0
+            || pairs_push(&keys, cluster_of(h, e->data[i].b),
+                          e->data[i].b) != 0) {
+            free(keys.data);
+
+            return 1;
+        }
+    }
+
+    qsort(keys.data, keys.size, sizeof(struct pair), pair_compare);
+
+    h->cells = malloc(sizeof(int64_t) * (keys.size ? keys.size : 1));
+    h->cluster_first = calloc((size_t) clusters + 1, sizeof(int64_t));
+
+    if (h->cells == NULL || h->cluster_first == NULL) {
+        free(keys.data);
+
+        return 1;
+    }
+
+    // A cell at the corner of a cluster can be an entrance twice.
+    h->n_nodes = 0;
+
+    for (size_t i = 0; i < keys.size; i++) {
+        if (i > 0 && keys.data[i].b == keys.data[i - 1].b) continue;
+
+        h->cells[h->n_nodes++] = keys.data[i].b;
+        h->cluster_first[keys.data[i].a + 1]++;
+    }
+
+    for (int64_t c = 0; c < clusters; c++) {
+        h->cluster_first[c + 1] += h->cluster_first[c];
+    }
+
+    free(keys.data);
+
+    return 0;
+}
+
+/**
+ * Connect the nodes: within a cluster by their distance inside the
+ * cluster, and across a border by one move. Return 0 if successful else 1.
+ *
+ * @param h the planner.
+ * @param e the entrances.
+ * @return
+ */
+static int build_edges(struct hpa *h, const struct pairs *e) {
+    struct pairs borders = { NULL, 0, 0 };
+    struct edges edges = { NULL, 0, 0 };
+
+    for (size_t i = 0; i < e->size; i++) {
+        int64_t u = find_node(h, e->data[i].a);
+        int64_t v = find_node(h, e->data[i].b);
+
+        if (pairs_push(&borders, u, v) != 0
+            || pairs_push(&borders, v, u) != 0) {
+            free(borders.data);
+
+            return 1;
+        }
+    }
+
+    qsort(borders.data, borders.size, sizeof(struct pair), pair_compare);
+
+    h->edge_first = malloc(sizeof(int64_t) * ((size_t) h->n_nodes + 1));
+
+    if (h->edge_first == NULL) {
+        free(borders.data);
+
+        return 1;
+    }
+
+    size_t k = 0;
+
+    for (int64_t u = 0; u < h->n_nodes; u++) {
+        int64_t cluster = cluster_of(h, h->cells[u]);
+        struct box b = cluster_box(h, cluster);
+
+        h->edge_first[u] = (int64_t) edges.size;
+        local_bfs(h, cluster, h->cells[u], -1);
+
+        for (int64_t v = h->cluster_first[cluster];
+             v < h->cluster_first[cluster + 1]; v++) {
+            int64_t dist = h->local_dist[local_index(h, &b, h->cells[v])];
+
+            if (v != u && dist >= 0 && edges_push(&edges, v, dist) != 0) {
+                free(borders.data);
+                free(edges.data);
+
+                return 1;
+            }
+        }
+
+        for (; k < borders.size && borders.data[k].a == u; k++) {
+            if (edges_push(&edges, borders.data[k].b, 1) != 0) {
+                free(borders.data);
+                free(edges.data);
+
+                return 1;
+            }
+        }
+    }
+
+    h->edge_first[h->n_nodes] = (int64_t) edges.size;
+    h->n_edges = (int64_t) edges.size;
+    h->edges = edges.data;
+    free(borders.data);
+
+    return 0;
+}
+
+/**
+ * Build the abstraction of maze m with clusters of size by size cells.
+ *
+ * @param m the maze.
+ * @param size the cluster size.
+ * @return
+ */
+struct hpa *hpa_build(const struct maze *m, int size) {
+    // Clusters are squares of one layer; layered mazes are not supported.
+    if (m == NULL || size < 2 || maze_layers(m) > 1) return NULL;
+
+    struct hpa *h = hpa_init(m, size);
+
+    if (h == NULL) return NULL;
+
+    struct pairs entrances = { NULL, 0, 0 };
+
+    // The local search buffers are needed to measure the edges.
+    h->local_dist = malloc(sizeof(int64_t) * (size_t) size * (size_t) size);
+    h->local_prev = malloc(sizeof(int64_t) * (size_t) size * (size_t) size);
+    h->local_queue = malloc(sizeof(int64_t) * (size_t) size * (size_t) size);
+
+    if (h->local_dist == NULL || h->local_prev == NULL
+        || h->local_queue == NULL || find_entrances(h, &entrances) != 0
+        || build_nodes(h, &entrances) != 0
+        || build_edges(h, &entrances) != 0) {
+        free(entrances.data);
+        hpa_cleanup(h);
+
+        return NULL;
+    }
+
+    free(entrances.data);
+    h->hash = maze_hash(m);
+
+    if (alloc_scratch(h) != 0) {
+        hpa_cleanup(h);
+
+        return NULL;
+    }
+
+    return h;
+}
+
+/**
+ * Write the abstraction to a file.
+ *
+ * @param h the planner.
+ * @param filename the name of the file.
+ * @return
+ */
+int hpa_save(const struct hpa *h, const char *filename) {
+    if (h == NULL || filename == NULL) return 1;
+
+    FILE *fp = fopen(filename, "wb");
+
+    if (fp == NULL) return 1;
+
+    int dims[3] = { maze_width(h->m), maze_height(h->m), h->size };
+    int64_t counts[2] = { h->n_nodes, h->n_edges };
+    size_t clusters = (size_t) h->cluster_rows * (size_t) h->cluster_cols;
+    size_t nodes = (size_t) h->n_nodes;
+    size_t edges = (size_t) h->n_edges;
+
+    bool error = fwrite(MAGIC, 1, 4, fp) != 4
+                 || fwrite(dims, sizeof(int), 3, fp) != 3
+                 || fwrite(&h->hash, sizeof(uint64_t), 1, fp) != 1
+                 || fwrite(counts, sizeof(int64_t), 2, fp) != 2
+                 || fwrite(h->cells, sizeof(int64_t), nodes, fp) != nodes
+                 || fwrite(h->cluster_first, sizeof(int64_t), clusters + 1,
+                           fp) != clusters + 1
+                 || fwrite(h->edge_first, sizeof(int64_t), nodes + 1,
+                           fp) != nodes + 1
+                 || fwrite(h->edges, sizeof(struct edge), edges, fp) != edges;
+
+    if (fclose(fp) != 0) error = true;
+
+    return error;
+}
+
+/**
+ * Check that the arrays read from a file describe a valid abstraction.
+ *
+ * @param h the planner.
+ * @return
+ */
+static bool valid_abstraction(const struct hpa *h) {
+    int64_t clusters = (int64_t) h->cluster_rows * h->cluster_cols;
+    int64_t cells = maze_cells(h->m);
+
+    if (h->cluster_first[0] != 0 || h->cluster_first[clusters] != h->n_nodes
+        || h->edge_first[0] != 0 || h->edge_first[h->n_nodes] != h->n_edges) {
+        return false;
+    }
+
+    for (int64_t c = 0; c < clusters; c++) {
+        if (h->cluster_first[c] > h->cluster_first[c + 1]) return false;
+    }
+
+    for (int64_t u = 0; u < h->n_nodes; u++) {
+        if (h->cells[u] < 0 || h->cells[u] >= cells
+            || h->edge_first[u] > h->edge_first[u + 1]) {
+            return false;
+        }
+    }
+
+    // find_node looks a cell up among the sorted entrances of its cluster.
+    for (int64_t c = 0; c < clusters; c++) {
+        for (int64_t u = h->cluster_first[c]; u < h->cluster_first[c + 1];
+             u++) {
+            if (cluster_of(h, h->cells[u]) != c) return false;
+
+            if (u > h->cluster_first[c] && h->cells[u - 1] >= h->cells[u]) {
+                return false;
+            }
+        }
+    }
+
+    for (int64_t i = 0; i < h->n_edges; i++) {
+        if (h->edges[i].target < 0 || h->edges[i].target >= h->n_nodes
+            || h->edges[i].cost < 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Read an abstraction of maze m from a file.
+ *
+ * @param m the maze.
+ * @param filename the name of the file.
+ * @return
+ */
+struct hpa *hpa_load(const struct maze *m, const char *filename) {
+    if (m == NULL || filename == NULL || maze_layers(m) > 1) return NULL;
+
+    FILE *fp = fopen(filename, "rb");
+
+    if (fp == NULL) return NULL;
+
+    char magic[4];
+    int dims[3];
+    uint64_t hash;
+    int64_t counts[2];
+
+    if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, MAGIC, 4) != 0
+        || fread(dims, sizeof(int), 3, fp) != 3
+        || fread(&hash, sizeof(uint64_t), 1, fp) != 1
+        || fread(counts, sizeof(int64_t), 2, fp) != 2
+        || dims[0] != maze_width(m) || dims[1] != maze_height(m)
+        || dims[2] < 2 || counts[0] < 0 || counts[1] < 0
+        || counts[0] > maze_cells(m) || hash != maze_hash(m)) {
+        fclose(fp);
+
+        return NULL;
+    }
+
+    struct hpa *h = hpa_init(m, dims[2]);
+
+    if (h == NULL) {
+        fclose(fp);
+
+        return NULL;
+    }
+
+    size_t clusters = (size_t) h->cluster_rows * (size_t) h->cluster_cols;
+    size_t nodes = (size_t) counts[0];
+    size_t edges = (size_t) counts[1];
+
+    h->hash = hash;
+    h->n_nodes = counts[0];
+    h->n_edges = counts[1];
+    h->cells = malloc(sizeof(int64_t) * (nodes ? nodes : 1));
+    h->cluster_first = malloc(sizeof(int64_t) * (clusters + 1));
+    h->edge_first = malloc(sizeof(int64_t) * (nodes + 1));
+    h->edges = malloc(sizeof(struct edge) * (edges ? edges : 1));
+
+    bool error = h->cells == NULL || h->cluster_first == NULL
+                 || h->edge_first == NULL || h->edges == NULL
+                 || fread(h->cells, sizeof(int64_t), nodes, fp) != nodes
+                 || fread(h->cluster_first, sizeof(int64_t), clusters + 1,
+                          fp) != clusters + 1
+                 || fread(h->edge_first, sizeof(int64_t), nodes + 1,
+                          fp) != nodes + 1
+                 || fread(h->edges, sizeof(struct edge), edges, fp) != edges;
+
+    fclose(fp);
+
+    if (error || !valid_abstraction(h) || alloc_scratch(h) != 0) {
+        hpa_cleanup(h);
+
+        return NULL;
+    }
+
+    return h;
+}
+
+/**
+ * Free memory from planner and sub variables.
+ *
+ * @param h the planner.
+ */
+void hpa_cleanup(struct hpa *h) {
+    if (h == NULL) return;
+
+    free(h->cells);
+    free(h->cluster_first);
+    free(h->edge_first);
+    free(h->edges);
+    free(h->local_dist);
+    free(h->local_prev);
+    free(h->local_queue);
+    free(h->finish_dist);
+    free(h->g);
+    free(h->prev);
+    free(h->epoch);
+    pqueue_cleanup(h->open);
+
+    free(h);
+}
+
+/**
+ * Manhattan distance from a node to the destination of the query.
+ *
+ * @param h the planner.
+ * @param node the node.
+ * @return
+ */
+static int64_t heuristic(const struct hpa *h, int64_t node) {
+    if (node >= h->n_nodes) return 0;
+
+    int64_t dr = maze_row(h->m, h->cells[node]) - maze_row(h->m, h->finish);
+    int64_t dc = maze_col(h->m, h->cells[node]) - maze_col(h->m, h->finish);
+
+    return (dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc);
+}
+
+/**
+ * Reach node v from node u with distance g, if that is shorter than any
+ * earlier distance of v. Return 0 if successful else 1.
+ *
+ * @param h the planner.
+ * @param v the node.
+ * @param u the previous node.
+ * @param g the distance of v through u.
+ * @return
+ */
+static int relax(struct hpa *h, int64_t v, int64_t u, int64_t g) {
+    if (h->epoch[v] == h->current && h->g[v] <= g) return 0;
+
+    h->epoch[v] = h->current;
+    h->g[v] = g;
+    h->prev[v] = u;
+
+    return pqueue_push(h->open, v, g + heuristic(h, v), g);
+}
+
+/**
+ * Plan a path from start to finish: connect both to the entrances of
+ * their cluster with a search inside the cluster and run A* on the
+ * abstract graph.
+ *
+ * @param h the planner.
+ * @param start index of the start location.
+ * @param finish index of the destination.
+ * @return
+ */
+int64_t hpa_query(struct hpa *h, int64_t start, int64_t finish) {
+    if (h == NULL) return ERROR;
+
+    int64_t cells = maze_cells(h->m);
+
+    if (start < 0 || finish < 0 || start >= cells || finish >= cells) {
+        return ERROR;
+    }
+
+    h->found = false;
+    h->expansions = 0;
+    h->start = start;
+    h->finish = finish;
+
+    const struct maze *m = h->m;
+
+    if (!is_open(m, maze_row(m, start), maze_col(m, start))
+        || !is_open(m, maze_row(m, finish), maze_col(m, finish))) {
+        return NOT_FOUND;
+    }
+
+    if (++h->current == 0) {
+        memset(h->epoch, 0, sizeof(uint32_t) * ((size_t) h->n_nodes + 2));
+        h->current = 1;
+    }
+
+    pqueue_clear(h->open);
+
+    int64_t source = h->n_nodes;
+    int64_t target = h->n_nodes + 1;
+    int64_t start_cluster = cluster_of(h, start);
+    int64_t finish_cluster = cluster_of(h, finish);
+    struct box sb = cluster_box(h, start_cluster);
+    struct box fb = cluster_box(h, finish_cluster);
+    int64_t first = h->cluster_first[finish_cluster];
+
+    // Distances inside its cluster from the destination to the entrances.
+    local_bfs(h, finish_cluster, finish, -1);
+
+    for (int64_t v = first; v < h->cluster_first[finish_cluster + 1]; v++) {
+        h->finish_dist[v - first] =
+            h->local_dist[local_index(h, &fb, h->cells[v])];
+    }
+
+    // Distances inside its cluster from the start to the entrances.
+    h->epoch[source] = h->current;
+    h->g[source] = 0;
+    local_bfs(h, start_cluster, start, -1);
+
+    for (int64_t v = h->cluster_first[start_cluster];
+         v < h->cluster_first[start_cluster + 1]; v++) {
+        int64_t dist = h->local_dist[local_index(h, &sb, h->cells[v])];
+
+        if (dist >= 0 && relax(h, v, source, dist) != 0) return ERROR;
+    }
+
+    if (start_cluster == finish_cluster) {
+        int64_t dist = h->local_dist[local_index(h, &sb, finish)];
+
+        if (dist >= 0 && relax(h, target, source, dist) != 0) return ERROR;
+    }
+
+    int64_t u;
+
+    while ((u = pqueue_pop(h->open)) >= 0) {
+        if (u == target) {
+            h->found = true;
+
+            return h->g[target];
+        }
+
+        h->expansions++;
+
+        for (int64_t i = h->edge_first[u]; i < h->edge_first[u + 1]; i++) {
+            if (relax(h, h->edges[i].target, u, h->g[u] + h->edges[i].cost)
+                != 0) {
+                return ERROR;
+            }
+        }
+
+        if (cluster_of(h, h->cells[u]) == finish_cluster
+            && h->finish_dist[u - first] >= 0
+            && relax(h, target, u, h->g[u] + h->finish_dist[u - first])
+                   != 0) {
+            return ERROR;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+/**
+ * Mark the cells of one leg of the route, from cell a to cell b, except
+ * the start and destination of the query.
+ *
+ * @param h the planner.
+ * @param m the maze.
+ * @param a the first cell of the leg.
+ * @param b the last cell of the leg.
+ * @return
+ */
+static int refine_leg(struct hpa *h, struct maze *m, int64_t a, int64_t b) {
+    int64_t cluster = cluster_of(h, a);
+
+    // Legs across a border are a single move.
+    if (cluster != cluster_of(h, b)) {
+        if (b != h->finish && b != h->start) {
+            maze_set(m, maze_row(m, b), maze_col(m, b), PATH);
+        }
+
+        return 0;
+    }
+
+    struct box box = cluster_box(h, cluster);
+    int64_t width = box.c1 - box.c0;
+    int64_t from = local_index(h, &box, a);
+    int64_t i = local_index(h, &box, b);
+
+    local_bfs(h, cluster, a, b);
+
+    if (h->local_dist[i] < 0) return 1;
+
+    for (; i != from; i = h->local_prev[i]) {
+        int row = box.r0 + (int) (i / width);
+        int col = box.c0 + (int) (i % width);
+        int64_t cell = maze_index(m, row, col);
+
+        if (cell != h->finish && cell != h->start) {
+            maze_set(m, row, col, PATH);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Refine the route of the last query leg by leg and mark it in the maze.
+ *
+ * @param h the planner.
+ * @param m the maze of the planner.
+ * @return
+ */
+int hpa_mark_path(struct hpa *h, struct maze *m) {
+    if (h == NULL || m != h->m || !h->found) return 1;
+
+    int64_t source = h->n_nodes;
+    int64_t target = h->n_nodes + 1;
+
+    for (int64_t v = target; v != source; v = h->prev[v]) {
+        int64_t u = h->prev[v];
+        int64_t a = u == source ? h->start : h->cells[u];
+        int64_t b = v == target ? h->finish : h->cells[v];
+
+        if (refine_leg(h, m, a, b) != 0) return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Shows stats about the abstraction and the last query.
+ *
+ * @param h the planner.
+ */
+void hpa_stats(const struct hpa *h) {
+    if (h == NULL) return;
+
+    fprintf(stderr, "stats %" PRId64 " %" PRId64 " %zu\n", h->n_nodes,
+            h->n_edges, h->expansions);
+}
@@ -0,0 +1,51 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "solver.h"
+
+/* Handle to a hierarchical planner (HPA*). The maze is split into square
+ * clusters. Cells on both sides of an opening between two clusters are
+ * entrances, and the distances between the entrances of a cluster are
+ * precomputed. A query only searches inside the clusters of its start and
+ * destination and on the abstract graph of entrances, so its cost depends
+ * on the number of clusters on the route instead of the number of cells.
+ * The reported paths are close to, but not always exactly, the shortest.
+ * Queries use scratch space in the planner, so a planner must not be
+ * shared between threads. */
+struct hpa;
+
+/* Return a pointer to a planner for maze 'm' with clusters of 'size' by
+ * 'size' cells if successful, otherwise return NULL. The planner uses the
+ * maze until it is cleaned up; the walls of the maze must not change.
+ * Mazes with more than one layer are not supported. */
+struct hpa *hpa_build(const struct maze *m, int size);
+
+/* Return a pointer to a planner for maze 'm' read from the file
+ * 'filename' written by hpa_save() if successful, otherwise return NULL.
+ * Fails if the file was saved for a maze with other dimensions or
+ * walls. */
+struct hpa *hpa_load(const struct maze *m, const char *filename);
+
+/* Writes the abstraction of the planner to the file 'filename', so later
+ * processes can load it instead of building it again. The file is only
+ * read back on machines with the same byte order.
+ * Returns 0 if successful, 1 otherwise. */
+int hpa_save(const struct hpa *h, const char *filename);
+
+/* Cleanup planner. The maze is not freed. */
+void hpa_cleanup(struct hpa *h);
+
+/* Plans a path from index 'start' to index 'finish'.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t hpa_query(struct hpa *h, int64_t start, int64_t finish);
+
+/* Refines the path of the last successful query and marks it in maze 'm',
+ * the maze of the planner, with PATH characters. Only the clusters on the
+ * route are searched.
+ * Returns 0 if successful, 1 otherwise. */
+int hpa_mark_path(struct hpa *h, struct maze *m);
+
+/* Print planner statistics to stderr.
+ * The format is: 'stats' num_of_entrances num_of_edges num_of_expansions */
+void hpa_stats(const struct hpa *h);
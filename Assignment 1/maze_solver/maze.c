@@ -4,7 +4,9 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,11 +16,20 @@
 #define START 'S'
 #define FINISH 'D'
 
+/* Number of rows reserved for wide mazes before the height is known. */
+#define INITIAL_ROWS 1024
+
 struct maze {
-    int n;
-    int start_index;
-    int finish_index;
+    int width;
+    int height;
+    int layers;
+    int64_t start_index;
+    int64_t finish_index;
+    int64_t *finishes;
+    size_t n_finishes;
+    size_t finishes_capacity;
     char *data;
+    uint8_t *masks;
 };
 
 /* Move offsets: (row, column) We can only move in four directions.
@@ -29,62 +40,228 @@ struct maze {
  */
 int m_offsets[N_MOVES][2] = { { -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 } };
 
-/* Creates a square maze structure of 'n' rows by 'n' columns filled with
+/* Creates a maze structure of 'height' rows by 'width' columns filled with
  * walls. maze_init() is not part of the maze interface, it is a helper
  * function for maze_read().
  * Returns a pointer to the initialized maze or NULL if an error occurred. */
-struct maze *maze_init(int n) {
-    if (n <= 0) {
+struct maze *maze_init(int width, int height) {
+    if (width <= 0 || height <= 0) {
         return NULL;
     }
     struct maze *m = malloc(sizeof(struct maze));
     if (!m) {
         return NULL;
     }
-    m->n = n;
-    m->data = calloc(1, (size_t)(m->n * m->n * (int) sizeof(char)));
+    m->width = width;
+    m->height = height;
+    m->layers = 1;
+    m->finishes = NULL;
+    m->n_finishes = 0;
+    m->finishes_capacity = 0;
+    m->masks = NULL;
+    size_t cells = (size_t) width * (size_t) height;
+    m->data = malloc(cells);
     if (!m->data) {
         free(m);
         return NULL;
     }
-    memset(m->data, WALL, (size_t)(m->n * m->n));
+    memset(m->data, WALL, cells);
 
     // And finally set the default start and finish locations.
     m->start_index = maze_index(m, 1, 1); // upper left
-    m->finish_index = maze_index(m, maze_size(m) - 2,
-                                 maze_size(m) - 2); // lower right
+    m->finish_index = maze_index(m, m->height - 2,
+                                 m->width - 2); // lower right
     return m;
 }
 
+/* Grows maze 'm' to 'height' rows. The new rows are filled with walls.
+ * Returns 0 if successful, 1 otherwise. */
+static int maze_grow(struct maze *m, int height) {
+    size_t old_cells = (size_t) m->width * (size_t) m->height;
+    size_t cells = (size_t) m->width * (size_t) height;
+    char *data = realloc(m->data, cells);
+    if (!data) {
+        return 1;
+    }
+    memset(data + old_cells, WALL, cells - old_cells);
+    m->data = data;
+    m->height = height;
+    return 0;
+}
+
 void maze_cleanup(struct maze *m) {
+    free(m->masks);
+    free(m->finishes);
     free(m->data);
     free(m);
 }
 
 char maze_get(const struct maze *m, int r, int c) {
-    assert(r >= 0 && r < m->n && c >= 0 && c < m->n);
-    return m->data[r * m->n + c];
+    assert(r >= 0 && r < m->height && c >= 0 && c < m->width);
+    return m->data[maze_index(m, r, c)];
+}
+
+char maze_get_index(const struct maze *m, int64_t index) {
+    assert(index >= 0 && index < maze_cells(m));
+    return m->data[index];
+}
+
+/* Computes the open-neighbour mask of the cell at 'index' from the maze
+ * characters. */
+static uint8_t cell_mask(const struct maze *m, int64_t index) {
+    uint8_t mask = 0;
+    for (int d = 0; d < N_MOVES_3D; d++) {
+        int64_t n = maze_neighbour(m, index, d);
+        if (n >= 0 && m->data[n] != WALL) {
+            mask |= (uint8_t) (1u << d);
+        }
+    }
+    return mask;
 }
 
 void maze_set(struct maze *m, int r, int c, char value) {
-    assert(r >= 0 && r < m->n && c >= 0 && c < m->n);
-    m->data[r * m->n + c] = value;
+    assert(r >= 0 && r < m->height && c >= 0 && c < m->width);
+    maze_set_index(m, maze_index(m, r, c), value);
 }
 
-void maze_print(const struct maze *m, bool blocks) {
-    for (int r = 0; r < m->n; r++) {
-        for (int c = 0; c < m->n; c++) {
-            if (blocks && maze_get(m, r, c) == WALL) {
-                printf("\u2588");
-            } else if (maze_at_start(m, r, c)) {
-                putchar(START);
-            } else if (maze_at_destination(m, r, c)) {
-                putchar(FINISH);
-            } else {
-                putchar(maze_get(m, r, c));
+void maze_set_index(struct maze *m, int64_t index, char value) {
+    assert(index >= 0 && index < maze_cells(m));
+    bool toggled = (m->data[index] == WALL) != (value == WALL);
+    m->data[index] = value;
+
+    // Opening or closing a cell changes the masks of its neighbours.
+    if (m->masks != NULL && toggled) {
+        for (int d = 0; d < N_MOVES_3D; d++) {
+            int64_t n = d < N_MOVES ? maze_neighbour(m, index, d)
+                                    : index + maze_step(m, d);
+            if (n >= 0 && n < maze_cells(m)) {
+                m->masks[n] = cell_mask(m, n);
             }
         }
-        printf("\n");
+    }
+}
+
+int maze_build_masks(struct maze *m) {
+    if (m->masks != NULL) {
+        return 0;
+    }
+    int width = m->width;
+    int height = m->height;
+    int64_t layer_cells = (int64_t) width * height;
+    uint8_t *masks = malloc((size_t) maze_cells(m));
+    if (!masks) {
+        return 1;
+    }
+
+    // The layers are stored one after the other, so the rows of all layers
+    // form one tall grid. Row r is the row within the layer.
+    for (int64_t t = 0; t < (int64_t) height * m->layers; t++) {
+        int r = (int) (t % height);
+        int layer = (int) (t / height);
+
+        // Moves onto the border rows are invalid. Rows outside the layer
+        // point at the current row, their flags are zero anyway.
+        uint8_t up_ok = r - 1 > 0 && r - 1 < height - 1;
+        uint8_t row_ok = r > 0 && r < height - 1;
+        uint8_t down_ok = r + 1 > 0 && r + 1 < height - 1;
+        uint8_t above_ok = row_ok && layer + 1 < m->layers;
+        uint8_t below_ok = row_ok && layer > 0;
+        const char *cur = m->data + t * width;
+        const char *up = up_ok ? cur - width : cur;
+        const char *down = down_ok ? cur + width : cur;
+        const char *above = above_ok ? cur + layer_cells : cur;
+        const char *below = below_ok ? cur - layer_cells : cur;
+        uint8_t *out = masks + t * width;
+
+        // Without branches this loop over the inner columns is vectorized.
+        // Columns 1 and width - 2 only differ by a neighbour on the border,
+        // which is never a valid move. Stairs lead to stairs on the layer
+        // above and below.
+        for (int c = 1; c < width - 1; c++) {
+            uint8_t col_left = c - 1 > 0;
+            uint8_t col_right = c + 1 < width - 1;
+            uint8_t stairs = cur[c] == STAIRS;
+            out[c] = (uint8_t) ((up_ok & (up[c] != WALL))
+                                | (row_ok & col_right & (cur[c + 1] != WALL))
+                                       << 1
+                                | (down_ok & (down[c] != WALL)) << 2
+                                | (row_ok & col_left & (cur[c - 1] != WALL))
+                                       << 3
+                                | (above_ok & stairs & (above[c] == STAIRS))
+                                       << MOVE_LAYER_UP
+                                | (below_ok & stairs & (below[c] == STAIRS))
+                                       << MOVE_LAYER_DOWN);
+        }
+
+        out[0] = cell_mask(m, t * width);
+        out[width - 1] = cell_mask(m, t * width + width - 1);
+    }
+
+    m->masks = masks;
+    return 0;
+}
+
+const uint8_t *maze_masks(const struct maze *m) {
+    return m->masks;
+}
+
+unsigned maze_open_moves(const struct maze *m, int64_t index) {
+    if (m->masks != NULL) {
+        return m->masks[index];
+    }
+    return cell_mask(m, index);
+}
+
+int64_t maze_step(const struct maze *m, int d) {
+    assert(d >= 0 && d < N_MOVES_3D);
+    if (d == MOVE_LAYER_UP) {
+        return (int64_t) m->width * m->height;
+    } else if (d == MOVE_LAYER_DOWN) {
+        return -(int64_t) m->width * m->height;
+    }
+    return (int64_t) m_offsets[d][0] * m->width + m_offsets[d][1];
+}
+
+int64_t maze_neighbour(const struct maze *m, int64_t index, int d) {
+    if (d < 0 || d >= N_MOVES_3D) {
+        return -1;
+    }
+    int r = maze_row(m, index);
+    int c = maze_col(m, index);
+    if (d < N_MOVES) {
+        if (!maze_valid_move(m, r + m_offsets[d][0], c + m_offsets[d][1])) {
+            return -1;
+        }
+        return index + maze_step(m, d);
+    }
+    int layer = maze_layer(m, index) + (d == MOVE_LAYER_UP ? 1 : -1);
+    if (layer < 0 || layer >= m->layers || !maze_valid_move(m, r, c)) {
+        return -1;
+    }
+    int64_t next = index + maze_step(m, d);
+    if (m->data[index] != STAIRS || m->data[next] != STAIRS) {
+        return -1;
+    }
+    return next;
+}
+
+void maze_print(const struct maze *m, bool blocks) {
+    for (int64_t i = 0; i < maze_cells(m); i++) {
+        if (i > 0 && i % ((int64_t) m->width * m->height) == 0) {
+            printf("%c\n", LAYER_MARK);
+        }
+        if (blocks && m->data[i] == WALL) {
+            printf("\u2588");
+        } else if (i == m->start_index) {
+            putchar(START);
+        } else if (i == m->finish_index) {
+            putchar(FINISH);
+        } else {
+            putchar(m->data[i]);
+        }
+        if ((i + 1) % m->width == 0) {
+            printf("\n");
+        }
     }
     printf("\n");
 }
@@ -114,44 +291,68 @@ int maze_output_ppm(const struct maze *m, const char *filename) {
         return 1;
     }
 
-    /* Write header */
-    fprintf(fp, "P6\n%d %d\n255\n", (int) m->n, (int) m->n);
+    /* Write header, the layers are drawn below each other */
+    fprintf(fp, "P6\n%d %lld\n255\n", m->width,
+            (long long) m->height * m->layers);
 
     /* Write RGB color data for every cell location. */
-    for (int r = 0; r < m->n; r++) {
-        for (int c = 0; c < m->n; c++) {
-            unsigned char color[3] = { 0, 0, 0 }; // black
-            if (maze_at_start(m, r, c)) {
-                set_rgb(color, 0, 255, 0); // green
-            } else if (maze_at_destination(m, r, c)) {
-                set_rgb(color, 255, 165, 0); // orange
-            } else if (maze_get(m, r, c) == WALL) {
-                set_rgb(color, 255, 255, 255); // white
-            } else if (maze_get(m, r, c) == PATH) {
-                set_rgb(color, 255, 0, 0); // red
-            } else if (maze_get(m, r, c) == VISITED) {
-                set_rgb(color, 128, 128, 128); // gray
-            }
-            fwrite(color, 1, 3, fp);
+    for (int64_t i = 0; i < maze_cells(m); i++) {
+        unsigned char color[3] = { 0, 0, 0 }; // black
+        if (i == m->start_index) {
+            set_rgb(color, 0, 255, 0); // green
+        } else if (i == m->finish_index) {
+            set_rgb(color, 255, 165, 0); // orange
+        } else if (m->data[i] == WALL) {
+            set_rgb(color, 255, 255, 255); // white
+        } else if (m->data[i] == PATH) {
+            set_rgb(color, 255, 0, 0); // red
+        } else if (m->data[i] == VISITED) {
+            set_rgb(color, 128, 128, 128); // gray
         }
+        fwrite(color, 1, 3, fp);
     }
     fclose(fp);
     return 0;
 }
 
-/* Detect and set start and finish locations in maze 'm'. */
-static void check_for_start_and_dest(struct maze *m, int r, int c, char val) {
+/* Records 'index' as one of the destinations of maze 'm'.
+ * Returns 0 if successful, 1 otherwise. */
+static int add_destination(struct maze *m, int64_t index) {
+    if (m->n_finishes == m->finishes_capacity) {
+        size_t capacity = m->finishes_capacity ? m->finishes_capacity * 2 : 4;
+        int64_t *finishes = realloc(m->finishes, sizeof(int64_t) * capacity);
+        if (!finishes) {
+            return 1;
+        }
+        m->finishes = finishes;
+        m->finishes_capacity = capacity;
+    }
+    m->finishes[m->n_finishes++] = index;
+    return 0;
+}
+
+/* Detect and set start and finish locations in maze 'm'. Every finish
+ * marker is recorded, the last one is the destination of the maze.
+ * Returns 0 if successful, 1 otherwise. */
+static int check_for_start_and_dest(struct maze *m, int r, int c, char val,
+                                    bool *found_finish) {
     if (val == START) {
         m->start_index = maze_index(m, r, c);
     } else if (val == FINISH) {
         m->finish_index = maze_index(m, r, c);
+        *found_finish = true;
+        return add_destination(m, m->finish_index);
     }
+    return 0;
 }
 
 /* Set 'val' character in 'm' at position 'r', 'c'. */
 static void set_value(struct maze *m, int r, int c, char val) {
     if (val == WALL) {
         maze_set(m, r, c, WALL);
+    } else if (val == CONVEYOR || val == STAIRS
+               || (val >= '1' && val <= '0' + MAX_WEIGHT)) {
+        maze_set(m, r, c, val);
     } else {
         /* Should overwrite start and finish markers with FLOOR. */
         maze_set(m, r, c, FLOOR);
@@ -162,37 +363,96 @@ struct maze *maze_read(void) {
     char *buf = NULL;
     size_t bufsize = 0;
 
-    /* Read one line to get number of columns so we can allocate the maze. */
-    int ncols = (int) getline(&buf, &bufsize, stdin) - 1;
-    struct maze *m = maze_init(ncols);
+    /* Read one line to get number of columns so we can allocate the maze.
+     * Most mazes are square, so start with as many rows as columns, but
+     * not too many in case a very wide maze has few rows. */
+    ssize_t len = getline(&buf, &bufsize, stdin);
+    if (len < 2 || len - 1 > INT_MAX || buf[len - 1] != '\n') {
+        free(buf);
+        return NULL;
+    }
+    int ncols = (int) (len - 1);
+    struct maze *m = maze_init(ncols, ncols < INITIAL_ROWS ? ncols
+                                                           : INITIAL_ROWS);
     if (!m) {
         free(buf);
         return NULL;
     }
 
     int row = 0;
+    int layers = 1;
+    int layer_rows = 0;
+    bool found_finish = false;
     do {
-        if (row == ncols) { /* Error: more rows than columns */
-            maze_cleanup(m);
-            free(buf);
-            return NULL;
+        /* A layer ends, every layer must have as many rows as the first. */
+        if (len == 2 && buf[0] == LAYER_MARK) {
+            if (row == 0 || (layer_rows > 0 && row != layers * layer_rows)
+                || layers == INT_MAX) {
+                maze_cleanup(m);
+                free(buf);
+                return NULL;
+            }
+            if (layer_rows == 0) {
+                layer_rows = row;
+            }
+            layers++;
+            continue;
+        }
+
+        if (row == m->height) { /* Out of rows: double the number of rows */
+            int rows = m->height > INT_MAX / 2 ? INT_MAX : m->height * 2;
+            if (row == INT_MAX || maze_grow(m, rows) != 0) {
+                maze_cleanup(m);
+                free(buf);
+                return NULL;
+            }
         }
 
-        int column = 0;
-        while (buf[column] != '\n') {
-            check_for_start_and_dest(m, row, column, buf[column]);
+        for (int column = 0; column < ncols; column++) {
+            if (check_for_start_and_dest(m, row, column, buf[column],
+                                         &found_finish) != 0) {
+                maze_cleanup(m);
+                free(buf);
+                return NULL;
+            }
             set_value(m, row, column, buf[column]);
-            column++;
         }
         row++;
-    } while (getline(&buf, &bufsize, stdin) == ncols + 1); // ncols + \n
+    } while ((len = getline(&buf, &bufsize, stdin)) == ncols + 1 // + \n
+             || (len == 2 && buf[0] == LAYER_MARK));
 
-    if (row < ncols) { /* Error: more columns than rows */
+    /* The maze ends at the end of the input or at an empty line. */
+    if (len != -1 && !(len == 1 && buf[0] == '\n')) {
         maze_cleanup(m);
-        m = NULL;
+        free(buf);
+        return NULL;
     }
-
     free(buf);
+
+    /* Drop the rows that were reserved but not read. */
+    char *data = realloc(m->data, (size_t) ncols * (size_t) row);
+    if (data) {
+        m->data = data;
+    }
+    m->height = row;
+
+    if (layers > 1) {
+        if (row != layers * layer_rows) {
+            maze_cleanup(m);
+            return NULL;
+        }
+        m->height = layer_rows;
+        m->layers = layers;
+    }
+
+    if (!found_finish) {
+        m->finish_index = maze_index_layer(m, m->layers - 1, m->height - 2,
+                                           m->width - 2); // lower right
+        if (add_destination(m, m->finish_index) != 0) {
+            maze_cleanup(m);
+            return NULL;
+        }
+    }
     return m;
 }
 
@@ -206,6 +466,23 @@ void maze_destination(const struct maze *m, int *r, int *c) {
     *c = maze_col(m, m->finish_index);
 }
 
+int64_t maze_start_index(const struct maze *m) {
+    return m->start_index;
+}
+
+int64_t maze_finish_index(const struct maze *m) {
+    return m->finish_index;
+}
+
+size_t maze_destination_count(const struct maze *m) {
+    return m->n_finishes;
+}
+
+int64_t maze_destination_index(const struct maze *m, size_t i) {
+    assert(i < m->n_finishes);
+    return m->finishes[i];
+}
+
 bool maze_at_start(const struct maze *m, int r, int c) {
     return maze_index(m, r, c) == m->start_index;
 }
@@ -215,24 +492,61 @@ bool maze_at_destination(const struct maze *m, int r, int c) {
 }
 
 bool maze_valid_move(const struct maze *m, int r, int c) {
-    if (r > 0 && r < (m->n - 1) && c > 0 && c < (m->n - 1)) {
+    if (r > 0 && r < (m->height - 1) && c > 0 && c < (m->width - 1)) {
         return true;
     }
     return false;
 }
 
+int maze_weight(const struct maze *m, int r, int c) {
+    return maze_weight_index(m, maze_index(m, r, c));
+}
+
+int maze_weight_index(const struct maze *m, int64_t index) {
+    char val = maze_get_index(m, index);
+
+    if (val == WALL) return -1;
+    if (val == CONVEYOR) return 0;
+    if (val >= '1' && val <= '0' + MAX_WEIGHT) return val - '0';
+    return 1;
+}
+
 int maze_size(const struct maze *m) {
-    return m->n;
+    return m->height;
+}
+
+int maze_width(const struct maze *m) {
+    return m->width;
+}
+
+int maze_height(const struct maze *m) {
+    return m->height;
+}
+
+int maze_layers(const struct maze *m) {
+    return m->layers;
+}
+
+int64_t maze_cells(const struct maze *m) {
+    return (int64_t) m->width * m->height * m->layers;
+}
+
+int64_t maze_index(const struct maze *m, int r, int c) {
+    return (int64_t) m->width * r + c;
+}
+
+int64_t maze_index_layer(const struct maze *m, int layer, int r, int c) {
+    return ((int64_t) layer * m->height + r) * m->width + c;
 }
 
-int maze_index(const struct maze *m, int r, int c) {
-    return m->n * r + c;
+int maze_row(const struct maze *m, int64_t index) {
+    return (int) ((index / m->width) % m->height);
 }
 
-int maze_row(const struct maze *m, int index) {
-    return index / m->n;
+int maze_layer(const struct maze *m, int64_t index) {
+    return (int) (index / ((int64_t) m->width * m->height));
 }
 
-int maze_col(const struct maze *m, int index) {
-    return index % m->n;
+int maze_col(const struct maze *m, int64_t index) {
+    return (int) (index % m->width);
 }
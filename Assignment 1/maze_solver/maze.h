@@ -3,40 +3,76 @@
 #ifndef _MAZE_H_
 #define _MAZE_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 /* Defines for ascii characters used in the maze array. */
 #define WALL '#'
 #define FLOOR ' '
 #define PATH 'x'
 #define VISITED '.'
 #define TO_VISIT ','
+#define CONVEYOR '='
+#define STAIRS 'H'
+#define LAYER_MARK '~'
+
+/* Floor cells may instead hold a digit '1' to '9', the cost of moving onto
+ * the cell. A FLOOR cell costs 1 and moving onto a CONVEYOR is free. */
+#define MAX_WEIGHT 9
 
 /* We move in the following four directions: up, right, down, left
  * The origin of the maze (0, 0) is the upper left hand corner. */
 #define N_MOVES 4
 extern int m_offsets[N_MOVES][2];
 
+/* Mazes may have several layers, floors of a building stacked on top of
+ * each other. Two more moves lead from STAIRS to STAIRS at the same row
+ * and column on the layer above or below. Cells are indexed layer by
+ * layer, so a maze with one layer is indexed as before. */
+#define N_MOVES_3D 6
+#define MOVE_LAYER_UP 4
+#define MOVE_LAYER_DOWN 5
+
 /* Forward declaration for using a struct maze pointer in the prototypes. */
 struct maze;
 
-/* Reads a square maze from stdin. Start and destination markers are detected
- * and recorded. Everything that is not a WALL is stored as a FLOOR.
+/* Reads a rectangular maze from stdin. The width is the length of the first
+ * line and the maze ends at the end of the input or at an empty line, so
+ * several mazes can be read from one stream. A line with only LAYER_MARK
+ * starts the next layer; all layers must have the same number of rows.
+ * Start and destination markers are detected and recorded. Digits '1' to
+ * '9' and CONVEYOR cells are kept as weighted floor cells, STAIRS are kept
+ * and everything else that is not a WALL is stored as a FLOOR. Without a
+ * destination marker the destination is the lower right of the last
+ * layer.
  * Returns a pointer to the maze or NULL if an error occurred. */
 struct maze *maze_read(void);
 
 /* Frees all memory associated with the maze. */
 void maze_cleanup(struct maze *m);
 
-/* Returns the maze character stored at row 'r', column 'c'. */
+/* Returns the maze character stored at row 'r', column 'c' of the first
+ * layer. */
 char maze_get(const struct maze *m, int r, int c);
 
-/* Sets the maze character at row 'r', column 'c' to 'value'. */
+/* Sets the maze character at row 'r', column 'c' of the first layer to
+ * 'value'. */
 void maze_set(struct maze *m, int r, int c, char value);
 
-/* Prints the maze to stdout. If 'blocks' is true walls are printed as a block
- * character, otherwise the WALL character '#' is used. */
+/* Returns the maze character stored at 'index', in any layer. */
+char maze_get_index(const struct maze *m, int64_t index);
+
+/* Sets the maze character at 'index', in any layer, to 'value'. */
+void maze_set_index(struct maze *m, int64_t index, char value);
+
+/* Prints the maze to stdout, with a LAYER_MARK line between layers. If
+ * 'blocks' is true walls are printed as a block character, otherwise the
+ * WALL character '#' is used. */
 void maze_print(const struct maze *m, bool blocks);
 
-/* Writes the maze in Portable Pixmap (ppm) format to 'filename'. */
+/* Writes the maze in Portable Pixmap (ppm) format to 'filename', with the
+ * layers below each other. */
 int maze_output_ppm(const struct maze *m, const char *filename);
 
 /* Sets the integer values pointed to by 'r' and 'c' to the row
@@ -47,6 +83,20 @@ void maze_start(const struct maze *m, int *r, int *c);
  * and column of the destination position. */
 void maze_destination(const struct maze *m, int *r, int *c);
 
+/* Returns the index of the start location. */
+int64_t maze_start_index(const struct maze *m);
+
+/* Returns the index of the destination. */
+int64_t maze_finish_index(const struct maze *m);
+
+/* Returns the number of destination markers in the maze, or 1 if the
+ * maze has none and the default destination is used. */
+size_t maze_destination_count(const struct maze *m);
+
+/* Returns the index of destination marker 'i', counted in reading order.
+ * The destination returned by maze_destination() is the last one. */
+int64_t maze_destination_index(const struct maze *m, size_t i);
+
 /* Returns true if (r, c) is the start location. */
 bool maze_at_start(const struct maze *m, int r, int c);
 
@@ -54,28 +104,88 @@ bool maze_at_start(const struct maze *m, int r, int c);
 bool maze_at_destination(const struct maze *m, int r, int c);
 
 /* Returns true if (r, c) is valid position in the maze.
- * Note: The borders of the maze, rows 0 and maze_size() - 1 and columns
- * 0 and maze_size() - 1, are inaccessible. */
+ * Note: The borders of the maze, rows 0 and maze_height() - 1 and columns
+ * 0 and maze_width() - 1, are inaccessible. */
 bool maze_valid_move(const struct maze *m, int r, int c);
 
+/* Returns the cost of moving onto (r, c): the digit for weighted cells, 0
+ * for a CONVEYOR, 1 for any other floor cell and -1 for a WALL. */
+int maze_weight(const struct maze *m, int r, int c);
+
+/* Returns the cost of moving onto the cell at 'index', like maze_weight().
+ */
+int maze_weight_index(const struct maze *m, int64_t index);
+
+/* Builds the open-neighbour masks of maze 'm': one byte per cell in which
+ * bit d is set if move d, one of the N_MOVES_3D moves, is a valid move
+ * onto a cell that is not a WALL. The masks are computed in one vectorizable
+ * pass and kept up to date by maze_set(), so a solver can iterate the set
+ * bits instead of checking every neighbour. Building them is
+ * optional; maze_masks() returns NULL until they are built. The moves
+ * between layers are taken from the STAIRS present when the masks are
+ * built, so solvers may mark visited stairs afterwards.
+ * Returns 0 if successful, 1 otherwise. */
+int maze_build_masks(struct maze *m);
+
+/* Returns the open-neighbour masks of maze 'm', indexed by maze_index(),
+ * or NULL if maze_build_masks() was not called. */
+const uint8_t *maze_masks(const struct maze *m);
+
+/* Returns the open-neighbour mask of the cell at 'index', computed from
+ * the neighbours if the masks were not built. */
+unsigned maze_open_moves(const struct maze *m, int64_t index);
+
+/* Returns the difference in index of move 'd', one of the N_MOVES_3D
+ * moves. */
+int64_t maze_step(const struct maze *m, int d);
+
+/* Returns the index of the neighbour of the cell at 'index' in direction
+ * 'd', one of the N_MOVES_3D moves, or -1 if that is not a valid move:
+ * 'd' is no move, the neighbour lies on the border of its layer, or a move
+ * between layers does not go from STAIRS to STAIRS. Walls are not
+ * checked. */
+int64_t maze_neighbour(const struct maze *m, int64_t index, int d);
+
 /* Returns the size of the maze 'm'.
  *
- * We only support square mazes, so the size is the number of rows
- * which is also the number of columns. */
+ * This is the number of rows, which for square mazes is also the number of
+ * columns. Use maze_width() and maze_height() for rectangular mazes. */
 int maze_size(const struct maze *m);
 
-/* Returns the index in the 1d array for row 'r' and column 'c'.
+/* Returns the number of columns of the maze 'm'. */
+int maze_width(const struct maze *m);
+
+/* Returns the number of rows of every layer of the maze 'm'. */
+int maze_height(const struct maze *m);
+
+/* Returns the number of layers of the maze 'm'. */
+int maze_layers(const struct maze *m);
+
+/* Returns the number of cells of the maze 'm' in all layers, which is one
+ * more than the largest index. */
+int64_t maze_cells(const struct maze *m);
+
+/* Returns the index in the 1d array for row 'r' and column 'c' of the
+ * first layer.
  *
  * Although there is no need to expose that the maze is internally stored
  * as one dimension array, using the index allows a location to be
  * stored as a single integer on the stack or queue instead of two
- * separate integers for the row and column of a location. */
-int maze_index(const struct maze *m, int r, int c);
+ * separate integers for the row and column of a location.
+ * Indices are 64-bit, so mazes may have more than INT_MAX cells. */
+int64_t maze_index(const struct maze *m, int r, int c);
+
+/* Returns the index in the 1d array for row 'r' and column 'c' of layer
+ * 'layer'. */
+int64_t maze_index_layer(const struct maze *m, int layer, int r, int c);
+
+/* Returns the row number, within its layer, of the 1d 'index'. */
+int maze_row(const struct maze *m, int64_t index);
 
-/* Returns the row number of the 1d 'index'. */
-int maze_row(const struct maze *m, int index);
+/* Returns the layer number of the 1d 'index'. */
+int maze_layer(const struct maze *m, int64_t index);
 
 /* Returns the column number of the 1d 'index'. */
-int maze_col(const struct maze *m, int index);
+int maze_col(const struct maze *m, int64_t index);
 
 #endif
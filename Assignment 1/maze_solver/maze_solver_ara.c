@@ -0,0 +1,132 @@
+/*H**********************************************************************
+* FILENAME: maze_solver_ara.c
+*
+* DESCRIPTION:
+*   Solving a maze within a deadline with Anytime Repairing A* (ARA*).
+*
+* PUBLIC FUNCTIONS:
+*   int main( argc, argv[] )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "maze.h"
+#include "profile.h"
+#include "solver_ara.h"
+
+/**
+ * Reads a maze and plans a path from start to destination that improves
+ * until it is the shortest, or until '--deadline-ms' milliseconds have
+ * passed. The length of the best path found is printed together with its
+ * suboptimality bound, followed by the maze with the path. With
+ * '--profile' the time and hardware counters of every phase and the
+ * planner statistics are printed to stderr.
+ *
+ * @param argc count.
+ * @param argv array.
+ * @return
+ */
+int main(int argc, char *argv[]) {
+    struct profile *prof = NULL;
+    double deadline_ms = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--deadline-ms") == 0 && i + 1 < argc) {
+            deadline_ms = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--profile") == 0 && prof == NULL) {
+            prof = profile_init();
+
+            if (prof == NULL) {
+                fprintf(stderr, "Error initializing profiler\n");
+
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--profile] [--deadline-ms ms]\n",
+                    argv[0]);
+            profile_cleanup(prof);
+
+            return 1;
+        }
+    }
+
+    /* read maze */
+    profile_begin(prof);
+    struct maze *m = maze_read();
+    profile_end(prof, "maze_read");
+
+    if (!m) {
+        printf("Error reading maze\n");
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    profile_begin(prof);
+    struct solver_ara *a = NULL;
+
+    if (maze_build_masks(m) == 0) a = solver_ara_init(m);
+
+    profile_end(prof, "solver_ara_init");
+
+    if (a == NULL) {
+        printf("ara failed\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    /* solve maze */
+    profile_begin(prof);
+    int64_t path_length = solver_ara_solve(a, deadline_ms);
+    profile_end(prof, "solver_ara_solve");
+
+    if (prof != NULL) solver_ara_stats(a);
+
+    if (path_length < 0) {
+        if (path_length == ERROR) {
+            printf("ara failed\n");
+        } else if (path_length == ARA_TIMEOUT) {
+            printf("no path found within the deadline\n");
+        } else {
+            printf("no path found from start to destination\n");
+        }
+
+        solver_ara_cleanup(a);
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    printf("ara found a path of length: %" PRId64 "\n", path_length);
+
+    // Round the bound up, so the printed value is still a bound.
+    if (solver_ara_bound(a) > 0) {
+        printf("suboptimality bound: %.2f\n",
+               ceil(solver_ara_bound(a) * 100) / 100);
+    } else {
+        printf("suboptimality bound: unknown\n");
+    }
+
+    /* print maze */
+    solver_ara_mark_path(a);
+    maze_print(m, false);
+
+    solver_ara_cleanup(a);
+    maze_cleanup(m);
+    profile_cleanup(prof);
+
+    return 0;
+}
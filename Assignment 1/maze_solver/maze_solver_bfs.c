@@ -5,8 +5,9 @@
 *   Solving a maze using the breadth-first search algorithm.
 *
 * PUBLIC FUNCTIONS:
-*   int bfs_solve( m )
-*   int main(void)
+*   int64_t bfs_solve( m )
+*   int64_t zero_one_solve( m )
+*   int main( argc, argv[] )
 *
 * AUTHOR: Thom Kok (Student nr: 15316491)
 *
@@ -14,33 +15,21 @@
 *
 *H*/
 
+// Needed for sysconf()
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
 
+#include "batch.h"
 #include "maze.h"
-#include "queue.h"
-
-#define QUEUE_SIZE 100000000
-
-#define NOT_FOUND (-1)
-#define ERROR (-2)
-
-typedef struct maze {
-    int n;
-    int start_index;
-    int finish_index;
-    char *data;
-} maze;
-
-typedef struct queue {
-    int *data;
-    int pushes;
-    int pops;
-    int first_in_line;
-    int length;
-    int capacity;
-} queue;
+#include "profile.h"
+#include "sharded.h"
+#include "solver.h"
 
 /**
  * Solves the maze m.
@@ -50,161 +39,176 @@ typedef struct queue {
  * @param m the maze.
  * @return
  */
-int bfs_solve(struct maze *m) {
+int64_t bfs_solve(struct maze *m) {
     if(m == NULL) return ERROR;
 
-    struct queue *path = queue_init(QUEUE_SIZE);
-
-    int loc_row = maze_row(m, m->start_index);
-    int loc_col = maze_col(m, m->start_index);
-
-    maze_set(m, loc_row, loc_col, VISITED);
-    queue_push(path, maze_index(m, loc_row, loc_col));
-    path->length++;
-
-    int row_offsets[] = {-1, 1, 0, 0};
-    int col_offsets[] = {0, 0, -1, 1};
+    struct solver *s = solver_init();
 
-    char direction[4];
-    int choices = 0;
-    int path_length;
+    if (s == NULL) return ERROR;
 
-    for (int i = 0; i < QUEUE_SIZE; i++) {
-        // Looking around for possible directions and the destination.
-        for (int d = 0; d < N_MOVES; d++) {
-            int new_row = loc_row + row_offsets[d];
-            int new_col = loc_col + col_offsets[d];
+    int64_t path_length = solver_bfs(s, m);
 
-            direction[d] = maze_get(m, new_row, new_col);
+    solver_cleanup(s);
 
-            if (maze_at_destination(m, new_row, new_col)) {
-                path_length = path->length;
-
-                for (int p = 0; p < path->length; p++) {
-                    if (queue_empty(path)) break;
-
-                    loc_row = maze_row(m, path->data[p]);
-                    loc_col = maze_col(m, path->data[p]);
-
-                    path->data[p] = PATH;
+    return path_length;
+}
 
-                    maze_set(m, loc_row, loc_col, PATH);
-                }
+/**
+ * Solves the maze m, where moving onto a CONVEYOR is free and every other
+ * move costs 1.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred.
+ *
+ * @param m the maze.
+ * @return
+ */
+int64_t zero_one_solve(struct maze *m) {
+    if (m == NULL) return ERROR;
 
-                queue_cleanup(path);
+    struct solver *s = solver_init();
 
-                return path_length;
-            }
+    if (s == NULL) return ERROR;
 
-            if (direction[d] == FLOOR) choices++;
-        }
+    int64_t cost = solver_zero_one(s, m);
 
-        // If there are multiple FLOOR choices to go to, add TO_VISIT.
-        if (choices > 1) {
-            for (int d = 0; d < N_MOVES; d++) {
-                int new_row = loc_row + row_offsets[d];
-                int new_col = loc_col + col_offsets[d];
+    solver_cleanup(s);
 
-                direction[d] = maze_get(m, new_row, new_col);
+    return cost;
+}
 
-                if (direction[d] == FLOOR) {
-                    maze_set(m, new_row, new_col, TO_VISIT);
-                }
+/**
+ * Tries to display the maze and showing the path to destination.
+ * With '--profile' the time and hardware counters of every phase are
+ * printed to stderr. With '--batch' a stream of mazes separated by empty
+ * lines is solved on '--threads' worker threads (default: one per core).
+ * With '--queries' one maze is read and the start and destination pairs
+ * that follow it are solved on the worker threads sharing the maze.
+ * With '--zero-one' CONVEYOR cells are free to move onto and the cost of
+ * the cheapest path is reported. With '--bands n' the maze is split into
+ * n bands of rows searched by their own worker threads, and the number of
+ * cells and messages exchanged between the bands is printed to stderr for
+ * every level.
+ *
+ * @param argc count.
+ * @param argv array.
+ * @return
+ */
+int main(int argc, char *argv[]) {
+    struct profile *prof = NULL;
+    bool batch = false;
+    bool queries = false;
+    bool zero_one = false;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    long bands = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") == 0) {
+            batch = true;
+        } else if (strcmp(argv[i], "--queries") == 0) {
+            queries = true;
+        } else if (strcmp(argv[i], "--zero-one") == 0) {
+            zero_one = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--bands") == 0 && i + 1 < argc) {
+            bands = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--profile") == 0 && prof == NULL) {
+            prof = profile_init();
+
+            if (prof == NULL) {
+                fprintf(stderr, "Error initializing profiler\n");
+
+                return 1;
             }
-        }
-
-        // If FLOOR or TO_VISIT move to it.
-        for (int d = 0; d < N_MOVES; d++) {
-            if (direction[d] == FLOOR || direction[d] == TO_VISIT) {
-                int new_row = loc_row + row_offsets[d];
-                int new_col = loc_col + col_offsets[d];
-
-                maze_set(m, new_row, new_col, VISITED);
-
-                loc_row = new_row;
-                loc_col = new_col;
-
-                queue_push(path, maze_index(m, new_row, new_col));
+        } else {
+            fprintf(stderr, "usage: %s [--profile] [--zero-one | --batch | "
+                    "--queries | --bands n] [--threads n]\n", argv[0]);
+            profile_cleanup(prof);
 
-                goto find_new_direction;
-            }
+            return 1;
         }
+    }
 
-        // Reached dead end. Time to backtrack and look around for junction.
-        for (int p = 0; p < path->length; p++) {
-            int previous_row = maze_row(m, path->data[path->length]);
-            int previous_col = maze_col(m, path->data[path->length]);
-
-            for (int d = 0; d < N_MOVES; d++) {
-                int new_row = loc_row + row_offsets[d];
-                int new_col = loc_col + col_offsets[d];
-
-                direction[d] = maze_get(m, new_row, new_col);
-
-                if (direction[d] == TO_VISIT) {
-                    queue_push(path, maze_index(m, previous_row, previous_col));
-
-                    maze_set(m, new_row, new_col, VISITED);
-
-                    loc_row = new_row;
-                    loc_col = new_col;
-
-                    queue_push(path, maze_index(m, loc_row, loc_col));
-
-                    goto find_new_direction;
-                }
-            }
-
-            queue_pop(path);
+    if (batch || queries) {
+        size_t workers = threads > 0 ? (size_t) threads : 1;
 
-            loc_row = maze_row(m, path->data[path->length]);
-            loc_col = maze_col(m, path->data[path->length]);
-        }
+        profile_begin(prof);
+        int error = queries ? batch_queries(workers) : batch_solve(workers);
+        profile_end(prof, queries ? "batch_queries" : "batch_solve");
 
-        find_new_direction: continue;
+        profile_cleanup(prof);
+        return error;
     }
 
-    queue_cleanup(path);
-
-    return NOT_FOUND;
-}
-
-/**
- * Tries to display the maze and showing the path to destination.
- *
- * @return
- */
-int main(void) {
     /* read maze */
+    profile_begin(prof);
     struct maze *m = maze_read();
+    profile_end(prof, "maze_read");
 
     if (!m) {
         printf("Error reading maze\n");
+        profile_cleanup(prof);
 
         return 1;
     }
 
+    profile_begin(prof);
+
+    if (maze_build_masks(m) != 0) {
+        printf("bfs failed\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    profile_end(prof, "maze_build_masks");
+
     /* solve maze */
-    int path_length = bfs_solve(m);
+    profile_begin(prof);
+    int64_t path_length;
+
+    if (zero_one) {
+        path_length = zero_one_solve(m);
+        profile_end(prof, "zero_one_solve");
+    } else if (bands > 0) {
+        path_length = sharded_bfs(m, (size_t) bands, stderr);
+        profile_end(prof, "sharded_bfs");
+    } else {
+        path_length = bfs_solve(m);
+        profile_end(prof, "bfs_solve");
+    }
 
     if (path_length == ERROR) {
         printf("bfs failed\n");
         maze_cleanup(m);
+        profile_cleanup(prof);
 
         return 1;
     } else if (path_length == NOT_FOUND) {
         printf("no path found from start to destination\n");
         maze_cleanup(m);
+        profile_cleanup(prof);
 
         return 1;
     }
 
-    printf("bfs found a path of length: %d\n", path_length);
+    if (zero_one) {
+        printf("bfs found a path of cost: %" PRId64 "\n", path_length);
+    } else {
+        printf("bfs found a path of length: %" PRId64 "\n", path_length);
+    }
 
     /* print maze */
+    profile_begin(prof);
     maze_print(m, false);
+    profile_end(prof, "maze_print");
+
+    profile_begin(prof);
     maze_output_ppm(m, "out.ppm");
+    profile_end(prof, "maze_output_ppm");
 
     maze_cleanup(m);
+    profile_cleanup(prof);
     return 0;
 }
@@ -5,8 +5,8 @@
 *   Solving a maze using the depth-first search algorithm.
 *
 * PUBLIC FUNCTIONS:
-*   int dfs_solve( m )
-*   int main(void)
+*   int64_t dfs_solve( m )
+*   int main( argc, argv[] )
 *
 * AUTHOR: Thom Kok (Student nr: 15316491)
 *
@@ -14,195 +14,190 @@
 *
 *H*/
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "maze.h"
+#include "profile.h"
 #include "stack.h"
 
-#define STACK_SIZE 100000000
-
 #define NOT_FOUND (-1)
 #define ERROR (-2)
 
-typedef struct maze {
-    int n;
-    int start_index;
-    int finish_index;
-    char *data;
-} maze;
-
-typedef struct stack {
-    int *data;
-    int pushes;
-    int pops;
-    int size;
-    int capacity;
-} stack;
-
 /**
  * Solves the maze m.
+ * The stack holds the path from the start to the current location. Every
+ * step moves to the first unvisited neighbour, or backtracks by popping the
+ * stack at a dead end, so once the destination is reached the stack
+ * contains the path.
  * Returns the length of the path if a path is found.
  * Returns NOT_FOUND if no path is found and ERROR if an error occurred.
  *
  * @param m the maze.
  * @return
  */
-int dfs_solve(struct maze *m) {
+int64_t dfs_solve(struct maze *m) {
     if(m == NULL) return ERROR;
 
-    struct stack *path = stack_init(STACK_SIZE);
+    // The stack grows when the path is longer than this.
+    size_t capacity = (size_t) maze_width(m) + (size_t) maze_height(m)
+                      + (size_t) maze_layers(m);
+    struct stack *path = stack_init(capacity);
+
+    if (path == NULL) return ERROR;
 
-    int loc_row = maze_row(m, m->start_index);
-    int loc_col = maze_col(m, m->start_index);
+    int64_t start = maze_start_index(m);
+    int64_t finish = maze_finish_index(m);
 
-    maze_set(m, loc_row, loc_col, VISITED);
-    stack_push(path, maze_index(m, loc_row, loc_col));
+    maze_set_index(m, start, VISITED);
 
-    int row_offsets[] = {-1, 1, 0, 0};
-    int col_offsets[] = {0, 0, -1, 1};
+    if (stack_push(path, start) != 0) {
+        stack_cleanup(path);
 
-    char direction[4];
-    int choices = 0;
-    int path_length;
+        return ERROR;
+    }
 
-    for (int i = 0; i < STACK_SIZE; i++) {
-        // Looking around for possible directions and the destination.
-        for (int d = 0; d < N_MOVES; d++) {
-            int new_row = loc_row + row_offsets[d];
-            int new_col = loc_col + col_offsets[d];
+    while (stack_empty(path) == 0) {
+        int64_t location = stack_peek(path);
 
-            direction[d] = maze_get(m, new_row, new_col);
+        if (location == finish) break;
 
-            if (maze_at_destination(m, new_row, new_col)) {
-                path_length = path->size;
+        // Move to the first open neighbour not visited yet, if there is one.
+        // The mask only holds the open moves, lowest direction first.
+        unsigned moves = maze_open_moves(m, location);
+        bool moved = false;
 
-                for (int p = 0; p < path->size; p++) {
-                    if (stack_empty(path)) break;
+        while (moves != 0 && !moved) {
+            int64_t next = location + maze_step(m, __builtin_ctz(moves));
 
-                    loc_row = maze_row(m, path->data[p]);
-                    loc_col = maze_col(m, path->data[p]);
+            moves &= moves - 1;
 
-                    path->data[p] = PATH;
+            if (maze_get_index(m, next) == VISITED) continue;
 
-                    maze_set(m, loc_row, loc_col, PATH);
-                }
+            maze_set_index(m, next, VISITED);
 
+            if (stack_push(path, next) != 0) {
                 stack_cleanup(path);
 
-                return path_length;
+                return ERROR;
             }
 
-            if (direction[d] == FLOOR) choices++;
+            moved = true;
         }
 
-        // If there are multiple FLOOR choices to go to, add TO_VISIT.
-        if (choices > 1) {
-            for (int d = 0; d < N_MOVES; d++) {
-                int new_row = loc_row + row_offsets[d];
-                int new_col = loc_col + col_offsets[d];
-
-                direction[d] = maze_get(m, new_row, new_col);
-
-                if (direction[d] == FLOOR) {
-                    maze_set(m, new_row, new_col, TO_VISIT);
-                }
-            }
-        }
-
-        // If FLOOR or TO_VISIT move to it.
-        for (int d = 0; d < N_MOVES; d++) {
-            if (direction[d] == FLOOR || direction[d] == TO_VISIT) {
-                int new_row = loc_row + row_offsets[d];
-                int new_col = loc_col + col_offsets[d];
-
-                maze_set(m, new_row, new_col, VISITED);
-
-                loc_row = new_row;
-                loc_col = new_col;
-
-                stack_push(path, maze_index(m, new_row, new_col));
-
-                goto find_new_direction;
-            }
-        }
-
-        // Reached dead end. Time to backtrack and look around for junction.
-        for (int p = 0; p < path->size; p++) {
-            int previous_row = maze_row(m, path->data[path->size]);
-            int previous_col = maze_col(m, path->data[path->size]);
-
-            for (int d = 0; d < N_MOVES; d++) {
-                int new_row = loc_row + row_offsets[d];
-                int new_col = loc_col + col_offsets[d];
-
-                direction[d] = maze_get(m, new_row, new_col);
-
-                if (direction[d] == TO_VISIT) {
-                    stack_push(path, maze_index(m, previous_row, previous_col));
-
-                    maze_set(m, new_row, new_col, VISITED);
+        // Reached dead end. Time to backtrack.
+        if (!moved) stack_pop(path);
+    }
 
-                    loc_row = new_row;
-                    loc_col = new_col;
+    if (stack_empty(path) != 0) {
+        stack_cleanup(path);
 
-                    stack_push(path, maze_index(m, loc_row, loc_col));
+        return NOT_FOUND;
+    }
 
-                    goto find_new_direction;
-                }
-            }
+    // The stack holds start, path and destination. Mark the path itself.
+    int64_t path_length = (int64_t) stack_size(path) - 1;
 
-            stack_pop(path);
+    stack_pop(path);
 
-            loc_row = maze_row(m, path->data[path->size]);
-            loc_col = maze_col(m, path->data[path->size]);
-        }
+    while (stack_size(path) > 1) {
+        int64_t location = stack_pop(path);
 
-        find_new_direction: continue;
+        maze_set_index(m, location, PATH);
     }
 
     stack_cleanup(path);
 
-    return NOT_FOUND;
+    return path_length;
 }
 
 /**
  * Tries to display the maze and showing the path to destination.
+ * With '--profile' the time and hardware counters of every phase are
+ * printed to stderr.
  *
+ * @param argc count.
+ * @param argv array.
  * @return
  */
-int main(void) {
+int main(int argc, char *argv[]) {
+    struct profile *prof = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0 && prof == NULL) {
+            prof = profile_init();
+
+            if (prof == NULL) {
+                fprintf(stderr, "Error initializing profiler\n");
+
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--profile]\n", argv[0]);
+            profile_cleanup(prof);
+
+            return 1;
+        }
+    }
+
     /* read maze */
+    profile_begin(prof);
     struct maze *m = maze_read();
+    profile_end(prof, "maze_read");
 
     if (!m) {
         printf("Error reading maze\n");
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    profile_begin(prof);
+
+    if (maze_build_masks(m) != 0) {
+        printf("dfs failed\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
 
         return 1;
     }
 
+    profile_end(prof, "maze_build_masks");
+
     /* solve maze */
-    int path_length = dfs_solve(m);
+    profile_begin(prof);
+    int64_t path_length = dfs_solve(m);
+    profile_end(prof, "dfs_solve");
 
     if (path_length == ERROR) {
         printf("dfs failed\n");
         maze_cleanup(m);
+        profile_cleanup(prof);
 
         return 1;
     } else if (path_length == NOT_FOUND) {
         printf("no path found from start to destination\n");
         maze_cleanup(m);
+        profile_cleanup(prof);
 
         return 1;
     }
 
-    printf("dfs found a path of length: %d\n", path_length);
+    printf("dfs found a path of length: %" PRId64 "\n", path_length);
 
     /* print maze */
+    profile_begin(prof);
     maze_print(m, false);
+    profile_end(prof, "maze_print");
+
+    profile_begin(prof);
     maze_output_ppm(m, "out.ppm");
+    profile_end(prof, "maze_output_ppm");
 
     maze_cleanup(m);
+    profile_cleanup(prof);
     return 0;
 }
@@ -0,0 +1,136 @@
+/*H**********************************************************************
+* FILENAME: maze_solver_dijkstra.c
+*
+* DESCRIPTION:
+*   Solving a weighted maze using Dijkstra's algorithm.
+*
+* PUBLIC FUNCTIONS:
+*   int64_t dijkstra_solve( m )
+*   int main( argc, argv[] )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "maze.h"
+#include "profile.h"
+#include "solver.h"
+
+/**
+ * Solves the maze m, where moving onto a cell costs its weight.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred.
+ *
+ * @param m the maze.
+ * @return
+ */
+int64_t dijkstra_solve(struct maze *m) {
+    if (m == NULL) return ERROR;
+
+    struct solver *s = solver_init();
+
+    if (s == NULL) return ERROR;
+
+    int64_t cost = solver_dijkstra(s, m);
+
+    solver_cleanup(s);
+
+    return cost;
+}
+
+/**
+ * Tries to display the maze and showing the cheapest path to destination.
+ * Digits '1' to '9' in the maze are the cost of moving onto a cell, every
+ * other floor cell costs 1. With '--profile' the time and hardware
+ * counters of every phase are printed to stderr.
+ *
+ * @param argc count.
+ * @param argv array.
+ * @return
+ */
+int main(int argc, char *argv[]) {
+    struct profile *prof = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0 && prof == NULL) {
+            prof = profile_init();
+
+            if (prof == NULL) {
+                fprintf(stderr, "Error initializing profiler\n");
+
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--profile]\n", argv[0]);
+            profile_cleanup(prof);
+
+            return 1;
+        }
+    }
+
+    /* read maze */
+    profile_begin(prof);
+    struct maze *m = maze_read();
+    profile_end(prof, "maze_read");
+
+    if (!m) {
+        printf("Error reading maze\n");
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    profile_begin(prof);
+
+    if (maze_build_masks(m) != 0) {
+        printf("dijkstra failed\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    profile_end(prof, "maze_build_masks");
+
+    /* solve maze */
+    profile_begin(prof);
+    int64_t cost = dijkstra_solve(m);
+    profile_end(prof, "dijkstra_solve");
+
+    if (cost == ERROR) {
+        printf("dijkstra failed\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    } else if (cost == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    printf("dijkstra found a path of cost: %" PRId64 "\n", cost);
+
+    /* print maze */
+    profile_begin(prof);
+    maze_print(m, false);
+    profile_end(prof, "maze_print");
+
+    profile_begin(prof);
+    maze_output_ppm(m, "out.ppm");
+    profile_end(prof, "maze_output_ppm");
+
+    maze_cleanup(m);
+    profile_cleanup(prof);
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*H**********************************************************************
+* FILENAME: maze_solver_external.c
+*
+* DESCRIPTION:
+*   Solving mazes larger than memory with an external-memory BFS.
+*
+* PUBLIC FUNCTIONS:
+*   int main( argc, argv[] )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+// Needed for mkstemp() and unlink()
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "extbfs.h"
+#include "packed.h"
+#include "profile.h"
+
+/* Default size of the neighbour buffer in bytes. */
+#define MEM_LIMIT (64 * 1024 * 1024)
+
+/**
+ * Convert the text maze on stdin to a packed file in directory tmpdir.
+ * Return the name of the file, to be removed and freed by the caller, or
+ * NULL if an error occurred.
+ *
+ * @param tmpdir the directory or NULL for $TMPDIR or /tmp.
+ * @return
+ */
+static char *pack_stdin(const char *tmpdir) {
+    if (tmpdir == NULL) tmpdir = getenv("TMPDIR");
+    if (tmpdir == NULL) tmpdir = "/tmp";
+
+    size_t len = strlen(tmpdir) + sizeof("/mazeXXXXXX");
+    char *name = malloc(len);
+
+    if (name == NULL) return NULL;
+
+    snprintf(name, len, "%s/mazeXXXXXX", tmpdir);
+
+    int fd = mkstemp(name);
+
+    if (fd == -1) {
+        free(name);
+
+        return NULL;
+    }
+
+    close(fd);
+
+    if (packed_convert(stdin, name) != 0) {
+        unlink(name);
+        free(name);
+
+        return NULL;
+    }
+
+    return name;
+}
+
+/**
+ * Solves a packed maze with an external-memory BFS and prints the length
+ * of the shortest path; the path itself is not marked, as the maze is
+ * never held in memory. The I/O volume of every level is printed to
+ * stderr. The maze is read from 'file', or converted from the text maze
+ * on stdin to a temporary packed file. With '--pack file' the text maze on
+ * stdin is only converted to 'file'. '--mem-limit bytes' sets the size of
+ * the neighbour buffer and '--tmpdir dir' the directory of the temporary
+ * files.
+ *
+ * @param argc count.
+ * @param argv array.
+ * @return
+ */
+int main(int argc, char *argv[]) {
+    struct profile *prof = NULL;
+    const char *filename = NULL;
+    const char *packname = NULL;
+    const char *tmpdir = NULL;
+    long long mem_limit = MEM_LIMIT;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+            packname = argv[++i];
+        } else if (strcmp(argv[i], "--mem-limit") == 0 && i + 1 < argc) {
+            mem_limit = strtoll(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--tmpdir") == 0 && i + 1 < argc) {
+            tmpdir = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && prof == NULL) {
+            prof = profile_init();
+
+            if (prof == NULL) {
+                fprintf(stderr, "Error initializing profiler\n");
+
+                return 1;
+            }
+        } else if (argv[i][0] != '-' && filename == NULL) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [--profile] [--mem-limit bytes] "
+                    "[--tmpdir dir] [--pack file | file]\n", argv[0]);
+            profile_cleanup(prof);
+
+            return 1;
+        }
+    }
+
+    if (packname != NULL) {
+        int error = filename != NULL || packed_convert(stdin, packname) != 0;
+
+        if (error) printf("Error packing maze\n");
+
+        profile_cleanup(prof);
+
+        return error;
+    }
+
+    if (mem_limit < EXTBFS_MIN_MEMORY) {
+        fprintf(stderr, "The memory limit must be at least %d bytes\n",
+                EXTBFS_MIN_MEMORY);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    /* pack maze */
+    char *tempname = NULL;
+
+    if (filename == NULL) {
+        profile_begin(prof);
+        tempname = pack_stdin(tmpdir);
+        profile_end(prof, "packed_convert");
+        filename = tempname;
+    }
+
+    struct packed *p = filename != NULL ? packed_open(filename) : NULL;
+
+    if (p == NULL) {
+        printf("Error reading maze\n");
+
+        if (tempname != NULL) unlink(tempname);
+
+        free(tempname);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    /* solve maze */
+    profile_begin(prof);
+    int64_t path_length = ext_bfs(p, tmpdir, (size_t) mem_limit, stderr);
+    profile_end(prof, "ext_bfs");
+
+    if (path_length == ERROR) {
+        printf("external bfs failed\n");
+    } else if (path_length == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+    } else {
+        printf("bfs found a path of length: %" PRId64 "\n", path_length);
+    }
+
+    packed_close(p);
+
+    if (tempname != NULL) unlink(tempname);
+
+    free(tempname);
+    profile_cleanup(prof);
+
+    return path_length < 0;
+}
@@ -0,0 +1,248 @@
+/*H**********************************************************************
+* FILENAME: maze_solver_field.c
+*
+* DESCRIPTION:
+*   Distance from every cell of a maze to the nearest destination.
+*
+* PUBLIC FUNCTIONS:
+*   uint32_t *field_solve( m )
+*   int main( argc, argv[] )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "maze.h"
+#include "profile.h"
+#include "solver.h"
+
+/* Formats of the distance field written to stdout. */
+enum field_format { FORMAT_U32, FORMAT_U16, FORMAT_PGM };
+
+/**
+ * Computes the distance field of maze m with every destination marker as
+ * a source. Returns the field or NULL if an error occurred.
+ *
+ * @param m the maze.
+ * @return
+ */
+uint32_t *field_solve(const struct maze *m) {
+    if (m == NULL) return NULL;
+
+    size_t n = maze_destination_count(m);
+    int64_t *sources = malloc(sizeof(int64_t) * n);
+    uint32_t *field = malloc(sizeof(uint32_t) * (size_t) maze_cells(m));
+    struct solver *s = solver_init();
+
+    if (sources == NULL || field == NULL || s == NULL) {
+        free(sources);
+        free(field);
+        solver_cleanup(s);
+
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) sources[i] = maze_destination_index(m, i);
+
+    if (solver_distance_field(s, m, sources, n, field) != 0) {
+        free(field);
+        field = NULL;
+    }
+
+    free(sources);
+    solver_cleanup(s);
+
+    return field;
+}
+
+/**
+ * Writes the field as little-endian integers of 'bytes' bytes, one row of
+ * the maze after the other and one layer after the other. Unreachable
+ * cells are written as the largest value. Return 0 if successful else 1.
+ *
+ * @param m the maze.
+ * @param field the distance field.
+ * @param bytes 2 or 4.
+ * @return
+ */
+static int write_raw(const struct maze *m, const uint32_t *field,
+                     size_t bytes) {
+    int width = maze_width(m);
+    unsigned char *row = malloc(bytes * (size_t) width);
+
+    if (row == NULL) return 1;
+
+    uint32_t max = bytes == 2 ? UINT16_MAX : UINT32_MAX;
+
+    // Layers are stored one after the other, so they are written as the
+    // rows of one tall maze.
+    int64_t rows = (int64_t) maze_height(m) * maze_layers(m);
+
+    for (int64_t r = 0; r < rows; r++) {
+        for (int c = 0; c < width; c++) {
+            uint32_t value = field[r * width + c];
+
+            if (value == FIELD_UNREACHABLE) {
+                value = max;
+            } else if (value >= max) {
+                fprintf(stderr, "Distance %" PRIu32 " does not fit in %zu "
+                        "bytes\n", value, bytes);
+                free(row);
+
+                return 1;
+            }
+
+            unsigned char *out = row + (size_t) c * bytes;
+
+            for (size_t b = 0; b < bytes; b++) {
+                out[b] = (unsigned char) (value >> (8 * b));
+            }
+        }
+
+        if (fwrite(row, bytes, (size_t) width, stdout) != (size_t) width) {
+            free(row);
+
+            return 1;
+        }
+    }
+
+    free(row);
+
+    return 0;
+}
+
+/**
+ * Writes the field as a Portable Graymap (pgm) heatmap, with the layers
+ * below each other. Cells near a destination are dark, walls and
+ * unreachable cells are white. Return 0
+ * if successful else 1.
+ *
+ * @param m the maze.
+ * @param field the distance field.
+ * @return
+ */
+static int write_pgm(const struct maze *m, const uint32_t *field) {
+    uint32_t max = 0;
+    int64_t cells = maze_cells(m);
+
+    for (int64_t i = 0; i < cells; i++) {
+        if (field[i] != FIELD_UNREACHABLE && field[i] > max) max = field[i];
+    }
+
+    printf("P5\n%d %" PRId64 "\n255\n", maze_width(m),
+           (int64_t) maze_height(m) * maze_layers(m));
+
+    for (int64_t i = 0; i < cells; i++) {
+        unsigned char gray = 255;
+
+        if (field[i] != FIELD_UNREACHABLE && max > 0) {
+            gray = (unsigned char) ((uint64_t) field[i] * 254 / max);
+        } else if (field[i] != FIELD_UNREACHABLE) {
+            gray = 0;
+        }
+
+        if (putchar(gray) == EOF) return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Reads a maze and writes the distance from every cell to the nearest
+ * destination marker to stdout. By default the field is written as 32-bit
+ * little-endian integers, one row after the other, with '--u16' as 16-bit
+ * integers and with '--pgm' as a grayscale heatmap. Walls and unreachable
+ * cells get the largest integer value. With '--profile' the time and
+ * hardware counters of every phase are printed to stderr.
+ *
+ * @param argc count.
+ * @param argv array.
+ * @return
+ */
+int main(int argc, char *argv[]) {
+    struct profile *prof = NULL;
+    enum field_format format = FORMAT_U32;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--u16") == 0) {
+            format = FORMAT_U16;
+        } else if (strcmp(argv[i], "--pgm") == 0) {
+            format = FORMAT_PGM;
+        } else if (strcmp(argv[i], "--profile") == 0 && prof == NULL) {
+            prof = profile_init();
+
+            if (prof == NULL) {
+                fprintf(stderr, "Error initializing profiler\n");
+
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--profile] [--u16 | --pgm]\n",
+                    argv[0]);
+            profile_cleanup(prof);
+
+            return 1;
+        }
+    }
+
+    /* read maze */
+    profile_begin(prof);
+    struct maze *m = maze_read();
+    profile_end(prof, "maze_read");
+
+    if (!m) {
+        fprintf(stderr, "Error reading maze\n");
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    profile_begin(prof);
+
+    if (maze_build_masks(m) != 0) {
+        fprintf(stderr, "field failed\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    profile_end(prof, "maze_build_masks");
+
+    /* solve maze */
+    profile_begin(prof);
+    uint32_t *field = field_solve(m);
+    profile_end(prof, "field_solve");
+
+    if (field == NULL) {
+        fprintf(stderr, "field failed\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    /* write field */
+    profile_begin(prof);
+    int error;
+
+    if (format == FORMAT_PGM) {
+        error = write_pgm(m, field);
+    } else {
+        error = write_raw(m, field, format == FORMAT_U16 ? 2 : 4);
+    }
+    profile_end(prof, "field_write");
+
+    free(field);
+    maze_cleanup(m);
+    profile_cleanup(prof);
+    return error;
+}
@@ -0,0 +1,244 @@
+/*H**********************************************************************
+* FILENAME: maze_solver_hpa.c
+*
+* DESCRIPTION:
+*   Solving maze queries with hierarchical path planning (HPA*).
+*
+* PUBLIC FUNCTIONS:
+*   int main( argc, argv[] )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "hpa.h"
+#include "maze.h"
+#include "profile.h"
+
+/* Default number of rows and columns of a cluster. */
+#define CLUSTER_SIZE 16
+
+/**
+ * Print the result of a query.
+ *
+ * @param path_length the result of the planner.
+ */
+static void print_result(int64_t path_length) {
+    if (path_length == ERROR) {
+        printf("hpa failed\n");
+    } else if (path_length == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+    } else {
+        printf("hpa found a path of length: %" PRId64 "\n", path_length);
+    }
+}
+
+/**
+ * Load the abstraction of maze m from 'filename', or build it and save it
+ * to 'filename' if the file is missing or belongs to another maze. Without
+ * a file name the abstraction is only built.
+ *
+ * @param m the maze.
+ * @param size the cluster size.
+ * @param filename the name of the abstraction file or NULL.
+ * @param prof the profiler.
+ * @return
+ */
+static struct hpa *open_planner(const struct maze *m, int size,
+                                const char *filename, struct profile *prof) {
+    struct hpa *h = NULL;
+
+    if (filename != NULL) {
+        profile_begin(prof);
+        h = hpa_load(m, filename);
+        profile_end(prof, "hpa_load");
+
+        if (h != NULL) return h;
+    }
+
+    profile_begin(prof);
+    h = hpa_build(m, size);
+    profile_end(prof, "hpa_build");
+
+    if (h != NULL && filename != NULL) {
+        profile_begin(prof);
+
+        if (hpa_save(h, filename) != 0) {
+            fprintf(stderr, "Error writing %s\n", filename);
+        }
+
+        profile_end(prof, "hpa_save");
+    }
+
+    return h;
+}
+
+/**
+ * Answer queries, one per line with the row and column of a start and of
+ * a destination. Return 0 if every query was read else 1.
+ *
+ * @param h the planner.
+ * @param m the maze.
+ * @param prof the profiler.
+ * @return
+ */
+static int run_queries(struct hpa *h, const struct maze *m,
+                       struct profile *prof) {
+    int r1, c1, r2, c2;
+    int read;
+
+    while ((read = scanf("%d %d %d %d", &r1, &c1, &r2, &c2)) == 4) {
+        if (!maze_valid_move(m, r1, c1) || !maze_valid_move(m, r2, c2)) {
+            return 1;
+        }
+
+        profile_begin(prof);
+        int64_t path_length = hpa_query(h, maze_index(m, r1, c1),
+                                        maze_index(m, r2, c2));
+        profile_end(prof, "hpa_query");
+
+        if (prof != NULL) hpa_stats(h);
+
+        print_result(path_length);
+    }
+
+    return read != EOF;
+}
+
+/**
+ * Reads a maze and plans the path from start to destination on a cluster
+ * abstraction of '--cluster' by '--cluster' cells, then displays the maze
+ * with the path. With '--abstraction file' the abstraction is loaded from
+ * the file, or built and saved there if the file does not match the maze;
+ * a loaded abstraction keeps the cluster size it was saved with.
+ * With '--queries' the maze is followed by an empty line and one query
+ * per line with the row and column of a start and of a destination. With
+ * '--profile' the time and hardware counters of every phase and the
+ * planner statistics are printed to stderr.
+ *
+ * @param argc count.
+ * @param argv array.
+ * @return
+ */
+int main(int argc, char *argv[]) {
+    struct profile *prof = NULL;
+    const char *filename = NULL;
+    bool queries = false;
+    long size = CLUSTER_SIZE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cluster") == 0 && i + 1 < argc) {
+            size = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--abstraction") == 0 && i + 1 < argc) {
+            filename = argv[++i];
+        } else if (strcmp(argv[i], "--queries") == 0) {
+            queries = true;
+        } else if (strcmp(argv[i], "--profile") == 0 && prof == NULL) {
+            prof = profile_init();
+
+            if (prof == NULL) {
+                fprintf(stderr, "Error initializing profiler\n");
+
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--profile] [--queries] [--cluster n] "
+                    "[--abstraction file]\n", argv[0]);
+            profile_cleanup(prof);
+
+            return 1;
+        }
+    }
+
+    if (size < 2 || size > 4096) {
+        fprintf(stderr, "The cluster size must be between 2 and 4096\n");
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    /* read maze */
+    profile_begin(prof);
+    struct maze *m = maze_read();
+    profile_end(prof, "maze_read");
+
+    if (!m) {
+        printf("Error reading maze\n");
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    struct hpa *h = open_planner(m, (int) size, filename, prof);
+
+    if (h == NULL) {
+        printf("hpa failed\n");
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    if (queries) {
+        int error = run_queries(h, m, prof);
+
+        if (error) fprintf(stderr, "Error reading query\n");
+
+        hpa_cleanup(h);
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return error;
+    }
+
+    /* solve maze */
+    int row, col;
+
+    maze_start(m, &row, &col);
+    int64_t start = maze_index(m, row, col);
+
+    maze_destination(m, &row, &col);
+    int64_t finish = maze_index(m, row, col);
+
+    profile_begin(prof);
+    int64_t path_length = hpa_query(h, start, finish);
+    profile_end(prof, "hpa_query");
+
+    if (prof != NULL) hpa_stats(h);
+
+    print_result(path_length);
+
+    if (path_length < 0) {
+        hpa_cleanup(h);
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    profile_begin(prof);
+    int error = hpa_mark_path(h, m);
+    profile_end(prof, "hpa_mark_path");
+
+    /* print maze */
+    profile_begin(prof);
+    maze_print(m, false);
+    profile_end(prof, "maze_print");
+
+    profile_begin(prof);
+    maze_output_ppm(m, "out.ppm");
+    profile_end(prof, "maze_output_ppm");
+
+    hpa_cleanup(h);
+    maze_cleanup(m);
+    profile_cleanup(prof);
+    return error;
+}
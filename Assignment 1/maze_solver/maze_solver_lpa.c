@@ -0,0 +1,180 @@
+/*H**********************************************************************
+* FILENAME: maze_solver_lpa.c
+*
+* DESCRIPTION:
+*   Re-planning a maze path after cells change, using Lifelong Planning A*.
+*
+* PUBLIC FUNCTIONS:
+*   int main( argc, argv[] )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+// Needed for getline()
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "maze.h"
+#include "profile.h"
+#include "solver_lpa.h"
+
+/* Maximum number of cells toggled by one update line. */
+#define MAX_TOGGLES 4096
+
+/**
+ * Print the result of a plan.
+ *
+ * @param path_length the result of the planner.
+ */
+static void print_result(int64_t path_length) {
+    if (path_length == ERROR) {
+        printf("lpa failed\n");
+    } else if (path_length == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+    } else {
+        printf("lpa found a path of length: %" PRId64 "\n", path_length);
+    }
+}
+
+/**
+ * Parse the row and column pairs on one line into cell indices.
+ * Return the number of cells or -1 if the line is malformed.
+ *
+ * @param m the maze.
+ * @param line the input line.
+ * @param cells array for the cell indices.
+ * @return
+ */
+static long parse_cells(const struct maze *m, const char *line,
+                        int64_t *cells) {
+    long n = 0;
+    char *end;
+
+    while (true) {
+        long row = strtol(line, &end, 10);
+
+        if (end == line) break;
+
+        line = end;
+        long col = strtol(line, &end, 10);
+
+        if (end == line || n == MAX_TOGGLES) return -1;
+        if (row < 0 || row >= maze_height(m) || col < 0
+            || col >= maze_width(m)) {
+            return -1;
+        }
+
+        cells[n++] = maze_index(m, (int) row, (int) col);
+        line = end;
+    }
+
+    return n;
+}
+
+/**
+ * Reads a maze, an empty line and then one line per update with the row
+ * and column of every cell that toggles between wall and floor. The path
+ * is repaired and its length printed after every update, and the final
+ * path is displayed at the end.
+ *
+ * @param argc count.
+ * @param argv array.
+ * @return
+ */
+int main(int argc, char *argv[]) {
+    struct profile *prof = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0 && prof == NULL) {
+            prof = profile_init();
+
+            if (prof == NULL) {
+                fprintf(stderr, "Error initializing profiler\n");
+
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--profile]\n", argv[0]);
+            profile_cleanup(prof);
+
+            return 1;
+        }
+    }
+
+    /* read maze */
+    struct maze *m = maze_read();
+
+    if (!m) {
+        printf("Error reading maze\n");
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    struct solver_lpa *p = solver_lpa_init(m);
+    int64_t *cells = malloc(sizeof(int64_t) * MAX_TOGGLES);
+
+    if (p == NULL || cells == NULL) {
+        printf("lpa failed\n");
+        free(cells);
+        solver_lpa_cleanup(p);
+        maze_cleanup(m);
+        profile_cleanup(prof);
+
+        return 1;
+    }
+
+    /* initial plan */
+    profile_begin(prof);
+    int64_t path_length = solver_lpa_solve(p);
+    profile_end(prof, "solver_lpa_solve");
+
+    if (prof != NULL) solver_lpa_stats(p);
+
+    print_result(path_length);
+
+    /* re-plan after every update */
+    char *line = NULL;
+    size_t linesize = 0;
+    int error = 0;
+
+    while (path_length != ERROR && getline(&line, &linesize, stdin) != -1) {
+        long n = parse_cells(m, line, cells);
+
+        if (n < 0) {
+            fprintf(stderr, "Error reading update: %s", line);
+            error = 1;
+            break;
+        }
+
+        profile_begin(prof);
+        path_length = solver_update_cells(p, cells, (size_t) n);
+        profile_end(prof, "solver_update_cells");
+
+        if (prof != NULL) solver_lpa_stats(p);
+
+        print_result(path_length);
+    }
+
+    free(line);
+    free(cells);
+
+    if (path_length >= 0 && !error) {
+        solver_lpa_mark_path(p);
+        maze_print(m, false);
+    }
+
+    solver_lpa_cleanup(p);
+    maze_cleanup(m);
+    profile_cleanup(prof);
+
+    return error || path_length < 0;
+}
@@ -0,0 +1,258 @@
+/*H**********************************************************************
+* FILENAME: packed.c
+*
+* DESCRIPTION:
+*   Packed binary maze files with one bit per cell.
+*
+* PUBLIC FUNCTIONS:
+*   int packed_convert( in, filename )
+*   struct packed *packed_open( filename )
+*   void packed_close( p )
+*   int packed_width( p )
+*   int packed_height( p )
+*   int64_t packed_start( p )
+*   int64_t packed_destination( p )
+*   size_t packed_row_bytes( p )
+*   int packed_read_row( p, r, bits )
+*   bool packed_open_cell( bits, c )
+*   uint64_t packed_bytes_read( p )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+// Needed for getline() and fseeko()
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "maze.h"
+#include "packed.h"
+
+#define MAGIC "MZB1"
+
+/* Size of the header: magic, width, height, start and destination. */
+#define HEADER_BYTES (4 + 2 * sizeof(int32_t) + 2 * sizeof(int64_t))
+
+struct packed {
+    FILE *fp;
+    int32_t width;
+    int32_t height;
+    int64_t start;
+    int64_t finish;
+    size_t row_bytes;
+    int next_row;
+    uint64_t bytes_read;
+};
+
+/**
+ * Write the header of a packed maze. Return 0 if successful else 1.
+ *
+ * @param fp the file.
+ * @param width the number of columns.
+ * @param height the number of rows.
+ * @param start index of the start location.
+ * @param finish index of the destination.
+ * @return
+ */
+static int write_header(FILE *fp, int32_t width, int32_t height,
+                        int64_t start, int64_t finish) {
+    return fwrite(MAGIC, 1, 4, fp) != 4
+           || fwrite(&width, sizeof(int32_t), 1, fp) != 1
+           || fwrite(&height, sizeof(int32_t), 1, fp) != 1
+           || fwrite(&start, sizeof(int64_t), 1, fp) != 1
+           || fwrite(&finish, sizeof(int64_t), 1, fp) != 1;
+}
+
+/**
+ * Convert a text maze to a packed maze file, one line at a time.
+ *
+ * @param in the text maze.
+ * @param filename the name of the packed file.
+ * @return
+ */
+int packed_convert(FILE *in, const char *filename) {
+    if (in == NULL || filename == NULL) return 1;
+
+    char *buf = NULL;
+    size_t bufsize = 0;
+    ssize_t len = getline(&buf, &bufsize, in);
+
+    if (len < 2 || len - 1 > INT32_MAX || buf[len - 1] != '\n') {
+        free(buf);
+
+        return 1;
+    }
+
+    int32_t width = (int32_t) (len - 1);
+    size_t row_bytes = ((size_t) width + 7) / 8;
+    unsigned char *bits = malloc(row_bytes);
+    FILE *fp = fopen(filename, "wb");
+
+    if (bits == NULL || fp == NULL) {
+        free(buf);
+        free(bits);
+
+        if (fp != NULL) fclose(fp);
+
+        return 1;
+    }
+
+    // The height, start and destination are known at the end.
+    int error = write_header(fp, width, 0, width + 1, -1);
+    int32_t height = 0;
+    int64_t start = width + 1; // upper left
+    int64_t finish = -1;
+
+    while (!error && len == width + 1) {
+        memset(bits, 0, row_bytes);
+
+        for (int32_t c = 0; c < width; c++) {
+            int64_t index = (int64_t) height * width + c;
+
+            if (buf[c] == 'S') start = index;
+            if (buf[c] == 'D') finish = index;
+            if (buf[c] != WALL) bits[c / 8] |= (unsigned char) (1u << (c % 8));
+        }
+
+        error = fwrite(bits, 1, row_bytes, fp) != row_bytes
+                || height == INT32_MAX;
+        height++;
+        len = getline(&buf, &bufsize, in);
+    }
+
+    // The maze ends at the end of the input or at an empty line.
+    if (len != -1 && !(len == 1 && buf[0] == '\n')) error = 1;
+
+    if (finish < 0) {
+        finish = (int64_t) (height - 2) * width + width - 2; // lower right
+    }
+
+    if (!error && (fseeko(fp, 0, SEEK_SET) != 0
+                   || write_header(fp, width, height, start, finish) != 0)) {
+        error = 1;
+    }
+
+    if (fclose(fp) != 0) error = 1;
+
+    free(buf);
+    free(bits);
+
+    return error;
+}
+
+/**
+ * Open a packed maze file and read its header.
+ *
+ * @param filename the name of the file.
+ * @return
+ */
+struct packed *packed_open(const char *filename) {
+    if (filename == NULL) return NULL;
+
+    struct packed *p = malloc(sizeof(struct packed));
+
+    if (p == NULL) return NULL;
+
+    p->fp = fopen(filename, "rb");
+
+    char magic[4];
+
+    if (p->fp == NULL || fread(magic, 1, 4, p->fp) != 4
+        || memcmp(magic, MAGIC, 4) != 0
+        || fread(&p->width, sizeof(int32_t), 1, p->fp) != 1
+        || fread(&p->height, sizeof(int32_t), 1, p->fp) != 1
+        || fread(&p->start, sizeof(int64_t), 1, p->fp) != 1
+        || fread(&p->finish, sizeof(int64_t), 1, p->fp) != 1
+        || p->width < 1 || p->height < 1 || p->start < 0 || p->finish < 0
+        || p->start >= (int64_t) p->width * p->height
+        || p->finish >= (int64_t) p->width * p->height) {
+        packed_close(p);
+
+        return NULL;
+    }
+
+    p->row_bytes = ((size_t) p->width + 7) / 8;
+    p->next_row = 0;
+    p->bytes_read = 0;
+
+    return p;
+}
+
+/**
+ * Close the file and free the handle.
+ *
+ * @param p the packed maze.
+ */
+void packed_close(struct packed *p) {
+    if (p == NULL) return;
+
+    if (p->fp != NULL) fclose(p->fp);
+
+    free(p);
+}
+
+int packed_width(const struct packed *p) {
+    return p->width;
+}
+
+int packed_height(const struct packed *p) {
+    return p->height;
+}
+
+int64_t packed_start(const struct packed *p) {
+    return p->start;
+}
+
+int64_t packed_destination(const struct packed *p) {
+    return p->finish;
+}
+
+size_t packed_row_bytes(const struct packed *p) {
+    return p->row_bytes;
+}
+
+/**
+ * Read one packed row. Rows are usually read in order, so the file is
+ * only repositioned when a row is skipped or read again.
+ *
+ * @param p the packed maze.
+ * @param r the row.
+ * @param bits buffer of packed_row_bytes() bytes.
+ * @return
+ */
+int packed_read_row(struct packed *p, int r, unsigned char *bits) {
+    if (p == NULL || bits == NULL) return 1;
+
+    if (r < 0 || r >= p->height) {
+        memset(bits, 0, p->row_bytes);
+
+        return 0;
+    }
+
+    if (r != p->next_row) {
+        off_t offset = (off_t) HEADER_BYTES + (off_t) r * (off_t) p->row_bytes;
+
+        if (fseeko(p->fp, offset, SEEK_SET) != 0) return 1;
+    }
+
+    if (fread(bits, 1, p->row_bytes, p->fp) != p->row_bytes) return 1;
+
+    p->next_row = r + 1;
+    p->bytes_read += p->row_bytes;
+
+    return 0;
+}
+
+bool packed_open_cell(const unsigned char *bits, int c) {
+    return (bits[c / 8] >> (c % 8)) & 1;
+}
+
+uint64_t packed_bytes_read(const struct packed *p) {
+    return p->bytes_read;
+}
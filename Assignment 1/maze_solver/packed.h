@@ -0,0 +1,56 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Handle to a maze in the packed binary format, opened for reading.
+ *
+ * A packed maze file starts with the four bytes "MZB1", the width and
+ * height as 32-bit integers and the start and destination indices as
+ * 64-bit integers, all in the byte order of the machine that wrote it.
+ * The rows follow from top to bottom, every row packed in
+ * packed_row_bytes() bytes with one bit per cell: bit (c % 8) of byte
+ * (c / 8) is set if column c can be walked on. Only the rows that are
+ * needed have to be in memory. */
+struct packed;
+
+/* Converts the text maze read from 'in' to the packed format and writes
+ * it to the file 'filename'. The text is read one line at a time, so the
+ * maze does not have to fit in memory. The text follows the rules of
+ * maze_read(): the maze ends at the end of the input or an empty line.
+ * Mazes with more than one layer cannot be packed.
+ * Returns 0 if successful, 1 otherwise. */
+int packed_convert(FILE *in, const char *filename);
+
+/* Return a pointer to the packed maze in the file 'filename' if
+ * successful, otherwise return NULL. */
+struct packed *packed_open(const char *filename);
+
+/* Closes the file and frees the handle. */
+void packed_close(struct packed *p);
+
+/* Returns the number of columns of the maze. */
+int packed_width(const struct packed *p);
+
+/* Returns the number of rows of the maze. */
+int packed_height(const struct packed *p);
+
+/* Returns the index of the start location, row * width + column. */
+int64_t packed_start(const struct packed *p);
+
+/* Returns the index of the destination. */
+int64_t packed_destination(const struct packed *p);
+
+/* Returns the number of bytes of one packed row. */
+size_t packed_row_bytes(const struct packed *p);
+
+/* Reads row 'r' into 'bits', which must hold packed_row_bytes() bytes.
+ * Rows outside the maze are read as walls.
+ * Returns 0 if successful, 1 otherwise. */
+int packed_read_row(struct packed *p, int r, unsigned char *bits);
+
+/* Returns true if column 'c' of the packed row 'bits' can be walked on. */
+bool packed_open_cell(const unsigned char *bits, int c);
+
+/* Returns the number of bytes read from the file by packed_read_row(). */
+uint64_t packed_bytes_read(const struct packed *p);
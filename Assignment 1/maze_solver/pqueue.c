@@ -0,0 +1,298 @@
+/*H**********************************************************************
+* FILENAME: pqueue.c
+*
+* DESCRIPTION:
+*   Indexed binary min-heap of maze cells.
+*
+* PUBLIC FUNCTIONS:
+*   struct pqueue *pqueue_init( cells )
+*   void pqueue_cleanup( q )
+*   int pqueue_push( q, index, k1, k2 )
+*   int64_t pqueue_pop( q )
+*   int pqueue_top_key( q, k1, k2 )
+*   void pqueue_remove( q, index )
+*   bool pqueue_contains( q, index )
+*   void pqueue_clear( q )
+*   size_t pqueue_size( q )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pqueue.h"
+
+#define NOT_QUEUED (-1)
+
+struct entry {
+    int64_t k1;
+    int64_t k2;
+    int64_t index;
+};
+
+struct pqueue {
+    struct entry *heap;
+    int64_t *position;
+    size_t size;
+    size_t cells;
+};
+
+/**
+ * Reserve bytes in memory for the priority queue and the position map.
+ *
+ * @param cells the number of cells that can be queued.
+ * @return
+ */
+struct pqueue *pqueue_init(size_t cells) {
+    struct pqueue *q = malloc(sizeof(struct pqueue));
+
+    if (q == NULL) return NULL;
+
+    q->heap = malloc(sizeof(struct entry) * (cells ? cells : 1));
+    q->position = malloc(sizeof(int64_t) * (cells ? cells : 1));
+
+    if (q->heap == NULL || q->position == NULL) {
+        free(q->heap);
+        free(q->position);
+        free(q);
+
+        return NULL;
+    }
+
+    for (size_t i = 0; i < cells; i++) q->position[i] = NOT_QUEUED;
+
+    q->size = 0;
+    q->cells = cells;
+
+    return q;
+}
+
+/**
+ * Free memory from priority queue and sub variables.
+ *
+ * @param q the priority queue.
+ */
+void pqueue_cleanup(struct pqueue *q) {
+    if (q == NULL) return;
+
+    free(q->heap);
+    free(q->position);
+
+    free(q);
+}
+
+/**
+ * Return true if entry a has a smaller key than entry b.
+ *
+ * @param a the first entry.
+ * @param b the second entry.
+ * @return
+ */
+static bool entry_less(const struct entry *a, const struct entry *b) {
+    return a->k1 < b->k1 || (a->k1 == b->k1 && a->k2 < b->k2);
+}
+
+/**
+ * Store entry e at heap slot i and update the position map.
+ *
+ * @param q the priority queue.
+ * @param i the heap slot.
+ * @param e the entry.
+ */
+static void place(struct pqueue *q, size_t i, struct entry e) {
+    q->heap[i] = e;
+    q->position[e.index] = (int64_t) i;
+}
+
+/**
+ * Move the entry at heap slot i up until its parent is smaller.
+ *
+ * @param q the priority queue.
+ * @param i the heap slot.
+ */
+static void sift_up(struct pqueue *q, size_t i) {
+    struct entry e = q->heap[i];
+
+    while (i > 0 && entry_less(&e, &q->heap[(i - 1) / 2])) {
+        place(q, i, q->heap[(i - 1) / 2]);
+        i = (i - 1) / 2;
+    }
+
+    place(q, i, e);
+}
+
+/**
+ * Move the entry at heap slot i down until its children are larger.
+ *
+ * @param q the priority queue.
+ * @param i the heap slot.
+ */
+static void sift_down(struct pqueue *q, size_t i) {
+    struct entry e = q->heap[i];
+
+    while (2 * i + 1 < q->size) {
+        size_t child = 2 * i + 1;
+
+        if (child + 1 < q->size
+            && entry_less(&q->heap[child + 1], &q->heap[child])) {
+            child++;
+        }
+
+        if (!entry_less(&q->heap[child], &e)) break;
+
+        place(q, i, q->heap[child]);
+        i = child;
+    }
+
+    place(q, i, e);
+}
+
+/**
+ * Insert a cell or change the key of a queued cell. Return 0 if successful
+ * else 1.
+ *
+ * @param q the priority queue.
+ * @param index the cell.
+ * @param k1 the primary key.
+ * @param k2 the secondary key.
+ * @return
+ */
+int pqueue_push(struct pqueue *q, int64_t index, int64_t k1, int64_t k2) {
+    if (q == NULL || index < 0 || (size_t) index >= q->cells) return 1;
+
+    struct entry e = { k1, k2, index };
+
+    if (q->position[index] != NOT_QUEUED) {
+        size_t i = (size_t) q->position[index];
+        bool smaller = entry_less(&e, &q->heap[i]);
+
+        q->heap[i] = e;
+
+        if (smaller) {
+            sift_up(q, i);
+        } else {
+            sift_down(q, i);
+        }
+
+        return 0;
+    }
+
+    q->heap[q->size] = e;
+    q->size++;
+    sift_up(q, q->size - 1);
+
+    return 0;
+}
+
+/**
+ * Remove the entry at heap slot i.
+ *
+ * @param q the priority queue.
+ * @param i the heap slot.
+ */
+static void remove_at(struct pqueue *q, size_t i) {
+    q->position[q->heap[i].index] = NOT_QUEUED;
+    q->size--;
+
+    if (i == q->size) return;
+
+    struct entry last = q->heap[q->size];
+    bool smaller = entry_less(&last, &q->heap[i]);
+
+    place(q, i, last);
+
+    if (smaller) {
+        sift_up(q, i);
+    } else {
+        sift_down(q, i);
+    }
+}
+
+/**
+ * Remove the cell with the smallest key. If empty return -1.
+ *
+ * @param q the priority queue.
+ * @return
+ */
+int64_t pqueue_pop(struct pqueue *q) {
+    if (q == NULL || q->size == 0) return -1;
+
+    int64_t index = q->heap[0].index;
+
+    remove_at(q, 0);
+
+    return index;
+}
+
+/**
+ * Get the smallest key. Return 0 if successful, 1 if empty.
+ *
+ * @param q the priority queue.
+ * @param k1 set to the primary key.
+ * @param k2 set to the secondary key.
+ * @return
+ */
+int pqueue_top_key(const struct pqueue *q, int64_t *k1, int64_t *k2) {
+    if (q == NULL || q->size == 0) return 1;
+
+    *k1 = q->heap[0].k1;
+    *k2 = q->heap[0].k2;
+
+    return 0;
+}
+
+/**
+ * Remove a cell if it is queued.
+ *
+ * @param q the priority queue.
+ * @param index the cell.
+ */
+void pqueue_remove(struct pqueue *q, int64_t index) {
+    if (!pqueue_contains(q, index)) return;
+
+    remove_at(q, (size_t) q->position[index]);
+}
+
+/**
+ * Check if a cell is queued.
+ *
+ * @param q the priority queue.
+ * @param index the cell.
+ * @return
+ */
+bool pqueue_contains(const struct pqueue *q, int64_t index) {
+    if (q == NULL || index < 0 || (size_t) index >= q->cells) return false;
+
+    return q->position[index] != NOT_QUEUED;
+}
+
+/**
+ * Empty the queue while keeping the reserved memory.
+ *
+ * @param q the priority queue.
+ */
+void pqueue_clear(struct pqueue *q) {
+    if (q == NULL) return;
+
+    for (size_t i = 0; i < q->size; i++) {
+        q->position[q->heap[i].index] = NOT_QUEUED;
+    }
+
+    q->size = 0;
+}
+
+/**
+ * Return the number of queued cells.
+ *
+ * @param q the priority queue.
+ * @return
+ */
+size_t pqueue_size(const struct pqueue *q) {
+    if (q == NULL) return 0;
+
+    return q->size;
+}
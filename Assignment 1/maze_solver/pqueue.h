@@ -0,0 +1,41 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Handle to an indexed priority queue of maze cells. Every cell index is
+ * at most once in the queue, with a key of two integers that are compared
+ * lexicographically. The key of a queued cell can be changed and a cell can
+ * be removed in O(log n). */
+struct pqueue;
+
+/* Return a pointer to a priority queue for cell indices in the range
+ * [0, 'cells') if successful, otherwise return NULL. */
+struct pqueue *pqueue_init(size_t cells);
+
+/* Cleanup priority queue. */
+void pqueue_cleanup(struct pqueue *q);
+
+/* Insert cell 'index' with key ('k1', 'k2'), or change its key if the cell
+ * is already queued.
+ * Return 0 if successful, 1 otherwise. */
+int pqueue_push(struct pqueue *q, int64_t index, int64_t k1, int64_t k2);
+
+/* Remove the cell with the smallest key and return it.
+ * Return the cell index if successful, -1 otherwise. */
+int64_t pqueue_pop(struct pqueue *q);
+
+/* Set 'k1' and 'k2' to the smallest key in the queue.
+ * Return 0 if successful, 1 if the queue is empty. */
+int pqueue_top_key(const struct pqueue *q, int64_t *k1, int64_t *k2);
+
+/* Remove cell 'index' from the queue if it is queued. */
+void pqueue_remove(struct pqueue *q, int64_t index);
+
+/* Return true if cell 'index' is queued. */
+bool pqueue_contains(const struct pqueue *q, int64_t index);
+
+/* Remove all cells from the queue without releasing its memory. */
+void pqueue_clear(struct pqueue *q);
+
+/* Return the number of cells in the queue. */
+size_t pqueue_size(const struct pqueue *q);
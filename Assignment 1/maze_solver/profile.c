@@ -0,0 +1,168 @@
+/*H**********************************************************************
+* FILENAME: profile.c
+*
+* DESCRIPTION:
+*   Per-phase wall time and hardware counter profiling for the solvers.
+*
+* PUBLIC FUNCTIONS:
+*   struct profile *profile_init(void)
+*   void profile_cleanup( p )
+*   void profile_begin( p )
+*   void profile_end( p, phase )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+// Needed for syscall() and clock_gettime()
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "profile.h"
+
+#define N_COUNTERS 3
+
+struct profile {
+    int fds[N_COUNTERS];
+    struct timespec start;
+};
+
+#ifdef __linux__
+/* Hardware events in the order they are printed. */
+static const unsigned long long events[N_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES
+};
+
+/**
+ * Open a disabled user space counter for this process.
+ *
+ * @param config the hardware event.
+ * @return file descriptor or -1 if the counter is unavailable.
+ */
+static int open_counter(unsigned long long config) {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/**
+ * Reserve bytes in memory for the profiler and open the counters.
+ *
+ * @return
+ */
+struct profile *profile_init(void) {
+    struct profile *p = malloc(sizeof(struct profile));
+
+    if (p == NULL) return NULL;
+
+    for (int i = 0; i < N_COUNTERS; i++) {
+#ifdef __linux__
+        p->fds[i] = open_counter(events[i]);
+#else
+        p->fds[i] = -1;
+#endif
+    }
+
+    p->start.tv_sec = 0;
+    p->start.tv_nsec = 0;
+
+    return p;
+}
+
+/**
+ * Close the counters and free memory from the profiler.
+ *
+ * @param p the profiler.
+ */
+void profile_cleanup(struct profile *p) {
+    if (p == NULL) return;
+
+#ifdef __linux__
+    for (int i = 0; i < N_COUNTERS; i++) {
+        if (p->fds[i] >= 0) close(p->fds[i]);
+    }
+#endif
+
+    free(p);
+}
+
+/**
+ * Reset and start the counters and the monotonic clock.
+ *
+ * @param p the profiler.
+ */
+void profile_begin(struct profile *p) {
+    if (p == NULL) return;
+
+#ifdef __linux__
+    for (int i = 0; i < N_COUNTERS; i++) {
+        if (p->fds[i] < 0) continue;
+
+        ioctl(p->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(p->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+
+    clock_gettime(CLOCK_MONOTONIC, &p->start);
+}
+
+/**
+ * Stop the counters and print the statistics of the phase.
+ *
+ * @param p the profiler.
+ * @param phase name of the measured phase.
+ */
+void profile_end(struct profile *p, const char *phase) {
+    if (p == NULL) return;
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long long counts[N_COUNTERS];
+
+    for (int i = 0; i < N_COUNTERS; i++) {
+        counts[i] = -1;
+
+#ifdef __linux__
+        if (p->fds[i] < 0) continue;
+
+        unsigned long long value;
+
+        ioctl(p->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        if (read(p->fds[i], &value, sizeof(value)) == (ssize_t) sizeof(value)) {
+            counts[i] = (long long) value;
+        }
+#endif
+    }
+
+    double seconds = (double) (end.tv_sec - p->start.tv_sec)
+                     + (double) (end.tv_nsec - p->start.tv_nsec) / 1e9;
+
+    fprintf(stderr, "profile %s %.6f %lld %lld %lld\n", phase, seconds,
+            counts[0], counts[1], counts[2]);
+}
@@ -0,0 +1,19 @@
+/* Handle to a phase profiler. */
+struct profile;
+
+/* Return a pointer to a profiler if successful, otherwise return NULL.
+ * Hardware counters are opened through perf_event_open when available;
+ * counters that cannot be opened are reported as -1. */
+struct profile *profile_init(void);
+
+/* Cleanup profiler. */
+void profile_cleanup(struct profile *p);
+
+/* Start measuring a phase. Does nothing if 'p' is NULL. */
+void profile_begin(struct profile *p);
+
+/* Stop measuring the current phase and print its statistics to stderr.
+ * The format is: 'profile' phase wall_seconds cycles instructions llc_misses
+ * Does nothing if 'p' is NULL. */
+void profile_end(struct profile *p, const char *phase);
+
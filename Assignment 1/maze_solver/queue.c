@@ -9,8 +9,8 @@
 *   void queue_cleanup( q )
 *   void queue_stats( q )
 *   int queue_push( q, c )
-*   int queue_pop( q )
-*   int queue_peek( q )
+*   int64_t queue_pop( q )
+*   int64_t queue_peek( q )
 *   int queue_empty( q )
 *   size_t queue_size( q )
 *
@@ -20,15 +20,16 @@
 *
 *H*/
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "queue.h"
 
 struct queue {
-    int *data;
-    int pushes;
-    int pops;
+    int64_t *data;
+    size_t pushes;
+    size_t pops;
     size_t first_in_line;
     size_t length;
     size_t capacity;
@@ -46,7 +47,7 @@ struct queue *queue_init(size_t capacity) {
 
     if (qu == NULL) return NULL;
 
-    qu->data = malloc(sizeof(int) * capacity);
+    qu->data = malloc(sizeof(int64_t) * capacity);
 
     if (qu->data == NULL) {
         queue_cleanup(qu);
@@ -84,7 +85,9 @@ void queue_cleanup(struct queue *q) {
 void queue_stats(const struct queue *q) {
     if (q == NULL) return;
 
-    fprintf(stderr,"stats %d %d %d\n", q->pushes, q->pops, abs(q->pops - (int) q->length));
+    size_t max = q->pops > q->length ? q->pops - q->length : q->length - q->pops;
+
+    fprintf(stderr,"stats %zu %zu %zu\n", q->pushes, q->pops, max);
 }
 
 /**
@@ -94,12 +97,12 @@ void queue_stats(const struct queue *q) {
  * @param c the character pushed into the queue.
  * @return
  */
-int queue_push(struct queue *q, int c) {
+int queue_push(struct queue *q, int64_t c) {
     if (q == NULL) return 1;
 
     // If size is going to exceed, add more memory.
     if ((q->length + 1) >= q->capacity) {
-        int *temp = realloc(q->data, sizeof(int) * ((q->length + 1) * 2));
+        int64_t *temp = realloc(q->data, sizeof(int64_t) * ((q->length + 1) * 2));
 
         if (temp == NULL) return 0;
 
@@ -132,12 +135,12 @@ int queue_push(struct queue *q, int c) {
  * @param q the queue.
  * @return
  */
-int queue_pop(struct queue *q) {
+int64_t queue_pop(struct queue *q) {
     if (q == NULL) return -1;
 
     if (q->length == 0) return -1;
 
-    int first_character = q->data[q->first_in_line];
+    int64_t first_character = q->data[q->first_in_line];
 
     q->data[q->first_in_line] = '\0';
 
@@ -154,7 +157,7 @@ int queue_pop(struct queue *q) {
  * @param q the queue.
  * @return
  */
-int queue_peek(const struct queue *q) {
+int64_t queue_peek(const struct queue *q) {
     if (q == NULL) return -1;
     if (q->length == 0) return -1;
 
@@ -175,6 +178,18 @@ int queue_empty(const struct queue *q) {
     return -1;
 }
 
+/**
+ * Empty the queue while keeping the reserved memory.
+ *
+ * @param q the queue.
+ */
+void queue_clear(struct queue *q) {
+    if (q == NULL) return;
+
+    q->first_in_line = 0;
+    q->length = 0;
+}
+
 /**
  * Return the current length of the queue.
  *
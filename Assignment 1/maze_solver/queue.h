@@ -1,5 +1,6 @@
 /* Do not edit this file. */
 #include <stddef.h>
+#include <stdint.h>
 
 /* Handle to queue */
 struct queue;
@@ -17,19 +18,23 @@ void queue_stats(const struct queue *q);
 
 /* Push item the end of the queue.
  * Return 0 if successful, 1 otherwise. */
-int queue_push(struct queue *q, int e);
+int queue_push(struct queue *q, int64_t e);
 
 /* Remove the first item from queue and return it.
  * Return the first item if successful, -1 otherwise. */
-int queue_pop(struct queue *q);
+int64_t queue_pop(struct queue *q);
 
 /* Return the first item from queue. Leave queue unchanged.
  * Return the first item if successful, -1 otherwise. */
-int queue_peek(const struct queue *q);
+int64_t queue_peek(const struct queue *q);
 
 /* Return 1 if queue is empty, 0 if the queue contains any elements and
  * return -1 if the operation fails. */
 int queue_empty(const struct queue *q);
 
+/* Remove all items from the queue without releasing its memory, so the
+ * queue can be reused. The statistics are not reset. */
+void queue_clear(struct queue *q);
+
 /* Return the number of elements stored in the queue. */
 size_t queue_size(const struct queue *q);
@@ -0,0 +1,431 @@
+/*H**********************************************************************
+* FILENAME: sharded.c
+*
+* DESCRIPTION:
+*   Breadth-first search with the maze split into bands of rows, each
+*   searched by its own worker thread.
+*
+* PUBLIC FUNCTIONS:
+*   int64_t sharded_bfs( m, bands, report )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+// Needed for pthread barriers
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "containers.h"
+#include "sharded.h"
+
+/* Initial number of messages in a mailbox. */
+#define MAILBOX_CAPACITY 64
+
+/* A message asks the owner of a cell to visit it from a parent cell. */
+struct message {
+    int64_t cell;
+    int64_t parent;
+};
+
+DEFINE_QUEUE(mailbox, struct message)
+
+/* Growable list of cell indices. */
+struct list {
+    int64_t *items;
+    size_t size;
+    size_t capacity;
+};
+
+/* A band owns the cells with an index in [lo, hi). Its outbox holds one
+ * mailbox per band with the messages sent during the current level; a
+ * mailbox is only written by its sender before the first barrier of a
+ * level and only read by its receiver between the two barriers. The
+ * counts are published between the barriers for the other workers. */
+struct band {
+    struct sharded *sh;
+    size_t id;
+    int64_t lo;
+    int64_t hi;
+    struct list frontier;
+    struct list next;
+    struct mailbox **outbox;
+    size_t new_cells;
+    size_t received;
+    bool found;
+    bool error;
+};
+
+struct sharded {
+    const struct maze *m;
+    const uint8_t *masks;
+    int64_t steps[N_MOVES_3D];
+    int64_t *prev;
+    int64_t start;
+    int64_t finish;
+    int64_t rows;
+    size_t n_bands;
+    struct band *bands;
+    pthread_barrier_t delivered;
+    pthread_barrier_t counted;
+    pthread_mutex_t lock;
+    pthread_cond_t gate;
+    bool started;
+    bool cancelled;
+    FILE *report;
+    int64_t result;
+};
+
+/**
+ * Append cell i to list l, doubling its capacity when it is full.
+ * Return 0 if successful else 1.
+ *
+ * @param l the list.
+ * @param i the cell.
+ * @return
+ */
+static int append(struct list *l, int64_t i) {
+    if (l->size == l->capacity) {
+        size_t capacity = l->capacity ? l->capacity * 2 : 1024;
+        int64_t *grown = realloc(l->items, sizeof(int64_t) * capacity);
+
+        if (grown == NULL) return 1;
+
+        l->items = grown;
+        l->capacity = capacity;
+    }
+
+    l->items[l->size++] = i;
+
+    return 0;
+}
+
+/**
+ * Get the band that owns cell i. Band b starts at row b * rows / bands.
+ *
+ * @param sh the search.
+ * @param i the cell.
+ * @return
+ */
+static size_t owner(const struct sharded *sh, int64_t i) {
+    int64_t row = i / maze_width(sh->m);
+
+    return (size_t) (((row + 1) * (int64_t) sh->n_bands - 1) / sh->rows);
+}
+
+/**
+ * Visit cell i of band b from cell parent, if it was not visited yet.
+ * Return 0 if successful else 1.
+ *
+ * @param b the band that owns cell i.
+ * @param i the cell.
+ * @param parent the cell it is reached from.
+ * @return
+ */
+static int visit(struct band *b, int64_t i, int64_t parent) {
+    if (b->sh->prev[i] >= 0) return 0;
+
+    b->sh->prev[i] = parent;
+
+    return append(&b->next, i);
+}
+
+/**
+ * Expand the frontier of band b. Neighbours in the band are visited
+ * directly, the others are sent to the mailbox of their band.
+ * Return 0 if successful else 1.
+ *
+ * @param b the band.
+ * @return
+ */
+static int expand(struct band *b) {
+    const struct sharded *sh = b->sh;
+
+    for (size_t k = 0; k < b->frontier.size; k++) {
+        int64_t current = b->frontier.items[k];
+        unsigned moves = sh->masks != NULL ? sh->masks[current]
+                                           : maze_open_moves(sh->m, current);
+
+        while (moves != 0) {
+            int64_t next = current + sh->steps[__builtin_ctz(moves)];
+
+            moves &= moves - 1;
+
+            if (next >= b->lo && next < b->hi) {
+                if (visit(b, next, current) != 0) return 1;
+            } else {
+                struct message msg = { next, current };
+
+                if (mailbox_push(b->outbox[owner(sh, next)], msg) != 0) {
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Visit the cells in the mailboxes of every band addressed to band b and
+ * empty them. Return 0 if successful else 1.
+ *
+ * @param b the band.
+ * @return
+ */
+static int deliver(struct band *b) {
+    b->received = 0;
+
+    for (size_t s = 0; s < b->sh->n_bands; s++) {
+        struct mailbox *mailbox = b->sh->bands[s].outbox[b->id];
+        struct message msg;
+
+        while (mailbox_pop(mailbox, &msg) == 0) {
+            if (visit(b, msg.cell, msg.parent) != 0) return 1;
+
+            b->received++;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Worker thread of one band. Every level the band expands its frontier,
+ * waits until all messages are sent, takes its own messages and publishes
+ * its counts. After the second barrier all workers know whether the
+ * search is over, so they stop at the same level.
+ *
+ * @param arg the band.
+ * @return
+ */
+static void *worker(void *arg) {
+    struct band *b = arg;
+    struct sharded *sh = b->sh;
+
+    // A barrier waits for every band, so no worker starts before all of
+    // them are running.
+    pthread_mutex_lock(&sh->lock);
+
+    while (!sh->started && !sh->cancelled) {
+        pthread_cond_wait(&sh->gate, &sh->lock);
+    }
+
+    bool cancelled = sh->cancelled;
+
+    pthread_mutex_unlock(&sh->lock);
+
+    if (cancelled) return NULL;
+
+    // The band writes its part of the search state first, so the pages
+    // are placed near the worker on machines with several memory nodes.
+    for (int64_t i = b->lo; i < b->hi; i++) sh->prev[i] = -1;
+
+    bool failed = false;
+
+    if (sh->start >= b->lo && sh->start < b->hi) {
+        sh->prev[sh->start] = sh->start;
+        failed = append(&b->frontier, sh->start) != 0;
+    }
+
+    for (int64_t level = 1; ; level++) {
+        if (!failed) failed = expand(b) != 0;
+
+        pthread_barrier_wait(&sh->delivered);
+
+        if (!failed) failed = deliver(b) != 0;
+
+        b->error = failed;
+        b->new_cells = b->next.size;
+        b->found = sh->finish >= b->lo && sh->finish < b->hi
+                   && sh->prev[sh->finish] >= 0;
+
+        pthread_barrier_wait(&sh->counted);
+
+        size_t cells = 0;
+        size_t messages = 0;
+        bool found = false;
+        bool error = false;
+
+        for (size_t s = 0; s < sh->n_bands; s++) {
+            cells += sh->bands[s].new_cells;
+            messages += sh->bands[s].received;
+            found = found || sh->bands[s].found;
+            error = error || sh->bands[s].error;
+        }
+
+        if (b->id == 0 && sh->report != NULL) {
+            fprintf(sh->report, "comm %" PRId64 " %zu %zu %zu\n", level,
+                    cells, messages, messages * sizeof(struct message));
+        }
+
+        struct list done = b->frontier;
+
+        b->frontier = b->next;
+        b->next = done;
+        b->next.size = 0;
+
+        if (error || found || cells == 0) {
+            if (b->id == 0) {
+                sh->result = error ? ERROR : found ? level : NOT_FOUND;
+            }
+
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Free the lists of the bands and the search state.
+ *
+ * @param sh the search.
+ */
+static void cleanup(struct sharded *sh) {
+    for (size_t i = 0; sh->bands != NULL && i < sh->n_bands; i++) {
+        struct band *b = &sh->bands[i];
+
+        free(b->frontier.items);
+        free(b->next.items);
+
+        for (size_t s = 0; b->outbox != NULL && s < sh->n_bands; s++) {
+            mailbox_cleanup(b->outbox[s]);
+        }
+
+        free(b->outbox);
+    }
+
+    free(sh->bands);
+    free(sh->prev);
+}
+
+/**
+ * Split the rows of maze m into bands. Return 0 if successful else 1.
+ *
+ * @param sh the search.
+ * @return
+ */
+static int split(struct sharded *sh) {
+    int64_t width = maze_width(sh->m);
+
+    sh->bands = calloc(sh->n_bands, sizeof(struct band));
+
+    if (sh->bands == NULL) return 1;
+
+    for (size_t i = 0; i < sh->n_bands; i++) {
+        struct band *b = &sh->bands[i];
+
+        b->sh = sh;
+        b->id = i;
+        b->lo = (int64_t) i * sh->rows / (int64_t) sh->n_bands * width;
+        b->hi = (int64_t) (i + 1) * sh->rows / (int64_t) sh->n_bands * width;
+        b->outbox = calloc(sh->n_bands, sizeof(struct mailbox *));
+
+        if (b->outbox == NULL) return 1;
+
+        for (size_t s = 0; s < sh->n_bands; s++) {
+            b->outbox[s] = mailbox_init(MAILBOX_CAPACITY);
+
+            if (b->outbox[s] == NULL) return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Search maze m on a worker thread per band and mark the path.
+ *
+ * @param m the maze.
+ * @param bands the number of bands.
+ * @param report stream for the statistics of every level or NULL.
+ * @return
+ */
+int64_t sharded_bfs(struct maze *m, size_t bands, FILE *report) {
+    if (m == NULL || bands == 0) return ERROR;
+
+    int64_t start = maze_start_index(m);
+    int64_t finish = maze_finish_index(m);
+
+    // No path starts or ends in a wall.
+    if (maze_get_index(m, start) == WALL || maze_get_index(m, finish) == WALL) {
+        return NOT_FOUND;
+    }
+
+    if (start == finish) return 0;
+
+    struct sharded sh = {
+        .m = m,
+        .masks = maze_masks(m),
+        .start = start,
+        .finish = finish,
+        .rows = maze_cells(m) / maze_width(m),
+        .n_bands = bands,
+        .report = report,
+        .result = ERROR,
+    };
+
+    // Every band holds at least one row.
+    if ((int64_t) sh.n_bands > sh.rows) sh.n_bands = (size_t) sh.rows;
+
+    for (int d = 0; d < N_MOVES_3D; d++) sh.steps[d] = maze_step(m, d);
+
+    sh.prev = malloc(sizeof(int64_t) * (size_t) maze_cells(m));
+    pthread_t *tids = malloc(sizeof(pthread_t) * sh.n_bands);
+
+    if (sh.prev == NULL || tids == NULL || split(&sh) != 0) {
+        free(tids);
+        cleanup(&sh);
+
+        return ERROR;
+    }
+
+    unsigned count = (unsigned) sh.n_bands;
+
+    pthread_barrier_init(&sh.delivered, NULL, count);
+    pthread_barrier_init(&sh.counted, NULL, count);
+    pthread_mutex_init(&sh.lock, NULL);
+    pthread_cond_init(&sh.gate, NULL);
+
+    size_t started = 0;
+
+    while (started < sh.n_bands
+           && pthread_create(&tids[started], NULL, worker,
+                             &sh.bands[started]) == 0) {
+        started++;
+    }
+
+    // Without a worker for every band the search cannot run.
+    pthread_mutex_lock(&sh.lock);
+    sh.started = started == sh.n_bands;
+    sh.cancelled = !sh.started;
+    pthread_cond_broadcast(&sh.gate);
+    pthread_mutex_unlock(&sh.lock);
+
+    for (size_t i = 0; i < started; i++) pthread_join(tids[i], NULL);
+
+    pthread_cond_destroy(&sh.gate);
+    pthread_mutex_destroy(&sh.lock);
+    pthread_barrier_destroy(&sh.counted);
+    pthread_barrier_destroy(&sh.delivered);
+
+    int64_t path_length = sh.result;
+
+    if (path_length > 0) {
+        for (int64_t i = sh.prev[finish]; i != start; i = sh.prev[i]) {
+            maze_set_index(m, i, PATH);
+        }
+    }
+
+    free(tids);
+    cleanup(&sh);
+
+    return path_length;
+}
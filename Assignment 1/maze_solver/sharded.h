@@ -0,0 +1,20 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "solver.h"
+
+/* Breadth-first search from the start to the destination of maze 'm' on
+ * 'bands' worker threads, as a local stand-in for a distributed solver.
+ * The rows of the maze, of all layers one after the other, are split into
+ * horizontal bands and every worker owns the cells and search state of
+ * one band. A worker expands the frontier of its band and sends the
+ * neighbours that lie in another band to that band through a mailbox in
+ * shared memory. The mailboxes are delivered after every level, so the
+ * workers only synchronize twice per level. The path is marked in the
+ * maze with PATH characters.
+ * If 'report' is not NULL one line is written to it per level in the
+ * format: 'comm' level num_of_cells num_of_messages bytes_sent
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t sharded_bfs(struct maze *m, size_t bands, FILE *report);
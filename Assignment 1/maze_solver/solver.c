@@ -0,0 +1,584 @@
+/*H**********************************************************************
+* FILENAME: solver.c
+*
+* DESCRIPTION:
+*   Reusable solver context for searching many mazes.
+*
+* PUBLIC FUNCTIONS:
+*   struct solver *solver_init(void)
+*   void solver_cleanup( s )
+*   int64_t solver_bfs_query( s, m, start, finish )
+*   int64_t solver_bfs( s, m )
+*   int64_t solver_dijkstra_query( s, m, start, finish )
+*   int64_t solver_dijkstra( s, m )
+*   int64_t solver_zero_one_query( s, m, start, finish )
+*   int64_t solver_zero_one( s, m )
+*   int solver_distance_field( s, m, sources, n, field )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bucketq.h"
+#include "deque.h"
+#include "queue.h"
+#include "solver.h"
+
+/* A cell counts as visited during the current search when its epoch stamp
+ * equals 'current'. Starting a new search only increments 'current'. The
+ * distances, the bucket queue and the deque are only used by weighted
+ * searches, so they are only allocated by the first weighted search. */
+struct solver {
+    uint32_t *epoch;
+    uint32_t current;
+    int64_t *prev;
+    int64_t *dist;
+    struct queue *queue;
+    struct bucketq *buckets;
+    struct deque *deque;
+    size_t capacity;
+    size_t weighted_capacity;
+};
+
+/**
+ * Reserve bytes in memory for an empty solver context.
+ *
+ * @return
+ */
+struct solver *solver_init(void) {
+    struct solver *s = malloc(sizeof(struct solver));
+
+    if (s == NULL) return NULL;
+
+    s->epoch = NULL;
+    s->current = 0;
+    s->prev = NULL;
+    s->dist = NULL;
+    s->queue = NULL;
+    s->buckets = NULL;
+    s->deque = NULL;
+    s->capacity = 0;
+    s->weighted_capacity = 0;
+
+    return s;
+}
+
+/**
+ * Free memory from solver context and sub variables.
+ *
+ * @param s the solver context.
+ */
+void solver_cleanup(struct solver *s) {
+    if (s == NULL) return;
+
+    free(s->epoch);
+    free(s->prev);
+    free(s->dist);
+    queue_cleanup(s->queue);
+    bucketq_cleanup(s->buckets);
+    deque_cleanup(s->deque);
+
+    free(s);
+}
+
+/**
+ * Make sure the buffers can hold 'cells' maze cells and start a new epoch,
+ * which resets the visited state in constant time. Memory is only
+ * reallocated if the maze is larger than any maze solved before with this
+ * context. Return 0 if successful else 1.
+ *
+ * @param s the solver context.
+ * @param cells number of cells in the maze.
+ * @return
+ */
+static int solver_reserve(struct solver *s, size_t cells) {
+    if (cells > s->capacity) {
+        uint32_t *epoch = realloc(s->epoch, sizeof(uint32_t) * cells);
+
+        if (epoch == NULL) return 1;
+
+        s->epoch = epoch;
+
+        int64_t *prev = realloc(s->prev, sizeof(int64_t) * cells);
+
+        if (prev == NULL) return 1;
+
+        s->prev = prev;
+
+        // Every cell is pushed at most once, so the queue never has to grow.
+        queue_cleanup(s->queue);
+        s->queue = queue_init(cells + 1);
+
+        if (s->queue == NULL) {
+            s->capacity = 0;
+
+            return 1;
+        }
+
+        memset(s->epoch, 0, sizeof(uint32_t) * cells);
+        s->current = 0;
+        s->capacity = cells;
+    }
+
+    // Only clear the stamps when the epoch counter wraps around.
+    if (++s->current == 0) {
+        memset(s->epoch, 0, sizeof(uint32_t) * s->capacity);
+        s->current = 1;
+    }
+
+    queue_clear(s->queue);
+
+    return 0;
+}
+
+/**
+ * Make sure the buffers of weighted searches can hold 'cells' maze cells,
+ * after solver_reserve(). Return 0 if successful else 1.
+ *
+ * @param s the solver context.
+ * @param cells number of cells in the maze.
+ * @return
+ */
+static int solver_reserve_weighted(struct solver *s, size_t cells) {
+    if (cells > s->weighted_capacity) {
+        int64_t *dist = realloc(s->dist, sizeof(int64_t) * cells);
+
+        if (dist == NULL) return 1;
+
+        s->dist = dist;
+
+        bucketq_cleanup(s->buckets);
+        s->buckets = bucketq_init(cells, MAX_WEIGHT);
+        deque_cleanup(s->deque);
+        s->deque = deque_init(cells + 1);
+
+        if (s->buckets == NULL || s->deque == NULL) {
+            s->weighted_capacity = 0;
+
+            return 1;
+        }
+
+        s->weighted_capacity = cells;
+    }
+
+    bucketq_clear(s->buckets);
+    deque_clear(s->deque);
+
+    return 0;
+}
+
+/**
+ * Mark the path from start to 'finish' with PATH characters by following
+ * the predecessor map of the last search.
+ *
+ * @param s the solver context.
+ * @param m the maze.
+ * @param start index of the start location.
+ * @param finish index of the destination.
+ * @return
+ */
+static void solver_mark_path(const struct solver *s, struct maze *m,
+                             int64_t start, int64_t finish) {
+    for (int64_t i = s->prev[finish]; i != start; i = s->prev[i]) {
+        maze_set_index(m, i, PATH);
+    }
+}
+
+/**
+ * Get the difference in index of every move, including the moves between
+ * layers.
+ *
+ * @param m the maze.
+ * @param steps array for the differences.
+ */
+static void move_steps(const struct maze *m, int64_t steps[N_MOVES_3D]) {
+    for (int d = 0; d < N_MOVES_3D; d++) steps[d] = maze_step(m, d);
+}
+
+/**
+ * Get the open-neighbour mask of cell i, from the prebuilt masks if there
+ * are any.
+ *
+ * @param m the maze.
+ * @param masks the masks of the maze or NULL.
+ * @param i the cell.
+ * @return
+ */
+static inline unsigned open_moves(const struct maze *m, const uint8_t *masks,
+                                  int64_t i) {
+    return masks != NULL ? masks[i] : maze_open_moves(m, i);
+}
+
+/**
+ * Check the endpoints of a query on maze m. Return 0 if both are open
+ * cells, NOT_FOUND if one of them is a wall and ERROR if one lies outside
+ * the maze.
+ *
+ * @param m the maze.
+ * @param start index of the start location.
+ * @param finish index of the destination.
+ * @return
+ */
+static int64_t check_endpoints(const struct maze *m, int64_t start,
+                               int64_t finish) {
+    int64_t cells = maze_cells(m);
+
+    if (start < 0 || finish < 0 || start >= cells || finish >= cells) {
+        return ERROR;
+    }
+
+    // No path starts or ends in a wall.
+    if (maze_get_index(m, start) == WALL || maze_get_index(m, finish) == WALL) {
+        return NOT_FOUND;
+    }
+
+    return 0;
+}
+
+/**
+ * Breadth-first search from 'start' to 'finish' in maze m. The maze is not
+ * modified, so it can be shared between threads that each use their own
+ * solver context.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred.
+ *
+ * @param s the solver context.
+ * @param m the maze.
+ * @param start index of the start location.
+ * @param finish index of the destination.
+ * @return
+ */
+int64_t solver_bfs_query(struct solver *s, const struct maze *m,
+                         int64_t start, int64_t finish) {
+    if (s == NULL || m == NULL) return ERROR;
+
+    int64_t cells = maze_cells(m);
+    int64_t invalid = check_endpoints(m, start, finish);
+
+    if (invalid != 0) return invalid;
+
+    if (solver_reserve(s, (size_t) cells) != 0) return ERROR;
+
+    const uint8_t *masks = maze_masks(m);
+    int64_t steps[N_MOVES_3D];
+
+    move_steps(m, steps);
+
+    s->epoch[start] = s->current;
+    queue_push(s->queue, start);
+
+    while (queue_empty(s->queue) == 0) {
+        int64_t current = queue_pop(s->queue);
+
+        if (current == finish) {
+            int64_t path_length = 0;
+
+            for (int64_t i = finish; i != start; i = s->prev[i]) path_length++;
+
+            return path_length;
+        }
+
+        unsigned moves = open_moves(m, masks, current);
+
+        // Only the open moves are set, so visit them lowest bit first.
+        while (moves != 0) {
+            int64_t next = current + steps[__builtin_ctz(moves)];
+
+            moves &= moves - 1;
+
+            if (s->epoch[next] == s->current) continue;
+
+            s->epoch[next] = s->current;
+            s->prev[next] = current;
+
+            if (queue_push(s->queue, next) != 0) return ERROR;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+/**
+ * Solves the maze m with a breadth-first search and marks the path.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred.
+ *
+ * @param s the solver context.
+ * @param m the maze.
+ * @return
+ */
+int64_t solver_bfs(struct solver *s, struct maze *m) {
+    if (s == NULL || m == NULL) return ERROR;
+
+    int64_t start = maze_start_index(m);
+    int64_t finish = maze_finish_index(m);
+
+    int64_t path_length = solver_bfs_query(s, m, start, finish);
+
+    if (path_length > 0) solver_mark_path(s, m, start, finish);
+
+    return path_length;
+}
+
+/**
+ * Dijkstra's algorithm from 'start' to 'finish' in maze m, where moving
+ * onto a cell costs its weight. The cells are kept in a bucket queue, so
+ * every queue operation is O(1) amortized. The maze is not modified.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred.
+ *
+ * @param s the solver context.
+ * @param m the maze.
+ * @param start index of the start location.
+ * @param finish index of the destination.
+ * @return
+ */
+int64_t solver_dijkstra_query(struct solver *s, const struct maze *m,
+                              int64_t start, int64_t finish) {
+    if (s == NULL || m == NULL) return ERROR;
+
+    int64_t cells = maze_cells(m);
+    int64_t invalid = check_endpoints(m, start, finish);
+
+    if (invalid != 0) return invalid;
+
+    if (solver_reserve(s, (size_t) cells) != 0
+        || solver_reserve_weighted(s, (size_t) cells) != 0) {
+        return ERROR;
+    }
+
+    const uint8_t *masks = maze_masks(m);
+    int64_t steps[N_MOVES_3D];
+
+    move_steps(m, steps);
+
+    s->epoch[start] = s->current;
+    s->dist[start] = 0;
+
+    if (bucketq_push(s->buckets, start, 0) != 0) return ERROR;
+
+    int64_t dist;
+    int64_t current;
+
+    while ((current = bucketq_pop(s->buckets, &dist)) >= 0) {
+        if (current == finish) return dist;
+
+        unsigned moves = open_moves(m, masks, current);
+
+        while (moves != 0) {
+            int64_t next = current + steps[__builtin_ctz(moves)];
+            int weight = maze_weight_index(m, next);
+
+            moves &= moves - 1;
+
+            // Settled cells never improve, so they are skipped here too.
+            if (s->epoch[next] == s->current
+                && s->dist[next] <= dist + weight) {
+                continue;
+            }
+
+            s->epoch[next] = s->current;
+            s->dist[next] = dist + weight;
+            s->prev[next] = current;
+
+            if (bucketq_push(s->buckets, next, dist + weight) != 0) {
+                return ERROR;
+            }
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+/**
+ * Solves the weighted maze m with Dijkstra's algorithm and marks the path.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred.
+ *
+ * @param s the solver context.
+ * @param m the maze.
+ * @return
+ */
+int64_t solver_dijkstra(struct solver *s, struct maze *m) {
+    if (s == NULL || m == NULL) return ERROR;
+
+    int64_t start = maze_start_index(m);
+    int64_t finish = maze_finish_index(m);
+
+    int64_t cost = solver_dijkstra_query(s, m, start, finish);
+
+    if (cost >= 0 && start != finish) solver_mark_path(s, m, start, finish);
+
+    return cost;
+}
+
+/**
+ * 0-1 breadth-first search from 'start' to 'finish' in maze m, for mazes
+ * where every move costs 0 or 1. Cells reached by a free move are pushed
+ * to the front of the deque and the others to the back, so the cells are
+ * taken out in order of distance and the search stays linear. A cell can
+ * be pushed again when its distance improves, which happens at most once
+ * per neighbour. The maze is not modified.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred or
+ * a move costs more than 1.
+ *
+ * @param s the solver context.
+ * @param m the maze.
+ * @param start index of the start location.
+ * @param finish index of the destination.
+ * @return
+ */
+int64_t solver_zero_one_query(struct solver *s, const struct maze *m,
+                              int64_t start, int64_t finish) {
+    if (s == NULL || m == NULL) return ERROR;
+
+    int64_t cells = maze_cells(m);
+    int64_t invalid = check_endpoints(m, start, finish);
+
+    if (invalid != 0) return invalid;
+
+    if (solver_reserve(s, (size_t) cells) != 0
+        || solver_reserve_weighted(s, (size_t) cells) != 0) {
+        return ERROR;
+    }
+
+    const uint8_t *masks = maze_masks(m);
+    int64_t steps[N_MOVES_3D];
+
+    move_steps(m, steps);
+
+    s->epoch[start] = s->current;
+    s->dist[start] = 0;
+
+    if (deque_push_back(s->deque, start) != 0) return ERROR;
+
+    while (deque_empty(s->deque) == 0) {
+        int64_t current = deque_pop_front(s->deque);
+
+        // The first time the destination leaves the deque it is final.
+        if (current == finish) return s->dist[finish];
+
+        unsigned moves = open_moves(m, masks, current);
+
+        while (moves != 0) {
+            int64_t next = current + steps[__builtin_ctz(moves)];
+            int weight = maze_weight_index(m, next);
+
+            moves &= moves - 1;
+
+            if (weight > 1) return ERROR;
+
+            int64_t dist = s->dist[current] + weight;
+
+            if (s->epoch[next] == s->current && s->dist[next] <= dist) {
+                continue;
+            }
+
+            s->epoch[next] = s->current;
+            s->dist[next] = dist;
+            s->prev[next] = current;
+
+            int error = weight == 0 ? deque_push_front(s->deque, next)
+                                    : deque_push_back(s->deque, next);
+
+            if (error != 0) return ERROR;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+/**
+ * Solves the maze m, where moves cost 0 or 1, with a 0-1 breadth-first
+ * search and marks the path.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred.
+ *
+ * @param s the solver context.
+ * @param m the maze.
+ * @return
+ */
+int64_t solver_zero_one(struct solver *s, struct maze *m) {
+    if (s == NULL || m == NULL) return ERROR;
+
+    int64_t start = maze_start_index(m);
+    int64_t finish = maze_finish_index(m);
+
+    int64_t cost = solver_zero_one_query(s, m, start, finish);
+
+    if (cost >= 0 && start != finish) solver_mark_path(s, m, start, finish);
+
+    return cost;
+}
+
+/**
+ * Multi-source breadth-first search from the 'n' cells in 'sources'. The
+ * queue starts with all sources at distance 0, so every cell is reached
+ * from its nearest source and one pass gives the distance of every cell.
+ * Walls and cells that cannot be reached get FIELD_UNREACHABLE.
+ * Return 0 if successful else 1.
+ *
+ * @param s the solver context.
+ * @param m the maze.
+ * @param sources indices of the sources.
+ * @param n the number of sources.
+ * @param field array of maze_cells(m) distances.
+ * @return
+ */
+int solver_distance_field(struct solver *s, const struct maze *m,
+                          const int64_t *sources, size_t n,
+                          uint32_t *field) {
+    if (s == NULL || m == NULL || field == NULL) return 1;
+    if (sources == NULL && n > 0) return 1;
+
+    int64_t cells = maze_cells(m);
+
+    if (solver_reserve(s, (size_t) cells) != 0) return 1;
+
+    const uint8_t *masks = maze_masks(m);
+    int64_t steps[N_MOVES_3D];
+
+    move_steps(m, steps);
+
+    for (int64_t i = 0; i < cells; i++) field[i] = FIELD_UNREACHABLE;
+
+    for (size_t i = 0; i < n; i++) {
+        if (sources[i] < 0 || sources[i] >= cells) return 1;
+        if (field[sources[i]] == 0) continue;
+
+        field[sources[i]] = 0;
+
+        if (queue_push(s->queue, sources[i]) != 0) return 1;
+    }
+
+    while (queue_empty(s->queue) == 0) {
+        int64_t current = queue_pop(s->queue);
+
+        // Cells further away than the largest distance stay unreachable.
+        if (field[current] + 1 == FIELD_UNREACHABLE) continue;
+
+        unsigned moves = open_moves(m, masks, current);
+
+        while (moves != 0) {
+            int64_t next = current + steps[__builtin_ctz(moves)];
+
+            moves &= moves - 1;
+
+            if (field[next] != FIELD_UNREACHABLE) continue;
+
+            field[next] = field[current] + 1;
+
+            if (queue_push(s->queue, next) != 0) return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "maze.h"
+
+/* Return values of the solvers when no path length can be reported. */
+#define NOT_FOUND (-1)
+#define ERROR (-2)
+
+/* Distance in a distance field of walls and cells that cannot be reached. */
+#define FIELD_UNREACHABLE UINT32_MAX
+
+/* Handle to a reusable solver context. A context owns the visited epoch
+ * stamps, the queue and the predecessor map of a search. Starting a search
+ * costs O(1) and the buffers are only reallocated when a larger maze is
+ * solved, so a context should be kept per thread and reused for many
+ * mazes or queries. */
+struct solver;
+
+/* Return a pointer to an empty solver context if successful, otherwise
+ * return NULL. */
+struct solver *solver_init(void);
+
+/* Cleanup solver context. */
+void solver_cleanup(struct solver *s);
+
+/* Breadth-first search from index 'start' to index 'finish' in maze 'm'.
+ * The visited state is kept in the context, so the maze is only read and
+ * can be shared by concurrent queries on different contexts.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t solver_bfs_query(struct solver *s, const struct maze *m,
+                         int64_t start, int64_t finish);
+
+/* Solves maze 'm' with a breadth-first search and marks the shortest path
+ * with PATH characters.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t solver_bfs(struct solver *s, struct maze *m);
+
+/* Dijkstra's algorithm from index 'start' to index 'finish' in maze 'm',
+ * where moving onto a cell costs maze_weight(). The maze is only read.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t solver_dijkstra_query(struct solver *s, const struct maze *m,
+                              int64_t start, int64_t finish);
+
+/* Solves weighted maze 'm' with Dijkstra's algorithm and marks the
+ * cheapest path with PATH characters.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t solver_dijkstra(struct solver *s, struct maze *m);
+
+/* 0-1 breadth-first search from index 'start' to index 'finish' in maze
+ * 'm', for mazes where every move costs 0 (CONVEYOR) or 1. Runs in linear
+ * time using a double-ended queue. The maze is only read.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred or
+ * the maze has a cell with a weight above 1. */
+int64_t solver_zero_one_query(struct solver *s, const struct maze *m,
+                              int64_t start, int64_t finish);
+
+/* Solves maze 'm' with a 0-1 breadth-first search and marks the cheapest
+ * path with PATH characters.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t solver_zero_one(struct solver *s, struct maze *m);
+
+/* Fills 'field', an array of maze_cells() distances, with the number of
+ * moves from every cell of maze 'm' to the nearest of the 'n' cells in
+ * 'sources', using one multi-source breadth-first search. Walls and cells
+ * that cannot be reached are set to FIELD_UNREACHABLE. The maze is only
+ * read.
+ * Returns 0 if successful, 1 otherwise. */
+int solver_distance_field(struct solver *s, const struct maze *m,
+                          const int64_t *sources, size_t n,
+                          uint32_t *field);
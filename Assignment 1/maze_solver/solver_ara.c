@@ -0,0 +1,447 @@
+/*H**********************************************************************
+* FILENAME: solver_ara.c
+*
+* DESCRIPTION:
+*   Anytime shortest paths with a deadline, using Anytime Repairing A*.
+*
+* PUBLIC FUNCTIONS:
+*   struct solver_ara *solver_ara_init( m )
+*   void solver_ara_cleanup( a )
+*   int64_t solver_ara_solve( a, deadline_ms )
+*   double solver_ara_bound( a )
+*   int solver_ara_mark_path( a )
+*   void solver_ara_stats( a )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+// Needed for clock_gettime()
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pqueue.h"
+#include "solver_ara.h"
+
+/* Epsilon is kept in tenths, so the keys of the queue stay integers. The
+ * first search uses epsilon 3 and every next search 0.5 less. */
+#define EPS_SCALE 10
+#define EPS_START 30
+#define EPS_STEP 5
+
+/* Number of expansions between two looks at the clock. */
+#define CLOCK_INTERVAL 64
+
+/* A cell has a distance g and a predecessor once it is seen. Cells are
+ * closed, or inconsistent, for the search whose number is stored. Cells
+ * of which the distance improves after they were expanded wait in the
+ * inconsistent list until the next search. */
+struct solver_ara {
+    struct maze *m;
+    int64_t steps[N_MOVES_3D];
+    int64_t *g;
+    int64_t *prev;
+    uint8_t *seen;
+    uint32_t *closed;
+    uint32_t *incons_stamp;
+    int64_t *incons;
+    size_t n_incons;
+    size_t incons_capacity;
+    int64_t *scratch;
+    size_t scratch_capacity;
+    struct pqueue *open;
+    int64_t start;
+    int64_t finish;
+    int eps;
+    uint32_t search;
+    double bound;
+    size_t expansions;
+    struct timespec deadline;
+    bool has_deadline;
+};
+
+/**
+ * Manhattan distance from cell i to the destination, counting every layer
+ * in between as one move.
+ *
+ * @param a the planner.
+ * @param i the cell.
+ * @return
+ */
+static int64_t heuristic(const struct solver_ara *a, int64_t i) {
+    int64_t dr = maze_row(a->m, i) - maze_row(a->m, a->finish);
+    int64_t dc = maze_col(a->m, i) - maze_col(a->m, a->finish);
+    int64_t dl = maze_layer(a->m, i) - maze_layer(a->m, a->finish);
+
+    return (dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc) + (dl < 0 ? -dl : dl);
+}
+
+/**
+ * Queue cell i with the key of the current epsilon: g + epsilon * h, with
+ * ties broken towards the destination.
+ *
+ * @param a the planner.
+ * @param i the cell.
+ * @return
+ */
+static int queue_cell(struct solver_ara *a, int64_t i) {
+    int64_t h = heuristic(a, i);
+
+    return pqueue_push(a->open, i, a->g[i] * EPS_SCALE + a->eps * h, h);
+}
+
+/**
+ * Return true if the deadline has passed.
+ *
+ * @param a the planner.
+ * @return
+ */
+static bool past_deadline(const struct solver_ara *a) {
+    if (!a->has_deadline) return false;
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec > a->deadline.tv_sec
+           || (now.tv_sec == a->deadline.tv_sec
+               && now.tv_nsec >= a->deadline.tv_nsec);
+}
+
+/**
+ * Append cell i to a list that doubles its capacity when it is full.
+ * Return 0 if successful else 1.
+ *
+ * @param list the list.
+ * @param n the number of cells in the list.
+ * @param capacity the capacity of the list.
+ * @param i the cell.
+ * @return
+ */
+static int append(int64_t **list, size_t *n, size_t *capacity, int64_t i) {
+    if (*n == *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 1024;
+        int64_t *grown = realloc(*list, sizeof(int64_t) * new_capacity);
+
+        if (grown == NULL) return 1;
+
+        *list = grown;
+        *capacity = new_capacity;
+    }
+
+    (*list)[(*n)++] = i;
+
+    return 0;
+}
+
+/**
+ * Reserve bytes in memory for the planner.
+ *
+ * @param m the maze.
+ * @return
+ */
+struct solver_ara *solver_ara_init(struct maze *m) {
+    if (m == NULL) return NULL;
+
+    struct solver_ara *a = malloc(sizeof(struct solver_ara));
+
+    if (a == NULL) return NULL;
+
+    size_t cells = (size_t) maze_cells(m);
+
+    a->m = m;
+    a->g = malloc(sizeof(int64_t) * cells);
+    a->prev = malloc(sizeof(int64_t) * cells);
+    a->seen = malloc(sizeof(uint8_t) * cells);
+    a->closed = malloc(sizeof(uint32_t) * cells);
+    a->incons_stamp = malloc(sizeof(uint32_t) * cells);
+    a->incons = NULL;
+    a->scratch = NULL;
+    a->open = pqueue_init(cells);
+
+    if (a->g == NULL || a->prev == NULL || a->seen == NULL
+        || a->closed == NULL || a->incons_stamp == NULL || a->open == NULL) {
+        solver_ara_cleanup(a);
+
+        return NULL;
+    }
+
+    // Writing every buffer here also maps its pages, so the first touch of
+    // a page does not slow down the search against the deadline.
+    memset(a->g, 0, sizeof(int64_t) * cells);
+    memset(a->prev, 0, sizeof(int64_t) * cells);
+    memset(a->seen, 0, sizeof(uint8_t) * cells);
+    memset(a->closed, 0, sizeof(uint32_t) * cells);
+    memset(a->incons_stamp, 0, sizeof(uint32_t) * cells);
+
+    for (int d = 0; d < N_MOVES_3D; d++) a->steps[d] = maze_step(m, d);
+
+    a->start = maze_start_index(m);
+    a->finish = maze_finish_index(m);
+
+    a->n_incons = 0;
+    a->incons_capacity = 0;
+    a->scratch_capacity = 0;
+    a->eps = EPS_START;
+    a->search = 0;
+    a->bound = 0;
+    a->expansions = 0;
+    a->has_deadline = false;
+
+    return a;
+}
+
+/**
+ * Free memory from planner and sub variables.
+ *
+ * @param a the planner.
+ */
+void solver_ara_cleanup(struct solver_ara *a) {
+    if (a == NULL) return;
+
+    free(a->g);
+    free(a->prev);
+    free(a->seen);
+    free(a->closed);
+    free(a->incons_stamp);
+    free(a->incons);
+    free(a->scratch);
+    pqueue_cleanup(a->open);
+
+    free(a);
+}
+
+/**
+ * Expand cells in order of their inflated key until the destination has
+ * the smallest key. Cells that improve after they were expanded in this
+ * search are not queued again but kept for the next search.
+ * Return 0 if done, 1 if the deadline passed and ERROR if an error
+ * occurred.
+ *
+ * @param a the planner.
+ * @return
+ */
+static int improve_path(struct solver_ara *a) {
+    const uint8_t *masks = maze_masks(a->m);
+    int64_t k1, k2;
+
+    while (pqueue_top_key(a->open, &k1, &k2) == 0) {
+        if (a->seen[a->finish] && a->g[a->finish] * EPS_SCALE <= k1) break;
+        if (++a->expansions % CLOCK_INTERVAL == 0 && past_deadline(a)) {
+            return 1;
+        }
+
+        int64_t current = pqueue_pop(a->open);
+        unsigned moves = masks != NULL ? masks[current]
+                                       : maze_open_moves(a->m, current);
+
+        a->closed[current] = a->search;
+
+        while (moves != 0) {
+            int64_t next = current + a->steps[__builtin_ctz(moves)];
+
+            moves &= moves - 1;
+
+            if (a->seen[next] && a->g[next] <= a->g[current] + 1) continue;
+
+            a->seen[next] = 1;
+            a->g[next] = a->g[current] + 1;
+            a->prev[next] = current;
+
+            if (a->closed[next] != a->search) {
+                if (queue_cell(a, next) != 0) return ERROR;
+            } else if (a->incons_stamp[next] != a->search) {
+                a->incons_stamp[next] = a->search;
+
+                if (append(&a->incons, &a->n_incons, &a->incons_capacity,
+                           next) != 0) {
+                    return ERROR;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Move the queued and the inconsistent cells to the scratch list and
+ * compute the smallest g + h among them, a lower bound on the length of
+ * the shortest path, or -1 if there are none.
+ * Return 0 if successful else 1.
+ *
+ * @param a the planner.
+ * @param n set to the number of cells in the scratch list.
+ * @param lower set to the lower bound.
+ * @return
+ */
+static int drain_open(struct solver_ara *a, size_t *n, int64_t *lower) {
+    int64_t i;
+
+    *n = 0;
+    *lower = -1;
+
+    while ((i = pqueue_pop(a->open)) >= 0) {
+        if (append(&a->scratch, n, &a->scratch_capacity, i) != 0) return 1;
+    }
+
+    for (size_t j = 0; j < a->n_incons; j++) {
+        if (append(&a->scratch, n, &a->scratch_capacity, a->incons[j]) != 0) {
+            return 1;
+        }
+    }
+
+    a->n_incons = 0;
+
+    for (size_t j = 0; j < *n; j++) {
+        int64_t f = a->g[a->scratch[j]] + heuristic(a, a->scratch[j]);
+
+        if (*lower < 0 || f < *lower) *lower = f;
+    }
+
+    return 0;
+}
+
+/**
+ * Run searches with a decreasing epsilon until the path is the shortest or
+ * the deadline passes.
+ *
+ * @param a the planner.
+ * @param deadline_ms the time budget in milliseconds, 0 for none.
+ * @return
+ */
+int64_t solver_ara_solve(struct solver_ara *a, double deadline_ms) {
+    if (a == NULL || a->search != 0) return ERROR;
+
+    // No path starts or ends in a wall.
+    if (maze_get_index(a->m, a->start) == WALL
+        || maze_get_index(a->m, a->finish) == WALL) {
+        return NOT_FOUND;
+    }
+
+    if (a->start == a->finish) {
+        a->seen[a->start] = 1;
+        a->g[a->start] = 0;
+        a->bound = 1.0;
+
+        return 0;
+    }
+
+    if (deadline_ms > 0) {
+        long long ns = (long long) (deadline_ms * 1e6);
+
+        clock_gettime(CLOCK_MONOTONIC, &a->deadline);
+        a->deadline.tv_sec += (time_t) (ns / 1000000000);
+        a->deadline.tv_nsec += (long) (ns % 1000000000);
+
+        if (a->deadline.tv_nsec >= 1000000000) {
+            a->deadline.tv_sec++;
+            a->deadline.tv_nsec -= 1000000000;
+        }
+
+        a->has_deadline = true;
+    }
+
+    a->search = 1;
+    a->seen[a->start] = 1;
+    a->g[a->start] = 0;
+
+    if (queue_cell(a, a->start) != 0) return ERROR;
+
+    while (true) {
+        int status = improve_path(a);
+
+        if (status == ERROR) return ERROR;
+
+        // A search cut short keeps the bound of the last finished one,
+        // its path can only be shorter.
+        if (status == 1) break;
+        if (!a->seen[a->finish]) return NOT_FOUND;
+
+        size_t n;
+        int64_t lower;
+
+        if (drain_open(a, &n, &lower) != 0) return ERROR;
+
+        double bound = (double) a->eps / EPS_SCALE;
+
+        // With nothing left to expand no path can be shorter.
+        if (lower < 0) {
+            bound = 1.0;
+        } else if ((double) a->g[a->finish] < bound * (double) lower) {
+            bound = (double) a->g[a->finish] / (double) lower;
+        }
+
+        a->bound = bound < 1.0 ? 1.0 : bound;
+
+        if (a->bound <= 1.0 || a->eps == EPS_SCALE) {
+            a->bound = 1.0;
+            break;
+        }
+
+        // Next search: lower epsilon, requeue everything with new keys.
+        a->eps = a->eps - EPS_STEP > EPS_SCALE ? a->eps - EPS_STEP : EPS_SCALE;
+        a->search++;
+
+        bool timed_out = false;
+
+        for (size_t j = 0; j < n && !timed_out; j++) {
+            if (queue_cell(a, a->scratch[j]) != 0) return ERROR;
+
+            timed_out = (j + 1) % CLOCK_INTERVAL == 0 && past_deadline(a);
+        }
+
+        if (timed_out) break;
+    }
+
+    if (!a->seen[a->finish]) return ARA_TIMEOUT;
+
+    // Predecessors always have a smaller g, so this walk ends at the start.
+    int64_t path_length = 0;
+
+    for (int64_t i = a->finish; i != a->start; i = a->prev[i]) path_length++;
+
+    return path_length;
+}
+
+double solver_ara_bound(const struct solver_ara *a) {
+    if (a == NULL) return 0;
+
+    return a->bound;
+}
+
+/**
+ * Mark the best path found by following the predecessors back from the
+ * destination.
+ *
+ * @param a the planner.
+ * @return
+ */
+int solver_ara_mark_path(struct solver_ara *a) {
+    if (a == NULL || !a->seen[a->finish]) return 1;
+    if (a->start == a->finish) return 0;
+
+    for (int64_t i = a->prev[a->finish]; i != a->start; i = a->prev[i]) {
+        maze_set_index(a->m, i, PATH);
+    }
+
+    return 0;
+}
+
+/**
+ * Shows stats about the last plan.
+ *
+ * @param a the planner.
+ */
+void solver_ara_stats(const struct solver_ara *a) {
+    if (a == NULL) return;
+
+    fprintf(stderr, "stats %u %zu %.1f\n", a->search, a->expansions,
+            (double) a->eps / EPS_SCALE);
+}
@@ -0,0 +1,46 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "solver.h"
+
+/* Return value of solver_ara_solve() when the deadline passed before any
+ * path was found. */
+#define ARA_TIMEOUT (-3)
+
+/* Handle to an anytime planner (ARA*). The planner runs weighted A* with
+ * the heuristic inflated by a factor epsilon, which finds a path quickly
+ * whose length is at most epsilon times the shortest. Epsilon is then
+ * lowered step by step down to 1, reusing the earlier search, so the path
+ * improves until it is the shortest or the deadline passes. */
+struct solver_ara;
+
+/* Return a pointer to a planner for the start and destination of maze 'm'
+ * if successful, otherwise return NULL. The planner uses the maze until it
+ * is cleaned up. The cell state is allocated and cleared here, so the
+ * time that takes is not part of the deadline of solver_ara_solve(). */
+struct solver_ara *solver_ara_init(struct maze *m);
+
+/* Cleanup planner. The maze is not freed. */
+void solver_ara_cleanup(struct solver_ara *a);
+
+/* Plans a path from start to destination and improves it until it is the
+ * shortest or 'deadline_ms' milliseconds have passed. A deadline of 0 or
+ * less means no deadline. A planner solves only once.
+ * Returns the length of the best path found if a path is found.
+ * Returns NOT_FOUND if there is no path, ARA_TIMEOUT if no path was found
+ * before the deadline and ERROR if an error occurred. */
+int64_t solver_ara_solve(struct solver_ara *a, double deadline_ms);
+
+/* Returns the suboptimality bound of the path found: its length is at
+ * most the bound times the length of the shortest path. A bound of 1
+ * means the path is the shortest. Returns 0 if no bound is known because
+ * the deadline passed before the first search finished. */
+double solver_ara_bound(const struct solver_ara *a);
+
+/* Marks the best path found in the maze with PATH characters.
+ * Returns 0 if successful, 1 if there is no path. */
+int solver_ara_mark_path(struct solver_ara *a);
+
+/* Print planner statistics of the last plan to stderr.
+ * The format is: 'stats' num_of_searches num_of_expansions last_epsilon */
+void solver_ara_stats(const struct solver_ara *a);
@@ -0,0 +1,362 @@
+/*H**********************************************************************
+* FILENAME: solver_lpa.c
+*
+* DESCRIPTION:
+*   Incremental shortest paths with Lifelong Planning A* (LPA*).
+*
+* PUBLIC FUNCTIONS:
+*   struct solver_lpa *solver_lpa_init( m )
+*   void solver_lpa_cleanup( p )
+*   int64_t solver_lpa_solve( p )
+*   int64_t solver_update_cells( p, cells, n )
+*   int solver_lpa_mark_path( p )
+*   void solver_lpa_stats( p )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 30-10-2023
+*
+*H*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pqueue.h"
+#include "solver_lpa.h"
+
+/* Distance of cells that cannot be reached. Small enough that adding a
+ * move cost or the heuristic does not overflow. */
+#define INF (INT64_MAX / 4)
+
+/* g is the distance from the start found by the last expansion of a cell,
+ * rhs the one-step lookahead based on the g values of its neighbours. A
+ * cell is consistent when both are equal; only inconsistent cells are
+ * queued and expanded. */
+struct solver_lpa {
+    struct maze *m;
+    int64_t *g;
+    int64_t *rhs;
+    struct pqueue *open;
+    int64_t start;
+    int64_t finish;
+    size_t expansions;
+    size_t updates;
+};
+
+/**
+ * Manhattan distance from cell i to the destination, counting every layer
+ * in between as one move.
+ *
+ * @param p the planner.
+ * @param i the cell.
+ * @return
+ */
+static int64_t heuristic(const struct solver_lpa *p, int64_t i) {
+    int64_t dr = maze_row(p->m, i) - maze_row(p->m, p->finish);
+    int64_t dc = maze_col(p->m, i) - maze_col(p->m, p->finish);
+    int64_t dl = maze_layer(p->m, i) - maze_layer(p->m, p->finish);
+
+    return (dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc) + (dl < 0 ? -dl : dl);
+}
+
+/**
+ * Get the index of the neighbour of cell i in direction d, or -1 if that
+ * neighbour is not a valid move.
+ *
+ * @param p the planner.
+ * @param i the cell.
+ * @param d the direction.
+ * @return
+ */
+static int64_t neighbour(const struct solver_lpa *p, int64_t i, int d) {
+    return maze_neighbour(p->m, i, d);
+}
+
+/**
+ * Return true if cell i is a wall.
+ *
+ * @param p the planner.
+ * @param i the cell.
+ * @return
+ */
+static bool is_wall(const struct solver_lpa *p, int64_t i) {
+    return maze_get_index(p->m, i) == WALL;
+}
+
+/**
+ * Queue cell i with its LPA* key if it is inconsistent, otherwise make sure
+ * it is not queued.
+ *
+ * @param p the planner.
+ * @param i the cell.
+ * @return
+ */
+static int queue_if_inconsistent(struct solver_lpa *p, int64_t i) {
+    if (p->g[i] == p->rhs[i]) {
+        pqueue_remove(p->open, i);
+
+        return 0;
+    }
+
+    int64_t best = p->g[i] < p->rhs[i] ? p->g[i] : p->rhs[i];
+
+    return pqueue_push(p->open, i, best + heuristic(p, i), best);
+}
+
+/**
+ * Recompute the lookahead distance of cell i from its neighbours.
+ *
+ * @param p the planner.
+ * @param i the cell.
+ * @return
+ */
+static int update_vertex(struct solver_lpa *p, int64_t i) {
+    p->updates++;
+
+    if (i != p->start) {
+        int64_t rhs = INF;
+
+        if (!is_wall(p, i)) {
+            for (int d = 0; d < N_MOVES_3D; d++) {
+                int64_t n = neighbour(p, i, d);
+
+                if (n < 0 || is_wall(p, n) || p->g[n] >= INF) continue;
+                if (p->g[n] + 1 < rhs) rhs = p->g[n] + 1;
+            }
+        }
+
+        p->rhs[i] = rhs;
+    }
+
+    return queue_if_inconsistent(p, i);
+}
+
+/**
+ * Update the valid neighbours of cell i.
+ *
+ * @param p the planner.
+ * @param i the cell.
+ * @return
+ */
+static int update_neighbours(struct solver_lpa *p, int64_t i) {
+    for (int d = 0; d < N_MOVES_3D; d++) {
+        int64_t n = neighbour(p, i, d);
+
+        if (n >= 0 && update_vertex(p, n) != 0) return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Return true if key (a1, a2) is smaller than key (b1, b2).
+ *
+ * @return
+ */
+static bool key_less(int64_t a1, int64_t a2, int64_t b1, int64_t b2) {
+    return a1 < b1 || (a1 == b1 && a2 < b2);
+}
+
+/**
+ * Reserve bytes in memory for the planner and queue the start location.
+ *
+ * @param m the maze.
+ * @return
+ */
+struct solver_lpa *solver_lpa_init(struct maze *m) {
+    if (m == NULL) return NULL;
+
+    struct solver_lpa *p = malloc(sizeof(struct solver_lpa));
+
+    if (p == NULL) return NULL;
+
+    size_t cells = (size_t) maze_cells(m);
+
+    p->m = m;
+    p->g = malloc(sizeof(int64_t) * cells);
+    p->rhs = malloc(sizeof(int64_t) * cells);
+    p->open = pqueue_init(cells);
+
+    if (p->g == NULL || p->rhs == NULL || p->open == NULL) {
+        solver_lpa_cleanup(p);
+
+        return NULL;
+    }
+
+    for (size_t i = 0; i < cells; i++) {
+        p->g[i] = INF;
+        p->rhs[i] = INF;
+    }
+
+    p->start = maze_start_index(m);
+    p->finish = maze_finish_index(m);
+
+    p->expansions = 0;
+    p->updates = 0;
+
+    p->rhs[p->start] = is_wall(p, p->start) ? INF : 0;
+
+    if (queue_if_inconsistent(p, p->start) != 0) {
+        solver_lpa_cleanup(p);
+
+        return NULL;
+    }
+
+    return p;
+}
+
+/**
+ * Free memory from planner and sub variables.
+ *
+ * @param p the planner.
+ */
+void solver_lpa_cleanup(struct solver_lpa *p) {
+    if (p == NULL) return;
+
+    free(p->g);
+    free(p->rhs);
+    pqueue_cleanup(p->open);
+
+    free(p);
+}
+
+/**
+ * Expand inconsistent cells until the destination is consistent and no
+ * queued cell can improve its distance.
+ *
+ * @param p the planner.
+ * @return
+ */
+int64_t solver_lpa_solve(struct solver_lpa *p) {
+    if (p == NULL) return ERROR;
+
+    p->expansions = 0;
+
+    while (true) {
+        int64_t k1, k2;
+
+        if (pqueue_top_key(p->open, &k1, &k2) != 0) break;
+
+        int64_t f = p->g[p->finish] < p->rhs[p->finish] ? p->g[p->finish]
+                                                         : p->rhs[p->finish];
+
+        if (!key_less(k1, k2, f + heuristic(p, p->finish), f)
+            && p->rhs[p->finish] == p->g[p->finish]) {
+            break;
+        }
+
+        int64_t u = pqueue_pop(p->open);
+
+        p->expansions++;
+
+        if (p->g[u] > p->rhs[u]) {
+            // Overconsistent: the cell got closer, settle it.
+            p->g[u] = p->rhs[u];
+
+            if (update_neighbours(p, u) != 0) return ERROR;
+        } else {
+            // Underconsistent: the cell got further away, re-evaluate it.
+            p->g[u] = INF;
+
+            if (update_vertex(p, u) != 0 || update_neighbours(p, u) != 0) {
+                return ERROR;
+            }
+        }
+    }
+
+    if (p->g[p->finish] >= INF) return NOT_FOUND;
+
+    return p->g[p->finish];
+}
+
+/**
+ * Toggle cells between WALL and FLOOR and repair the shortest path.
+ *
+ * @param p the planner.
+ * @param cells indices of the toggled cells.
+ * @param n the number of cells.
+ * @return
+ */
+int64_t solver_update_cells(struct solver_lpa *p, const int64_t *cells,
+                            size_t n) {
+    if (p == NULL || (cells == NULL && n > 0)) return ERROR;
+
+    p->updates = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (cells[i] < 0 || cells[i] >= maze_cells(p->m)) return ERROR;
+
+        int row = maze_row(p->m, cells[i]);
+        int col = maze_col(p->m, cells[i]);
+
+        if (!maze_valid_move(p->m, row, col)) return ERROR;
+
+        // Toggling STAIRS removes the moves between layers, so the
+        // neighbours are collected before the cell changes.
+        int64_t near[N_MOVES_3D];
+
+        for (int d = 0; d < N_MOVES_3D; d++) {
+            near[d] = neighbour(p, cells[i], d);
+        }
+
+        maze_set_index(p->m, cells[i], is_wall(p, cells[i]) ? FLOOR : WALL);
+
+        if (cells[i] == p->start) {
+            p->rhs[p->start] = is_wall(p, p->start) ? INF : 0;
+        }
+
+        // The moves into and out of the cell changed cost.
+        if (update_vertex(p, cells[i]) != 0) return ERROR;
+
+        for (int d = 0; d < N_MOVES_3D; d++) {
+            if (near[d] >= 0 && update_vertex(p, near[d]) != 0) return ERROR;
+        }
+    }
+
+    return solver_lpa_solve(p);
+}
+
+/**
+ * Mark the current shortest path by walking back from the destination to
+ * the neighbour with the smallest distance.
+ *
+ * @param p the planner.
+ * @return
+ */
+int solver_lpa_mark_path(struct solver_lpa *p) {
+    if (p == NULL || p->g[p->finish] >= INF) return 1;
+
+    int64_t i = p->finish;
+
+    while (i != p->start) {
+        int64_t best = -1;
+
+        for (int d = 0; d < N_MOVES_3D; d++) {
+            int64_t n = neighbour(p, i, d);
+
+            if (n < 0 || is_wall(p, n)) continue;
+            if (best < 0 || p->g[n] < p->g[best]) best = n;
+        }
+
+        if (best < 0 || p->g[best] >= p->g[i]) return 1;
+
+        // Marked only now, as marking STAIRS hides the moves between layers.
+        if (i != p->finish) maze_set_index(p->m, i, PATH);
+
+        i = best;
+    }
+
+    return 0;
+}
+
+/**
+ * Shows stats about the last plan.
+ *
+ * @param p the planner.
+ */
+void solver_lpa_stats(const struct solver_lpa *p) {
+    if (p == NULL) return;
+
+    fprintf(stderr, "stats %zu %zu %zu\n", p->expansions, p->updates,
+            pqueue_size(p->open));
+}
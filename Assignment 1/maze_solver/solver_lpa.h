@@ -0,0 +1,39 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "solver.h"
+
+/* Handle to an incremental planner. The planner keeps the state of its
+ * last search (Lifelong Planning A*), so after cells of the maze change
+ * only the part of the search affected by the change is repeated. */
+struct solver_lpa;
+
+/* Return a pointer to a planner for the start and destination of maze 'm'
+ * if successful, otherwise return NULL. The planner uses the maze until it
+ * is cleaned up; the maze must only be changed through
+ * solver_update_cells(). */
+struct solver_lpa *solver_lpa_init(struct maze *m);
+
+/* Cleanup planner. The maze is not freed. */
+void solver_lpa_cleanup(struct solver_lpa *p);
+
+/* Plans, or repairs, the shortest path from start to destination.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t solver_lpa_solve(struct solver_lpa *p);
+
+/* Toggles the 'n' cells with the indices in 'cells' between WALL and FLOOR
+ * and repairs the previous shortest path, reusing the earlier search.
+ * Cells on the border of the maze cannot be toggled.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occurred. */
+int64_t solver_update_cells(struct solver_lpa *p, const int64_t *cells,
+                            size_t n);
+
+/* Marks the current shortest path in the maze with PATH characters.
+ * Returns 0 if successful, 1 if there is no path. */
+int solver_lpa_mark_path(struct solver_lpa *p);
+
+/* Print planner statistics of the last plan to stderr.
+ * The format is: 'stats' num_of_expansions num_of_updates queue_size */
+void solver_lpa_stats(const struct solver_lpa *p);
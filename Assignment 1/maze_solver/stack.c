@@ -9,8 +9,8 @@
 *   void stack_cleanup( s )
 *   void stack_stats( s )
 *   int stack_push( s, c )
-*   int stack_pop( s )
-*   int stack_peek( s )
+*   int64_t stack_pop( s )
+*   int64_t stack_peek( s )
 *   int stack_empty( s )
 *   size_t stack_size( s )
 *
@@ -20,15 +20,16 @@
 *
 *H*/
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "stack.h"
 
 struct stack {
-    int *data;
-    int pushes;
-    int pops;
+    int64_t *data;
+    size_t pushes;
+    size_t pops;
     size_t size;
     size_t capacity;
 };
@@ -45,7 +46,7 @@ struct stack *stack_init(size_t capacity) {
 
     if (st == NULL) return NULL;
 
-    st->data = malloc(sizeof(int) * capacity);
+    st->data = malloc(sizeof(int64_t) * capacity);
 
     if (st->data == NULL) {
         stack_cleanup(st);
@@ -82,7 +83,9 @@ void stack_cleanup(struct stack *s) {
 void stack_stats(const struct stack *s) {
     if (s == NULL) return;
 
-    fprintf(stderr,"stats %d %d %d\n", s->pushes, s->pops, abs(s->pops - (int) s->size));
+    size_t max = s->pops > s->size ? s->pops - s->size : s->size - s->pops;
+
+    fprintf(stderr,"stats %zu %zu %zu\n", s->pushes, s->pops, max);
 }
 
 /**
@@ -92,12 +95,12 @@ void stack_stats(const struct stack *s) {
  * @param c the character pushed into the stack.
  * @return
  */
-int stack_push(struct stack *s, int c) {
+int stack_push(struct stack *s, int64_t c) {
     if (s == NULL) return 1;
 
     // If size is going to exceed, add more memory.
     if ((s->size + 1) >= s->capacity) {
-        int *temp = realloc(s->data, sizeof(int) * ((s->size + 1) * 2));
+        int64_t *temp = realloc(s->data, sizeof(int64_t) * ((s->size + 1) * 2));
 
         if (temp == NULL) return 0;
 
@@ -119,7 +122,7 @@ int stack_push(struct stack *s, int c) {
  * @param s the stack.
  * @return
  */
-int stack_pop(struct stack *s) {
+int64_t stack_pop(struct stack *s) {
     if (s == NULL) return -1;
 
     if (s->size == 0) return -1;
@@ -138,7 +141,7 @@ int stack_pop(struct stack *s) {
  * @param s the stack.
  * @return
  */
-int stack_peek(const struct stack *s) {
+int64_t stack_peek(const struct stack *s) {
     if (s == NULL) return -1;
     if (s->size == 0) return -1;
 
@@ -0,0 +1,34 @@
+#! /usr/bin/env bash
+
+# Compare the sorts of PROG on random numbers of every size in SIZES.
+# Usage: ./bench_sort.sh [size ...]
+# The inputs are kept in a temporary directory while the benchmark runs, so
+# 1e8 numbers need about 1.1 GB of disk space and 6 GB of memory.
+
+PROG=./mysort
+SIZES=${@:-100000 1000000 10000000 100000000}
+input_dir=$(mktemp -d)
+TIMEFORMAT=%R
+
+trap "rm -rf $input_dir" EXIT
+
+printf "%-10s %12s %12s\n" "numbers" "merge (-m)" "radix (-r)"
+
+for n in $SIZES
+do
+    input=$input_dir/$n.txt
+
+    awk -v n=$n 'BEGIN {
+        srand(1);
+        for (i = 0; i < n; i++) {
+            printf "%.0f\n", int(rand() * 4294967296) - 2147483648;
+        }
+    }' > $input
+
+    merge=$( { time $PROG -m < $input > /dev/null; } 2>&1 )
+    radix=$( { time $PROG -r < $input > /dev/null; } 2>&1 )
+
+    printf "%-10s %11ss %11ss\n" $n $merge $radix
+
+    rm -f $input
+done
@@ -5,6 +5,7 @@
 #include <check.h>
 
 #include "list.h"
+#include "list_ext.h"
 
 // For older versions of the check library
 #ifndef ck_assert_ptr_nonnull
@@ -308,6 +309,328 @@ START_TEST (test_insert_invalid)
 }
 END_TEST
 
+START_TEST (test_iter_walk)
+{
+    struct list* l = list_init();
+    struct list_iter it;
+
+    list_iter_begin(&it, l);
+    ck_assert_ptr_null(list_iter_node(&it));
+    ck_assert_int_eq(list_iter_next(&it), 1);
+    ck_assert_int_eq(list_iter_prev(&it), 1);
+
+    for (int i = 0; i < LEN; i++) {
+        list_add_back(l, list_new_node(i));
+    }
+
+    int i = 0;
+    for (list_iter_begin(&it, l); list_iter_node(&it) != NULL;
+         list_iter_next(&it)) {
+        ck_assert_int_eq(list_node_get_value(list_iter_node(&it)), i);
+        i++;
+    }
+    ck_assert_int_eq(i, LEN);
+    ck_assert_int_eq(list_iter_next(&it), 1);
+
+    list_iter_end(&it, l);
+    while (list_iter_prev(&it) == 0) {
+        i--;
+        ck_assert_int_eq(list_node_get_value(list_iter_node(&it)), i);
+    }
+    ck_assert_int_eq(i, 0);
+    ck_assert_ptr_eq(list_iter_node(&it), list_head(l));
+
+    list_cleanup(l);
+}
+END_TEST
+
+START_TEST (test_iter_insert)
+{
+    struct list* l = list_init();
+    struct list_iter it;
+
+    // Past the end of an empty list the node is appended.
+    list_iter_end(&it, l);
+    ck_assert_int_eq(list_iter_insert(&it, list_new_node(3)), 0);
+    ck_assert_int_eq(list_iter_insert(&it, list_new_node(4)), 0);
+
+    list_iter_begin(&it, l);
+    ck_assert_int_eq(list_iter_insert(&it, list_new_node(1)), 0);
+    ck_assert_int_eq(list_node_get_value(list_iter_node(&it)), 3);
+
+    struct node* n = list_tail(l);
+    ck_assert_int_eq(list_iter_at(&it, l, n), 0);
+    ck_assert_int_eq(list_iter_insert(&it, list_new_node(2)), 0);
+    ck_assert_ptr_eq(list_iter_node(&it), n);
+
+    // The node is already in the list.
+    ck_assert_int_eq(list_iter_insert(&it, n), 1);
+    ck_assert_int_eq(list_length(l), 4);
+
+    n = list_head(l);
+    int expected[] = { 1, 3, 2, 4 };
+    for (int i = 0; i < 4; i++) {
+        ck_assert_int_eq(list_node_get_value(n), expected[i]);
+        n = list_next(n);
+    }
+    ck_assert_ptr_null(n);
+    ck_assert_int_eq(list_node_get_value(list_tail(l)), 4);
+
+    list_cleanup(l);
+}
+END_TEST
+
+START_TEST (test_iter_invalid)
+{
+    struct list* l = list_init();
+    struct list* k = list_init();
+    struct node* n = list_new_node(5);
+    struct list_iter it;
+
+    list_add_back(k, n);
+
+    ck_assert_int_eq(list_iter_at(&it, l, n), 1);
+    ck_assert_int_eq(list_iter_at(&it, l, NULL), 1);
+    ck_assert_int_eq(list_iter_at(NULL, k, n), 1);
+    ck_assert_int_eq(list_iter_next(NULL), 1);
+    ck_assert_int_eq(list_iter_prev(NULL), 1);
+    ck_assert_ptr_null(list_iter_node(NULL));
+
+    list_iter_begin(&it, l);
+    ck_assert_int_eq(list_iter_insert(&it, NULL), 1);
+    ck_assert_int_eq(list_iter_insert(&it, n), 1);
+    ck_assert_int_eq(list_length(l), 0);
+
+    list_cleanup(l);
+    list_cleanup(k);
+}
+END_TEST
+
+START_TEST (test_index_ith)
+{
+    struct list* l = list_init();
+    struct node* n;
+
+    for (int i = 0; i < 100 * LEN; i++) {
+        list_add_back(l, list_new_node(i));
+    }
+
+    ck_assert_int_eq(list_index_build(l), 0);
+
+    for (unsigned int i = 0; i < 100 * LEN; i++) {
+        n = list_get_ith(l, i);
+        ck_assert_int_eq(list_node_get_value(n), i);
+        ck_assert_uint_eq(list_node_rank(l, n), i);
+    }
+    ck_assert_ptr_null(list_get_ith(l, 100 * LEN));
+
+    list_cleanup(l);
+}
+END_TEST
+
+START_TEST (test_index_update)
+{
+    struct list* l = list_init();
+    struct node* n;
+
+    ck_assert_int_eq(list_index_build(l), 0);
+
+    // Builds 0 .. 2 * LEN - 1 in a mixed order of inserts.
+    for (int i = 0; i < LEN; i++) {
+        ck_assert_int_eq(list_insert_at(l, list_new_node(2 * i + 1), i), 0);
+    }
+    for (int i = 0; i < LEN; i++) {
+        ck_assert_int_eq(list_insert_at(l, list_new_node(2 * i), 2 * i), 0);
+    }
+    n = list_new_node(0);
+    ck_assert_int_eq(list_insert_at(l, n, 2 * LEN + 1), 1);
+    list_free_node(n);
+
+    for (unsigned int i = 0; i < 2 * LEN; i++) {
+        ck_assert_int_eq(list_node_get_value(list_get_ith(l, i)), i);
+    }
+
+    // Unlink the even numbers.
+    for (unsigned int i = 0; i < LEN; i++) {
+        n = list_get_ith(l, i);
+        ck_assert_int_eq(list_unlink_node(l, n), 0);
+        list_free_node(n);
+    }
+
+    for (unsigned int i = 0; i < LEN; i++) {
+        n = list_get_ith(l, i);
+        ck_assert_int_eq(list_node_get_value(n), 2 * i + 1);
+        ck_assert_uint_eq(list_node_rank(l, n), i);
+    }
+
+    list_index_drop(l);
+    ck_assert_int_eq(list_node_get_value(list_get_ith(l, 3)), 7);
+    ck_assert_uint_eq(list_node_rank(l, list_tail(l)), LEN - 1);
+
+    list_cleanup(l);
+}
+END_TEST
+
+START_TEST (test_index_cut)
+{
+    struct list* l = list_init();
+
+    for (int i = 0; i < 10 * LEN; i++) {
+        list_add_back(l, list_new_node(i));
+    }
+
+    list_index_build(l);
+    struct list* k = list_cut_after(l, list_get_ith(l, LEN - 1));
+
+    ck_assert_uint_eq(list_length(l), LEN);
+    ck_assert_int_eq(list_node_get_value(list_get_ith(l, LEN - 1)), LEN - 1);
+    ck_assert_int_eq(list_node_get_value(list_get_ith(k, 0)), LEN);
+    ck_assert_uint_eq(list_node_rank(k, list_tail(k)), 9 * LEN - 1);
+    ck_assert_uint_eq(list_node_rank(l, list_tail(k)), SIZE_MAX);
+
+    list_cleanup(l);
+    list_cleanup(k);
+}
+END_TEST
+
+START_TEST (test_pooled_reuse)
+{
+    struct list* l = list_init_pooled();
+    struct node* n;
+
+    ck_assert_ptr_nonnull(l);
+
+    for (int i = 0; i < 100 * LEN; i++) {
+        n = list_new_pooled_node(l, i);
+        ck_assert_ptr_nonnull(n);
+        ck_assert_int_eq(list_add_back(l, n), 0);
+    }
+
+    // A freed node is handed out again.
+    n = list_get_ith(l, LEN);
+    ck_assert_int_eq(list_unlink_node(l, n), 0);
+    list_free_node(n);
+    ck_assert_ptr_eq(list_new_pooled_node(l, -1), n);
+    ck_assert_int_eq(list_add_front(l, n), 0);
+    ck_assert_int_eq(list_node_get_value(list_head(l)), -1);
+    ck_assert_uint_eq(list_length(l), 100 * LEN);
+
+    list_cleanup(l);
+}
+END_TEST
+
+START_TEST (test_pooled_mixed)
+{
+    struct list* l = list_init_pooled();
+    struct list* k = list_init();
+
+    // Nodes from outside the pool and pooled nodes in another list.
+    for (int i = 0; i < LEN; i++) {
+        list_add_back(l, list_new_node(i));
+        list_add_back(l, list_new_pooled_node(l, i));
+        list_add_back(k, list_new_pooled_node(l, i));
+    }
+    struct node* n = list_new_pooled_node(k, 5);
+    ck_assert_ptr_nonnull(n);
+    list_free_node(n);
+
+    list_index_build(l);
+    ck_assert_int_eq(list_node_get_value(list_get_ith(l, 2 * LEN - 1)),
+                     LEN - 1);
+
+    list_cleanup(k);
+    list_cleanup(l);
+}
+END_TEST
+
+START_TEST (test_pooled_cut)
+{
+    struct list* l = list_init_pooled();
+
+    for (int i = 0; i < 10 * LEN; i++) {
+        list_add_back(l, list_new_pooled_node(l, i));
+    }
+
+    struct list* k = list_cut_after(l, list_get_ith(l, LEN - 1));
+
+    // The second half shares the pool, which lives until both are gone.
+    list_cleanup(l);
+    ck_assert_int_eq(list_add_back(k, list_new_pooled_node(k, -1)), 0);
+    ck_assert_uint_eq(list_length(k), 9 * LEN + 1);
+    ck_assert_int_eq(list_node_get_value(list_head(k)), LEN);
+    ck_assert_int_eq(list_node_get_value(list_tail(k)), -1);
+
+    list_cleanup(k);
+}
+END_TEST
+
+START_TEST (test_sort_stable)
+{
+    struct list* l = list_init();
+    struct node* first[LEN];
+
+    // Runs in and against the order, with every number twice.
+    for (int i = 0; i < LEN; i++) {
+        first[i] = list_new_node(i % 2 ? i : LEN - i);
+        list_add_back(l, first[i]);
+    }
+    for (int i = 0; i < LEN; i++) {
+        list_add_back(l, list_new_node(i % 2 ? i : LEN - i));
+    }
+
+    ck_assert_int_eq(list_sort(l, 0), 0);
+    ck_assert_uint_eq(list_length(l), 2 * LEN);
+
+    // Equal numbers keep their order and the prev links follow the sort.
+    struct node* prev = NULL;
+    for (struct node* n = list_head(l); n != NULL; n = list_next(n)) {
+        if (prev != NULL) {
+            ck_assert(list_node_get_value(prev) <= list_node_get_value(n));
+            ck_assert_ptr_eq(list_prev(l, n), prev);
+        }
+        prev = n;
+    }
+    ck_assert_ptr_eq(list_tail(l), prev);
+    ck_assert_ptr_eq(list_next(list_get_ith(l, 0)), list_get_ith(l, 1));
+    // The first 2 of the list was node 8 of the first half.
+    ck_assert_ptr_eq(list_get_ith(l, 2), first[8]);
+
+    ck_assert_int_eq(list_sort(l, 1), 0);
+    ck_assert_int_eq(list_node_get_value(list_head(l)), LEN);
+    ck_assert_int_eq(list_node_get_value(list_tail(l)), 1);
+    ck_assert_int_eq(list_sort(NULL, 0), 1);
+
+    list_cleanup(l);
+}
+END_TEST
+
+START_TEST (test_sort_index)
+{
+    struct list* l = list_init_pooled();
+
+    for (int i = 0; i < 10 * LEN; i++) {
+        list_add_back(l, list_new_pooled_node(l, (i * 37) % (10 * LEN)));
+    }
+    list_add_back(l, list_new_node(-1));
+
+    // The index is rebuilt for the sorted order.
+    list_index_build(l);
+    ck_assert_int_eq(list_sort(l, 0), 0);
+
+    for (int i = 0; i <= 10 * LEN; i++) {
+        struct node* n = list_get_ith(l, (size_t) i);
+        ck_assert_int_eq(list_node_get_value(n), i - 1);
+        ck_assert_uint_eq(list_node_rank(l, n), (size_t) i);
+    }
+
+    struct node* n = list_new_pooled_node(l, -2);
+    ck_assert_int_eq(list_insert_at(l, n, 0), 0);
+    ck_assert_uint_eq(list_node_rank(l, list_tail(l)), 10 * LEN + 1);
+
+    list_cleanup(l);
+}
+END_TEST
+
 Suite * list_suite(void) {
     Suite *s;
     TCase *tc_core;
@@ -331,6 +654,21 @@ Suite * list_suite(void) {
     tcase_add_test(tc_core, test_insert_null);
     tcase_add_test(tc_core, test_insert_invalid);
 
+    tcase_add_test(tc_core, test_iter_walk);
+    tcase_add_test(tc_core, test_iter_insert);
+    tcase_add_test(tc_core, test_iter_invalid);
+
+    tcase_add_test(tc_core, test_index_ith);
+    tcase_add_test(tc_core, test_index_update);
+    tcase_add_test(tc_core, test_index_cut);
+
+    tcase_add_test(tc_core, test_pooled_reuse);
+    tcase_add_test(tc_core, test_pooled_mixed);
+    tcase_add_test(tc_core, test_pooled_cut);
+
+    tcase_add_test(tc_core, test_sort_stable);
+    tcase_add_test(tc_core, test_sort_index);
+
     suite_add_tcase(s, tc_core);
     return s;
 }
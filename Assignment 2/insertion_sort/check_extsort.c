@@ -0,0 +1,134 @@
+// Needed for fileno
+#define _POSIX_C_SOURCE 200809L
+
+#include <check.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "extsort.h"
+#include "output.h"
+
+/* Enough numbers for more runs than one merge pass takes at the smallest
+ * memory limit. */
+#define LEN 3000000
+
+/**
+ * Write len pseudo random numbers, with duplicates and both signs, to a
+ * temporary file.
+ *
+ * @param len the number of numbers.
+ * @return
+ */
+static FILE *random_input(size_t len) {
+    FILE *in = tmpfile();
+    ck_assert_ptr_ne(in, NULL);
+
+    uint32_t x = 12345;
+    for (size_t i = 0; i < len; i++) {
+        x = x * 1103515245u + 12345u;
+        fprintf(in, "%d\n", (int) x);
+    }
+    fprintf(in, "%d %d\n", INT_MIN, INT_MAX);
+    rewind(in);
+
+    return in;
+}
+
+/**
+ * Sort stream in to a temporary file and check that the len numbers in it
+ * are in order.
+ *
+ * @param in the stream.
+ * @param len the number of numbers.
+ * @param merge 1 for a merge sort of the runs, 0 for a radix sort.
+ * @param descending 1 for descending order, 0 for ascending order.
+ */
+static void check_external(FILE *in, size_t len, int merge, int descending) {
+    FILE *sorted = tmpfile();
+    ck_assert_ptr_ne(sorted, NULL);
+
+    struct output *out = output_init(fileno(sorted));
+    ck_assert_int_eq(external_sort(in, EXTERNAL_MIN_MEMORY, merge,
+                                   descending, out), 0);
+    ck_assert_int_eq(output_cleanup(out), 0);
+    rewind(sorted);
+
+    size_t count = 0;
+    long num;
+    long prev = descending ? LONG_MAX : LONG_MIN;
+    while (fscanf(sorted, "%ld", &num) == 1) {
+        ck_assert(descending ? prev >= num : prev <= num);
+        prev = num;
+        count++;
+    }
+    ck_assert_uint_eq(count, len);
+
+    fclose(sorted);
+}
+
+/* test runs that are spilled and merged in two passes */
+START_TEST(test_external_passes) {
+    FILE *in = random_input(LEN);
+    check_external(in, LEN + 2, 0, 0);
+
+    rewind(in);
+    check_external(in, LEN + 2, 1, 1);
+    fclose(in);
+}
+END_TEST
+
+/* test input that fits in a single run */
+START_TEST(test_external_single_run) {
+    FILE *in = random_input(1000);
+    check_external(in, 1002, 0, 1);
+    fclose(in);
+
+    in = tmpfile();
+    check_external(in, 0, 0, 0);
+    fclose(in);
+}
+END_TEST
+
+START_TEST(test_external_null) {
+    struct output *out = output_init(-1);
+    ck_assert_int_eq(external_sort(NULL, EXTERNAL_MIN_MEMORY, 0, 0, out), 1);
+    ck_assert_int_eq(external_sort(stdin, EXTERNAL_MIN_MEMORY, 0, 0, NULL),
+                     1);
+    ck_assert_int_eq(external_sort(stdin, EXTERNAL_MIN_MEMORY - 1, 0, 0,
+                                   out), 1);
+    ck_assert_int_eq(output_cleanup(out), 0);
+}
+END_TEST
+
+Suite *extsort_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("External sort");
+    tc_core = tcase_create("Core");
+
+    // Writing and sorting the input takes a few seconds with sanitizers.
+    tcase_set_timeout(tc_core, 60);
+    tcase_add_test(tc_core, test_external_passes);
+    tcase_add_test(tc_core, test_external_single_run);
+    tcase_add_test(tc_core, test_external_null);
+
+    suite_add_tcase(s, tc_core);
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = extsort_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,131 @@
+// Needed for fileno
+#define _POSIX_C_SOURCE 200809L
+
+#include <check.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "output.h"
+
+/**
+ * Write the len numbers of nums through a writer to a temporary file and
+ * read the text back.
+ *
+ * @param nums the numbers.
+ * @param len the number of numbers.
+ * @param size the length of the text.
+ * @return
+ */
+static char *write_numbers(const int *nums, size_t len, size_t *size) {
+    FILE *f = tmpfile();
+    ck_assert_ptr_ne(f, NULL);
+
+    struct output *o = output_init(fileno(f));
+    ck_assert_ptr_ne(o, NULL);
+    for (size_t i = 0; i < len; i++) {
+        ck_assert_int_eq(output_int(o, nums[i]), 0);
+    }
+    ck_assert_int_eq(output_cleanup(o), 0);
+
+    fseek(f, 0, SEEK_END);
+    *size = (size_t) ftell(f);
+    rewind(f);
+
+    char *text = malloc(*size + 1);
+    ck_assert_ptr_ne(text, NULL);
+    ck_assert_uint_eq(fread(text, 1, *size, f), *size);
+    text[*size] = '\0';
+    fclose(f);
+
+    return text;
+}
+
+/* test numbers of every length and the limits */
+START_TEST(test_output_format) {
+    int nums[] = { 0, 7, -7, 10, 99, -100, 12345, 999999999, 1000000000,
+                   INT_MAX, INT_MIN, INT_MIN + 1 };
+    size_t len = sizeof(nums) / sizeof(nums[0]);
+    char expected[256] = "";
+
+    for (size_t i = 0; i < len; i++) {
+        sprintf(expected + strlen(expected), "%d\n", nums[i]);
+    }
+
+    size_t size;
+    char *text = write_numbers(nums, len, &size);
+    ck_assert_str_eq(text, expected);
+    free(text);
+}
+END_TEST
+
+/* test output larger than the buffer */
+START_TEST(test_output_flush) {
+    size_t len = 3 * OUTPUT_BUFFER_SIZE / 8;
+    int *nums = malloc(len * sizeof(int));
+    ck_assert_ptr_ne(nums, NULL);
+
+    for (size_t i = 0; i < len; i++) {
+        nums[i] = (int) (i * 2654435761u);
+    }
+
+    size_t size;
+    char *text = write_numbers(nums, len, &size);
+    char *p = text;
+
+    for (size_t i = 0; i < len; i++) {
+        char *end;
+        ck_assert_int_eq((int) strtol(p, &end, 10), nums[i]);
+        ck_assert_int_eq(*end, '\n');
+        p = end + 1;
+    }
+    ck_assert_uint_eq((size_t) (p - text), size);
+
+    free(text);
+    free(nums);
+}
+END_TEST
+
+START_TEST(test_output_null) {
+    ck_assert_int_eq(output_int(NULL, 1), 1);
+    ck_assert_int_eq(output_flush(NULL), 1);
+    ck_assert_int_eq(output_cleanup(NULL), 1);
+
+    // Writing to a closed file descriptor fails.
+    struct output *o = output_init(-1);
+    ck_assert_ptr_ne(o, NULL);
+    ck_assert_int_eq(output_int(o, 1), 0);
+    ck_assert_int_eq(output_flush(o), 1);
+    ck_assert_int_eq(output_cleanup(o), 1);
+}
+END_TEST
+
+Suite *output_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Output");
+    tc_core = tcase_create("Core");
+
+    tcase_add_test(tc_core, test_output_format);
+    tcase_add_test(tc_core, test_output_flush);
+    tcase_add_test(tc_core, test_output_null);
+
+    suite_add_tcase(s, tc_core);
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = output_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
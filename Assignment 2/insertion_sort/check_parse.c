@@ -0,0 +1,172 @@
+#include <check.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parse.h"
+#include "ulist.h"
+
+/**
+ * Parse text with parse_numbers through a temporary file.
+ *
+ * @param text the input.
+ * @param size the length of the input.
+ * @return
+ */
+static struct ulist *parse_text(const char *text, size_t size) {
+    FILE *in = tmpfile();
+    ck_assert_ptr_ne(in, NULL);
+    ck_assert_uint_eq(fwrite(text, 1, size, in), size);
+    rewind(in);
+
+    struct ulist *u = ulist_init();
+    ck_assert_int_eq(parse_numbers(in, u), 0);
+    fclose(in);
+
+    return u;
+}
+
+/**
+ * Check that list u holds the len numbers of expected and free it.
+ *
+ * @param u the list.
+ * @param expected the numbers.
+ * @param len the number of numbers.
+ */
+static void check_numbers(struct ulist *u, const int *expected, size_t len) {
+    ck_assert_uint_eq(ulist_length(u), len);
+
+    int num;
+    for (size_t i = 0; i < len; i++) {
+        ck_assert_int_eq(ulist_get(u, i, &num), 0);
+        ck_assert_int_eq(num, expected[i]);
+    }
+
+    ck_assert_int_eq(ulist_cleanup(u), 0);
+}
+
+/* test digits of every length and signs */
+START_TEST(test_parse_signs) {
+    const char *text = "1 -22 +333 4444\n55555 -666666 7777777 -88888888\n"
+                       "123456789 -1234567890 0 -0 007";
+    int expected[] = { 1, -22, 333, 4444, 55555, -666666, 7777777,
+                       -88888888, 123456789, -1234567890, 0, 0, 7 };
+
+    check_numbers(parse_text(text, strlen(text)), expected, 13);
+}
+END_TEST
+
+/* test that every other byte separates numbers */
+START_TEST(test_parse_separators) {
+    const char *text = "\t12\r\n-3x4--5 - 6+-7,8-";
+    int expected[] = { 12, -3, 4, -5, 6, -7, 8 };
+
+    check_numbers(parse_text(text, strlen(text)), expected, 7);
+    check_numbers(parse_text("", 0), NULL, 0);
+    check_numbers(parse_text(" -\n+", 4), NULL, 0);
+}
+END_TEST
+
+/* test numbers that straddle the end of a block */
+START_TEST(test_parse_block_boundary) {
+    size_t size = 2 * PARSE_BLOCK_SIZE + 16;
+    char *text = malloc(size);
+    ck_assert_ptr_ne(text, NULL);
+    memset(text, ' ', size);
+
+    // A sign at the end of the first block, digits at the end of the second.
+    text[PARSE_BLOCK_SIZE - 1] = '-';
+    memcpy(text + PARSE_BLOCK_SIZE, "42", 2);
+    memcpy(text + 2 * PARSE_BLOCK_SIZE - 5, "123456789", 9);
+
+    int expected[] = { -42, 123456789 };
+    check_numbers(parse_text(text, size), expected, 2);
+    free(text);
+}
+END_TEST
+
+/* test numbers outside the range of an int */
+START_TEST(test_parse_range) {
+    const char *text = "2147483647 -2147483648 4294967297 "
+                       "99999999999999999999999 -99999999999999999999999";
+    int expected[] = { INT_MAX, INT_MIN, (int) 4294967297L,
+                       (int) LONG_MAX, (int) LONG_MIN };
+
+    check_numbers(parse_text(text, strlen(text)), expected, 5);
+}
+END_TEST
+
+/* test reading in batches that end inside a number or a block */
+START_TEST(test_parser_read) {
+    size_t len = 20000;
+    FILE *in = tmpfile();
+    ck_assert_ptr_ne(in, NULL);
+    for (size_t i = 0; i < len; i++) fprintf(in, "%d\n", (int) i - 10000);
+    rewind(in);
+
+    struct parser *p = parser_init(in);
+    ck_assert_ptr_ne(p, NULL);
+
+    int nums[7];
+    size_t count;
+    size_t total = 0;
+    do {
+        ck_assert_int_eq(parser_read(p, nums, 7, &count), 0);
+        for (size_t i = 0; i < count; i++) {
+            ck_assert_int_eq(nums[i], (int) (total + i) - 10000);
+        }
+        total += count;
+    } while (count == 7);
+    ck_assert_uint_eq(total, len);
+
+    ck_assert_int_eq(parser_read(p, nums, 7, &count), 0);
+    ck_assert_uint_eq(count, 0);
+
+    parser_cleanup(p);
+    fclose(in);
+}
+END_TEST
+
+START_TEST(test_parse_null) {
+    struct ulist *u = ulist_init();
+    ck_assert_int_eq(parse_numbers(NULL, u), 1);
+    ck_assert_int_eq(parse_numbers(stdin, NULL), 1);
+    ck_assert_ptr_eq(parser_init(NULL), NULL);
+    ck_assert_int_eq(parser_read(NULL, NULL, 0, NULL), 1);
+    parser_cleanup(NULL);
+    ck_assert_int_eq(ulist_cleanup(u), 0);
+}
+END_TEST
+
+Suite *parse_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Parse");
+    tc_core = tcase_create("Core");
+
+    tcase_add_test(tc_core, test_parse_signs);
+    tcase_add_test(tc_core, test_parse_separators);
+    tcase_add_test(tc_core, test_parse_block_boundary);
+    tcase_add_test(tc_core, test_parse_range);
+    tcase_add_test(tc_core, test_parser_read);
+    tcase_add_test(tc_core, test_parse_null);
+
+    suite_add_tcase(s, tc_core);
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = parse_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
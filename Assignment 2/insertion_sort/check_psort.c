@@ -0,0 +1,204 @@
+#include <check.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "psort.h"
+#include "ulist.h"
+
+#define LEN 10000
+
+/**
+ * Fill the list u with len pseudo random numbers, with duplicates and
+ * both signs.
+ *
+ * @param u the list.
+ * @param len the number of numbers.
+ */
+static void fill_random(struct ulist *u, size_t len) {
+    uint32_t x = 12345;
+
+    for (size_t i = 0; i < len; i++) {
+        x = x * 1103515245u + 12345u;
+        ck_assert_int_eq(ulist_add_back(u, (int) (x % 2000) - 1000), 0);
+    }
+
+    ck_assert_int_eq(ulist_add_back(u, INT_MIN), 0);
+    ck_assert_int_eq(ulist_add_back(u, INT_MAX), 0);
+}
+
+/**
+ * Check that the len numbers of list u are in order and sum to sum.
+ *
+ * @param u the list.
+ * @param len the number of numbers.
+ * @param descending 1 for descending order, 0 for ascending order.
+ * @param sum the sum of the numbers.
+ */
+static void check_sorted(struct ulist *u, size_t len, int descending,
+                         int64_t sum) {
+    ck_assert_uint_eq(ulist_length(u), len);
+
+    struct ulist_iter it;
+    int *num;
+    int *prev = NULL;
+    int64_t total = 0;
+
+    ulist_iter_begin(&it, u);
+    while ((num = ulist_iter_next(&it)) != NULL) {
+        if (prev != NULL) {
+            ck_assert(descending ? *prev >= *num : *prev <= *num);
+        }
+        total += *num;
+        prev = num;
+    }
+
+    ck_assert(total == sum);
+}
+
+/**
+ * Get the sum of the numbers of list u.
+ *
+ * @param u the list.
+ * @return
+ */
+static int64_t sum_of(struct ulist *u) {
+    struct ulist_iter it;
+    int *num;
+    int64_t total = 0;
+
+    ulist_iter_begin(&it, u);
+    while ((num = ulist_iter_next(&it)) != NULL) total += *num;
+
+    return total;
+}
+
+/* test the sorts of keys, also with runs of unequal length */
+START_TEST(test_sort_keys) {
+    size_t lens[] = { 0, 1, 31, 33, 100, 1000 };
+    uint32_t keys[1000];
+    uint32_t scratch[1000];
+
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        for (int merge = 0; merge <= 1; merge++) {
+            for (size_t i = 0; i < lens[l]; i++) {
+                keys[i] = (uint32_t) (i * 2654435761u) ^ (uint32_t) (i % 7);
+            }
+
+            uint32_t *sorted = merge
+                ? merge_sort_keys(keys, scratch, lens[l])
+                : radix_sort_keys(keys, scratch, lens[l]);
+            ck_assert(sorted == keys || sorted == scratch);
+
+            for (size_t i = 1; i < lens[l]; i++) {
+                ck_assert(sorted[i - 1] <= sorted[i]);
+            }
+        }
+    }
+}
+END_TEST
+
+/* test a loser tree over sources of unequal length */
+START_TEST(test_loser_tree) {
+    uint64_t sources[5][3] = {
+        { 1, 4, LOSER_TREE_EXHAUSTED },
+        { 2, 2, 9 },
+        { LOSER_TREE_EXHAUSTED },
+        { 0, LOSER_TREE_EXHAUSTED },
+        { 3, 5, 8 },
+    };
+    uint64_t expected[] = { 0, 1, 2, 2, 3, 4, 5, 8, 9 };
+    size_t pos[5] = { 0 };
+
+    struct loser_tree *lt = loser_tree_init(5);
+    ck_assert_ptr_ne(lt, NULL);
+    for (size_t i = 0; i < 5; i++) lt->heads[i] = sources[i][0];
+
+    size_t winner = loser_tree_build(lt);
+    for (size_t i = 0; i < 9; i++) {
+        ck_assert(lt->heads[winner] == expected[i]);
+        pos[winner]++;
+        lt->heads[winner] = pos[winner] < 3 ? sources[winner][pos[winner]]
+                                            : LOSER_TREE_EXHAUSTED;
+        winner = loser_tree_replay(lt);
+    }
+    ck_assert(lt->heads[winner] == LOSER_TREE_EXHAUSTED);
+
+    loser_tree_cleanup(lt);
+    ck_assert_ptr_eq(loser_tree_init(0), NULL);
+}
+END_TEST
+
+/* test every combination of jobs, sort and order written back */
+START_TEST(test_parallel_sort) {
+    size_t jobs[] = { 1, 2, 3, 8 };
+
+    for (size_t j = 0; j < sizeof(jobs) / sizeof(jobs[0]); j++) {
+        for (int merge = 0; merge <= 1; merge++) {
+            for (int descending = 0; descending <= 1; descending++) {
+                struct ulist *u = ulist_init();
+                fill_random(u, LEN);
+                int64_t sum = sum_of(u);
+
+                ck_assert_int_eq(parallel_sort(u, jobs[j], merge, descending,
+                                               NULL), 0);
+                check_sorted(u, LEN + 2, descending, sum);
+                ck_assert_int_eq(ulist_cleanup(u), 0);
+            }
+        }
+    }
+}
+END_TEST
+
+/* test more jobs than numbers and an empty list */
+START_TEST(test_parallel_small) {
+    struct ulist *u = ulist_init();
+    ck_assert_int_eq(parallel_sort(u, 4, 0, 0, NULL), 0);
+    ck_assert_uint_eq(ulist_length(u), 0);
+
+    ck_assert_int_eq(ulist_add_back(u, 3), 0);
+    ck_assert_int_eq(ulist_add_back(u, -1), 0);
+    ck_assert_int_eq(parallel_sort(u, 16, 1, 0, NULL), 0);
+
+    int num;
+    ck_assert_int_eq(ulist_get(u, 0, &num), 0);
+    ck_assert_int_eq(num, -1);
+    ck_assert_int_eq(ulist_get(u, 1, &num), 0);
+    ck_assert_int_eq(num, 3);
+
+    ck_assert_int_eq(parallel_sort(u, 0, 0, 0, NULL), 1);
+    ck_assert_int_eq(parallel_sort(NULL, 2, 0, 0, NULL), 1);
+    ck_assert_int_eq(ulist_cleanup(u), 0);
+}
+END_TEST
+
+Suite *psort_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Parallel sort");
+    tc_core = tcase_create("Core");
+
+    tcase_add_test(tc_core, test_sort_keys);
+    tcase_add_test(tc_core, test_loser_tree);
+    tcase_add_test(tc_core, test_parallel_sort);
+    tcase_add_test(tc_core, test_parallel_small);
+
+    suite_add_tcase(s, tc_core);
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = psort_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
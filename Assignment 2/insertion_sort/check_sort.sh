@@ -9,28 +9,33 @@ tests=`find tests/*.txt`
 
 trap "rm -f $prog_output" EXIT
 
-for t in $tests
+# Every test runs with insertion sort, merge sort (-m), radix sort (-r),
+# a parallel sort on three threads (-j 3) and an external sort
+for opts in "" "-m" "-r" "-j 3" "--mem-limit 1M"
 do
-    echo -n "testing: $t: "
-    $PROG < $t > $prog_output
-    ret="$?"
-    if [[ "ret" -ne 0 ]];
-    then
-        echo "FAILED"
-        echo "$PROG returned exit code $ret"
-        continue
-    fi
-    if diff -q $prog_output ${t%.*}.out > /dev/null;
-    then
-        echo "OK"
-    else
-        if diff -qwB $prog_output ${t%.*}.out > /dev/null;
+    for t in $tests
+    do
+        echo -n "testing: $t${opts:+ ($opts)}: "
+        $PROG $opts < $t > $prog_output
+        ret="$?"
+        if [[ "ret" -ne 0 ]];
         then
-            echo "OK (apart from whitespace)"
-        else
             echo "FAILED"
+            echo "$PROG returned exit code $ret"
+            continue
+        fi
+        if diff -q $prog_output ${t%.*}.out > /dev/null;
+        then
+            echo "OK"
+        else
+            if diff -qwB $prog_output ${t%.*}.out > /dev/null;
+            then
+                echo "OK (apart from whitespace)"
+            else
+                echo "FAILED"
+            fi
         fi
-    fi
+    done
 done
 
 rm -f $prog_output
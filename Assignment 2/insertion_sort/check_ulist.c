@@ -0,0 +1,170 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ulist.h"
+
+// For older versions of the check library
+#ifndef ck_assert_ptr_nonnull
+#define ck_assert_ptr_nonnull(X) _ck_assert_ptr(X, !=, NULL)
+#endif
+#ifndef ck_assert_ptr_null
+#define ck_assert_ptr_null(X) _ck_assert_ptr(X, ==, NULL);
+#endif
+
+#define LEN 1000
+
+/* test init, add & get */
+START_TEST(test_add_back) {
+    struct ulist *u = ulist_init();
+    ck_assert_ptr_nonnull(u);
+
+    for (int i = 0; i < LEN; i++) {
+        ck_assert_int_eq(ulist_add_back(u, i), 0);
+    }
+    ck_assert_uint_eq(ulist_length(u), LEN);
+
+    int num;
+    for (int i = 0; i < LEN; i++) {
+        ck_assert_int_eq(ulist_get(u, (size_t) i, &num), 0);
+        ck_assert_int_eq(num, i);
+    }
+    ck_assert_int_eq(ulist_get(u, LEN, &num), 1);
+
+    ck_assert_int_eq(ulist_cleanup(u), 0);
+}
+END_TEST
+
+/* test the cursor, also writing through it */
+START_TEST(test_iter) {
+    struct ulist *u = ulist_init();
+    struct ulist_iter it;
+    int *num;
+
+    ulist_iter_begin(&it, u);
+    ck_assert_ptr_null(ulist_iter_next(&it));
+
+    for (int i = 0; i < LEN; i++) ulist_add_back(u, i);
+
+    ulist_iter_begin(&it, u);
+    for (int i = 0; i < LEN; i++) {
+        num = ulist_iter_next(&it);
+        ck_assert_ptr_nonnull(num);
+        ck_assert_int_eq(*num, i);
+        *num = -i;
+    }
+    ck_assert_ptr_null(ulist_iter_next(&it));
+
+    int last;
+    ck_assert_int_eq(ulist_get(u, LEN - 1, &last), 0);
+    ck_assert_int_eq(last, -(LEN - 1));
+
+    ulist_cleanup(u);
+}
+END_TEST
+
+/* test inserts that split blocks, at the front, middle and back */
+START_TEST(test_insert_split) {
+    struct ulist *u = ulist_init();
+
+    // Builds 0 .. 2 * LEN - 1 with the odd numbers inserted between.
+    for (int i = 0; i < LEN; i++) ulist_add_back(u, 2 * i);
+    for (int i = 0; i < LEN; i++) {
+        size_t odd = (size_t) (2 * i + 1);
+        ck_assert_int_eq(ulist_insert_at(u, odd, 2 * i + 1), 0);
+    }
+    ck_assert_int_eq(ulist_insert_at(u, 0, -1), 0);
+    ck_assert_int_eq(ulist_insert_at(u, 2 * LEN + 2, 0), 1);
+
+    int num;
+    for (int i = -1; i < 2 * LEN; i++) {
+        ck_assert_int_eq(ulist_get(u, (size_t) (i + 1), &num), 0);
+        ck_assert_int_eq(num, i);
+    }
+
+    ulist_cleanup(u);
+}
+END_TEST
+
+/* test removes that merge and free blocks */
+START_TEST(test_remove_merge) {
+    struct ulist *u = ulist_init();
+
+    for (int i = 0; i < LEN; i++) ulist_add_back(u, i);
+
+    // Remove the odd numbers, from the back so the positions stay valid.
+    for (int i = LEN - 1; i >= 0; i--) {
+        if (i % 2) ck_assert_int_eq(ulist_remove_at(u, (size_t) i), 0);
+    }
+    ck_assert_uint_eq(ulist_length(u), LEN / 2);
+
+    struct ulist_iter it;
+    int *num;
+    int expected = 0;
+    ulist_iter_begin(&it, u);
+    while ((num = ulist_iter_next(&it)) != NULL) {
+        ck_assert_int_eq(*num, expected);
+        expected += 2;
+    }
+    ck_assert_int_eq(expected, LEN);
+
+    while (ulist_length(u) > 0) {
+        ck_assert_int_eq(ulist_remove_at(u, ulist_length(u) / 2), 0);
+    }
+    ck_assert_int_eq(ulist_remove_at(u, 0), 1);
+
+    // The emptied list can be filled again.
+    ck_assert_int_eq(ulist_add_back(u, 7), 0);
+    ck_assert_int_eq(ulist_set(u, 0, 8), 0);
+    ck_assert_int_eq(ulist_get(u, 0, &expected), 0);
+    ck_assert_int_eq(expected, 8);
+
+    ulist_cleanup(u);
+}
+END_TEST
+
+/* test NULL pointers */
+START_TEST(test_ulist_null) {
+    int num;
+
+    ck_assert_int_eq(ulist_cleanup(NULL), 1);
+    ck_assert_uint_eq(ulist_length(NULL), 0);
+    ck_assert_int_eq(ulist_add_back(NULL, 1), 1);
+    ck_assert_int_eq(ulist_insert_at(NULL, 0, 1), 1);
+    ck_assert_int_eq(ulist_remove_at(NULL, 0), 1);
+    ck_assert_int_eq(ulist_get(NULL, 0, &num), 1);
+    ck_assert_int_eq(ulist_set(NULL, 0, 1), 1);
+    ck_assert_ptr_null(ulist_iter_next(NULL));
+}
+END_TEST
+
+Suite *ulist_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Unrolled list");
+    tc_core = tcase_create("Core");
+
+    tcase_add_test(tc_core, test_add_back);
+    tcase_add_test(tc_core, test_iter);
+    tcase_add_test(tc_core, test_insert_split);
+    tcase_add_test(tc_core, test_remove_merge);
+    tcase_add_test(tc_core, test_ulist_null);
+
+    suite_add_tcase(s, tc_core);
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = ulist_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
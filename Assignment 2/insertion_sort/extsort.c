@@ -0,0 +1,321 @@
+/*H**********************************************************************
+* FILENAME: extsort.c
+*
+* DESCRIPTION:
+*   External sort with runs spilled to temporary files and a multi-way
+*   merge.
+*
+* PUBLIC FUNCTIONS:
+*   int external_sort( in, mem_limit, merge, descending, out )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 09-11-2023
+*
+*H*/
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "extsort.h"
+#include "output.h"
+#include "parse.h"
+#include "psort.h"
+
+/* A spilled run that is being merged, read through its buffer. */
+struct run {
+    FILE *file;
+    uint32_t *buffer;
+    size_t capacity;
+    size_t pos;
+    size_t size;
+};
+
+/* The state of an external sort. The arena holds the keys and scratch
+ * room of a run and later the buffers of a merge. The files of the
+ * spilled runs that are not merged yet are files[first] to files[count]. */
+struct external {
+    uint32_t *arena;
+    size_t arena_keys;
+    uint32_t flip;
+    struct output *out;
+    FILE **files;
+    size_t first;
+    size_t count;
+    size_t capacity;
+};
+
+/**
+ * Convert key to the number it was made of.
+ *
+ * @param ext the sort.
+ * @param key the key.
+ * @return
+ */
+static int key_to_num(const struct external *ext, uint32_t key) {
+    return (int) ((int64_t) (key ^ ext->flip) + INT_MIN);
+}
+
+/**
+ * Add file to the spilled runs. Return 0 if successful else 1.
+ *
+ * @param ext the sort.
+ * @param file the file of the run.
+ * @return
+ */
+static int add_file(struct external *ext, FILE *file) {
+    if (ext->count == ext->capacity) {
+        size_t capacity = ext->capacity ? ext->capacity * 2 : 16;
+        FILE **grown = realloc(ext->files, sizeof(FILE *) * capacity);
+
+        if (grown == NULL) return 1;
+
+        ext->files = grown;
+        ext->capacity = capacity;
+    }
+
+    ext->files[ext->count++] = file;
+
+    return 0;
+}
+
+/**
+ * Create a temporary file without a stdio buffer, since it is only read
+ * and written in large blocks. Return NULL if it could not be created.
+ *
+ * @return
+ */
+static FILE *temp_file(void) {
+    FILE *file = tmpfile();
+
+    if (file != NULL) setvbuf(file, NULL, _IONBF, 0);
+
+    return file;
+}
+
+/**
+ * Write the length keys to a new run file. Return 0 if successful else 1.
+ *
+ * @param ext the sort.
+ * @param keys the sorted keys.
+ * @param length the number of keys.
+ * @return
+ */
+static int spill(struct external *ext, const uint32_t *keys, size_t length) {
+    FILE *file = temp_file();
+
+    if (file == NULL) return 1;
+
+    if (fwrite(keys, sizeof(uint32_t), length, file) != length
+        || add_file(ext, file) != 0) {
+        fclose(file);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Read the next block of run r into its buffer. Return 0 if successful
+ * else 1.
+ *
+ * @param r the run.
+ * @return
+ */
+static int fill(struct run *r) {
+    r->pos = 0;
+    r->size = fread(r->buffer, sizeof(uint32_t), r->capacity, r->file);
+
+    return ferror(r->file) != 0;
+}
+
+/**
+ * Get the next key of run r, or LOSER_TREE_EXHAUSTED if it has none.
+ *
+ * @param r the run.
+ * @return
+ */
+static uint64_t head_key(const struct run *r) {
+    return r->pos < r->size ? r->buffer[r->pos] : LOSER_TREE_EXHAUSTED;
+}
+
+/**
+ * Merge the k runs from files[first] with a loser tree into a new run
+ * file, or to the output if dest is 0. The arena is split into a buffer
+ * for every run and one for the new run. Return 0 if successful else 1.
+ *
+ * @param ext the sort.
+ * @param k the number of runs.
+ * @param dest 1 to merge into a new run, 0 to merge to the output.
+ * @return
+ */
+static int merge_files(struct external *ext, size_t k, int dest) {
+    size_t capacity = ext->arena_keys / (k + (size_t) dest);
+    struct run *runs = malloc(sizeof(struct run) * k);
+    struct loser_tree *lt = loser_tree_init(k);
+    FILE *file = dest ? temp_file() : NULL;
+    uint32_t *merged = ext->arena + k * capacity;
+    size_t used = 0;
+    int error = runs == NULL || lt == NULL || (dest && file == NULL);
+
+    for (size_t i = 0; !error && i < k; i++) {
+        runs[i] = (struct run) {
+            ext->files[ext->first + i], ext->arena + i * capacity, capacity,
+            0, 0
+        };
+        rewind(runs[i].file);
+        error = fill(&runs[i]);
+        lt->heads[i] = head_key(&runs[i]);
+    }
+
+    size_t winner = error ? 0 : loser_tree_build(lt);
+
+    while (!error && lt->heads[winner] != LOSER_TREE_EXHAUSTED) {
+        uint32_t key = (uint32_t) lt->heads[winner];
+        struct run *r = &runs[winner];
+
+        if (!dest) {
+            error = output_int(ext->out, key_to_num(ext, key));
+        } else {
+            merged[used++] = key;
+
+            if (used == capacity) {
+                error = fwrite(merged, sizeof(uint32_t), used, file) != used;
+                used = 0;
+            }
+        }
+
+        if (++r->pos == r->size && fill(r) != 0) error = 1;
+
+        lt->heads[winner] = head_key(r);
+        winner = loser_tree_replay(lt);
+    }
+
+    if (!error && dest) {
+        error = fwrite(merged, sizeof(uint32_t), used, file) != used
+                || add_file(ext, file) != 0;
+    }
+
+    if (error && file != NULL) fclose(file);
+
+    // The merged runs are removed when their files are closed.
+    for (size_t i = 0; i < k; i++) fclose(ext->files[ext->first + i]);
+
+    ext->first += k;
+
+    free(runs);
+    loser_tree_cleanup(lt);
+
+    return error;
+}
+
+/**
+ * Merge the spilled runs in passes of at most fan_in runs, so every run
+ * gets a buffer of at least MERGE_BUFFER_SIZE bytes, and the last pass to
+ * the output. Return 0 if successful else 1.
+ *
+ * @param ext the sort.
+ * @return
+ */
+static int merge_all(struct external *ext) {
+    size_t fan_in = ext->arena_keys / (MERGE_BUFFER_SIZE / sizeof(uint32_t));
+
+    // A pass into a new run also needs a buffer for the new run.
+    fan_in = fan_in > 3 ? fan_in - 1 : 2;
+
+    while (ext->count - ext->first > fan_in) {
+        if (merge_files(ext, fan_in, 1) != 0) return 1;
+    }
+
+    return merge_files(ext, ext->count - ext->first, 0);
+}
+
+/**
+ * Read the stream in runs of half the arena, sort every run in place with
+ * the other half as scratch room and spill it. A stream that ends in the
+ * first run is written to the output directly.
+ *
+ * @param ext the sort.
+ * @param in the stream.
+ * @param merge 1 for a merge sort of the runs, 0 for a radix sort.
+ * @return
+ */
+static int sort_runs(struct external *ext, FILE *in, int merge) {
+    struct parser *p = parser_init(in);
+    size_t run_keys = ext->arena_keys / 2;
+    uint32_t *keys = ext->arena;
+    uint32_t *scratch = ext->arena + run_keys;
+    size_t length = run_keys;
+    int error = p == NULL;
+
+    while (!error && length == run_keys) {
+        // The numbers are read into the key array and converted in place.
+        int *nums = (int *) keys;
+
+        error = parser_read(p, nums, run_keys, &length);
+
+        if (error || length == 0) break;
+
+        for (size_t i = 0; i < length; i++) {
+            keys[i] = (uint32_t) ((int64_t) nums[i] - INT_MIN) ^ ext->flip;
+        }
+
+        uint32_t *sorted = merge ? merge_sort_keys(keys, scratch, length)
+                                 : radix_sort_keys(keys, scratch, length);
+
+        if (length < run_keys && ext->count == 0) {
+            for (size_t i = 0; !error && i < length; i++) {
+                error = output_int(ext->out, key_to_num(ext, sorted[i]));
+            }
+        } else {
+            error = spill(ext, sorted, length);
+        }
+    }
+
+    parser_cleanup(p);
+
+    return error;
+}
+
+/**
+ * Sort the stream in spilled runs and merge them to the output.
+ *
+ * @param in the stream.
+ * @param mem_limit the memory limit in bytes.
+ * @param merge 1 for a merge sort of the runs, 0 for a radix sort.
+ * @param descending 1 for descending order, 0 for ascending order.
+ * @param out the writer.
+ * @return
+ */
+int external_sort(FILE *in, size_t mem_limit, int merge, int descending,
+                  struct output *out) {
+    if (in == NULL || out == NULL || mem_limit < EXTERNAL_MIN_MEMORY) {
+        return 1;
+    }
+
+    // The parser and the writer have a buffer of their own.
+    size_t arena_size = mem_limit - PARSE_BLOCK_SIZE - OUTPUT_BUFFER_SIZE;
+
+    // Inverted keys sort in descending order of the numbers.
+    struct external ext = {
+        .arena_keys = arena_size / sizeof(uint32_t),
+        .flip = descending ? UINT32_MAX : 0,
+        .out = out,
+    };
+
+    ext.arena = malloc(sizeof(uint32_t) * ext.arena_keys);
+
+    int error = ext.arena == NULL || sort_runs(&ext, in, merge) != 0;
+
+    if (!error && ext.count > 0) error = merge_all(&ext);
+
+    // Runs that were not merged after an error.
+    for (size_t i = ext.first; i < ext.count; i++) fclose(ext.files[i]);
+
+    free(ext.files);
+    free(ext.arena);
+
+    return error;
+}
@@ -0,0 +1,27 @@
+/* External sort of the integers of a text stream that may not fit in
+ * memory. The stream is read in runs that fill half of the memory limit.
+ * Every run is sorted as unsigned keys and spilled to a temporary file as
+ * 4 bytes per number. The runs are merged with a loser tree, through read
+ * buffers that share the memory of the runs, in several passes if there
+ * are too many runs for buffers of MERGE_BUFFER_SIZE bytes. */
+
+#include <stddef.h>
+#include <stdio.h>
+
+/* Output data structure declaration. */
+struct output;
+
+/* Smallest memory limit in bytes. */
+#define EXTERNAL_MIN_MEMORY (1 << 20)
+
+/* Smallest buffer in bytes for every run of a merge. */
+#define MERGE_BUFFER_SIZE (1 << 16)
+
+/* Sorts the numbers of stream IN in runs that fit in MEM_LIMIT bytes, with
+ * a merge sort if MERGE is 1 and a radix sort otherwise, in descending
+ * order if DESCENDING is 1, and writes them to OUT. An input that fits in
+ * a single run is not spilled.
+ * Returns 0 if successful, 1 if there was no memory or reading or writing
+ * failed. */
+int external_sort(FILE *in, size_t mem_limit, int merge, int descending,
+                  struct output *out);
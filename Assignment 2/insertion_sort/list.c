@@ -6,7 +6,9 @@
 *
 * PUBLIC FUNCTIONS:
 *   struct list *list_init(void)
+*   struct list *list_init_pooled(void)
 *   struct node *list_new_node( num )
+*   struct node *list_new_pooled_node( l, num )
 *   struct node *list_head( l )
 *   struct node *list_next( n )
 *   int list_add_front( l, n )
@@ -24,6 +26,18 @@
 *   size_t list_length( l )
 *   struct node *list_get_ith( l, i )
 *   struct list *list_cut_after( l, n )
+*   void list_iter_begin( it, l )
+*   void list_iter_end( it, l )
+*   int list_iter_at( it, l, n )
+*   struct node *list_iter_node( it )
+*   int list_iter_next( it )
+*   int list_iter_prev( it )
+*   int list_iter_insert( it, n )
+*   int list_index_build( l )
+*   void list_index_drop( l )
+*   int list_insert_at( l, n, i )
+*   size_t list_node_rank( l, n )
+*   int list_sort( l, descending )
 *
 * AUTHOR: Thom Kok (Student nr: 15316491)
 *
@@ -31,24 +45,279 @@
 *
 *H*/
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "list.h"
+#include "list_ext.h"
+
+/* Number of levels of an index above the list itself. */
+#define INDEX_MAX_LEVEL 32
+
+/* Number of nodes in the first slab of a pool. Every next slab is twice
+ * as large, up to POOL_MAX_SLAB nodes. */
+#define POOL_FIRST_SLAB 64
+#define POOL_MAX_SLAB 65536
+
+/* Link of a node at one level of an index, with the number of positions
+ * from the node to the next node at that level. */
+struct skip_link {
+    struct node *next;
+    struct node *prev;
+    size_t width;
+};
 
 struct node {
     struct list *list;
     struct node *next;
     struct node *prev;
     int num;
+    int height;
+    struct skip_link *links;
+    struct node_pool *pool;
+};
+
+/* Block of contiguous nodes of a pool, of which the first 'used' were
+ * handed out. */
+struct slab {
+    struct slab *next;
+    size_t capacity;
+    size_t used;
+    struct node nodes[];
+};
+
+/* Nodes of a pooled list. Freed nodes are kept in a free list linked
+ * through their next pointers and handed out again first. The pool is
+ * shared by the lists cut from its list, and is released with its slabs
+ * when the last of them is cleaned up. */
+struct node_pool {
+    struct slab *slabs;
+    struct node *free;
+    size_t refs;
+};
+
+/* Indexable skip list over the nodes of a list. Level 0 is the list
+ * itself. A node of height h also takes part in levels 1 to h, with its
+ * link at level k in links[k - 1]. The head is a sentinel at position 0,
+ * before the first node, that takes part in every level. */
+struct list_index {
+    struct node head;
+    struct skip_link head_links[INDEX_MAX_LEVEL];
+    int level;
+    uint64_t seed;
 };
 
 struct list {
     struct node *head;
     struct node *tail;
     size_t length;
+    struct list_index *index;
+    struct node_pool *pool;
+    size_t foreign;
 };
 
+/**
+ * Take a node from pool, from the free list or else from the last slab.
+ * A full slab is followed by a new slab. Return NULL on failure.
+ *
+ * @param pool the pool.
+ * @return
+ */
+static struct node *pool_take(struct node_pool *pool) {
+    struct node *n = pool->free;
+
+    if (n != NULL) {
+        pool->free = n->next;
+
+        return n;
+    }
+
+    struct slab *s = pool->slabs;
+
+    if (s == NULL || s->used == s->capacity) {
+        size_t capacity = s == NULL ? POOL_FIRST_SLAB : s->capacity * 2;
+
+        if (capacity > POOL_MAX_SLAB) capacity = POOL_MAX_SLAB;
+
+        s = malloc(sizeof(struct slab) + sizeof(struct node) * capacity);
+
+        if (s == NULL) return NULL;
+
+        s->next = pool->slabs;
+        s->capacity = capacity;
+        s->used = 0;
+        pool->slabs = s;
+    }
+
+    return &s->nodes[s->used++];
+}
+
+/**
+ * Drop a reference to pool and free its slabs with the last one.
+ *
+ * @param pool the pool.
+ */
+static void pool_release(struct node_pool *pool) {
+    if (pool == NULL || --pool->refs > 0) return;
+
+    while (pool->slabs != NULL) {
+        struct slab *next = pool->slabs->next;
+
+        free(pool->slabs);
+        pool->slabs = next;
+    }
+
+    free(pool);
+}
+
+/**
+ * Draw the height of a new node of index idx: 1 with chance 1/2, 2 with
+ * chance 1/4, and so on.
+ *
+ * @param idx the index.
+ * @return
+ */
+static int index_height(struct list_index *idx) {
+    idx->seed ^= idx->seed << 13;
+    idx->seed ^= idx->seed >> 7;
+    idx->seed ^= idx->seed << 17;
+
+    uint64_t bits = idx->seed;
+    int height = 0;
+
+    while ((bits & 1) && height < INDEX_MAX_LEVEL) {
+        height++;
+        bits >>= 1;
+    }
+
+    return height;
+}
+
+/**
+ * Walk back from node n to the last node before it at every level from 1
+ * to top. Store the node of level k in update[k - 1] and the number of
+ * positions from that node to n in dist[k - 1].
+ *
+ * @param idx the index.
+ * @param n the node.
+ * @param top the highest level.
+ * @param update the node before n per level.
+ * @param dist the distance to n per level.
+ */
+static void index_find(struct list_index *idx, const struct node *n,
+                       int top, struct node **update, size_t *dist) {
+    struct node *x = n->prev != NULL ? n->prev : &idx->head;
+    size_t d = 1;
+
+    for (int k = 1; k <= top; k++) {
+        while (x != &idx->head && x->height < k) {
+            if (k == 1) {
+                x = x->prev != NULL ? x->prev : &idx->head;
+                d++;
+            } else {
+                x = x->links[k - 2].prev;
+                d += x->links[k - 2].width;
+            }
+        }
+
+        update[k - 1] = x;
+        dist[k - 1] = d;
+    }
+}
+
+/**
+ * Add node n, which was just linked into the list, to index idx.
+ *
+ * @param idx the index.
+ * @param n the node.
+ */
+static void index_insert(struct list_index *idx, struct node *n) {
+    struct node *update[INDEX_MAX_LEVEL];
+    size_t dist[INDEX_MAX_LEVEL];
+    int height = index_height(idx);
+
+    if (height > 0) {
+        n->links = malloc(sizeof(struct skip_link) * (size_t) height);
+
+        // Without memory for its links the node only stays on level 0.
+        if (n->links == NULL) height = 0;
+    }
+
+    int top = height > idx->level ? height : idx->level;
+
+    index_find(idx, n, top, update, dist);
+
+    for (int k = 1; k <= top; k++) {
+        struct skip_link *p = &update[k - 1]->links[k - 1];
+
+        if (k <= height) {
+            struct skip_link *link = &n->links[k - 1];
+
+            link->next = p->next;
+            link->prev = update[k - 1];
+            link->width = p->next != NULL ? p->width + 1 - dist[k - 1] : 0;
+
+            if (p->next != NULL) p->next->links[k - 1].prev = n;
+
+            p->next = n;
+            p->width = dist[k - 1];
+        } else if (p->next != NULL) {
+            p->width++;
+        }
+    }
+
+    n->height = height;
+
+    if (height > idx->level) idx->level = height;
+}
+
+/**
+ * Remove node n, which is still linked into the list, from index idx.
+ *
+ * @param idx the index.
+ * @param n the node.
+ */
+static void index_remove(struct list_index *idx, struct node *n) {
+    struct node *update[INDEX_MAX_LEVEL];
+    size_t dist[INDEX_MAX_LEVEL];
+
+    index_find(idx, n, idx->level, update, dist);
+
+    for (int k = 1; k <= idx->level; k++) {
+        struct skip_link *p = &update[k - 1]->links[k - 1];
+
+        if (k <= n->height) {
+            struct skip_link *link = &n->links[k - 1];
+
+            p->next = link->next;
+            p->width = link->next != NULL ? p->width + link->width - 1 : 0;
+
+            if (link->next != NULL) {
+                link->next->links[k - 1].prev = update[k - 1];
+            }
+        } else if (p->next != NULL) {
+            p->width--;
+        }
+    }
+
+    free(n->links);
+    n->links = NULL;
+    n->height = 0;
+}
+
+/**
+ * Count node n, which was just linked into list l, in the index and as a
+ * node from outside the pool of l.
+ *
+ * @param l the list.
+ * @param n the node.
+ */
+static void node_linked(struct list *l, struct node *n) {
+    if (n->pool != l->pool) l->foreign++;
+    if (l->index != NULL) index_insert(l->index, n);
+}
+
 /**
  * Reserve bytes in memory for list.
  *
@@ -59,7 +328,12 @@ struct list *list_init(void) {
 
     if (l == NULL) return NULL;
 
+    l->head = NULL;
+    l->tail = NULL;
     l->length = 0;
+    l->index = NULL;
+    l->pool = NULL;
+    l->foreign = 0;
 
     return l;
 }
@@ -79,6 +353,9 @@ struct node *list_new_node(int num) {
     n->prev = NULL;
     n->next = NULL;
     n->num = num;
+    n->height = 0;
+    n->links = NULL;
+    n->pool = NULL;
 
     return n;
 }
@@ -124,8 +401,6 @@ int list_add_front(struct list *l, struct node *n) {
         n->list = l;
 
         l->length++;
-
-        return 0;
     } else {
         n->next = l->head;
         l->head->prev = n;
@@ -133,9 +408,11 @@ int list_add_front(struct list *l, struct node *n) {
         n->list = l;
 
         l->length++;
-
-        return 0;
     }
+
+    node_linked(l, n);
+
+    return 0;
 }
 
 /**
@@ -180,8 +457,6 @@ int list_add_back(struct list *l, struct node *n) {
         n->list = l;
 
         l->length++;
-
-        return 0;
     } else {
         n->prev = l->tail;
         l->tail->next = n;
@@ -189,9 +464,11 @@ int list_add_back(struct list *l, struct node *n) {
         n->list = l;
 
         l->length++;
-
-        return 0;
     }
+
+    node_linked(l, n);
+
+    return 0;
 }
 
 /**
@@ -232,6 +509,9 @@ int list_unlink_node(struct list *l, struct node *n) {
     if (l == NULL || n == NULL) return 1;
     if (l->length == 0 || l != n->list) return 1;
 
+    if (l->index != NULL) index_remove(l->index, n);
+    if (n->pool != l->pool) l->foreign--;
+
     struct node *prev_node = n->prev;
     struct node *next_node = n->next;
 
@@ -264,7 +544,18 @@ int list_unlink_node(struct list *l, struct node *n) {
  * @param n the node.
  */
 void list_free_node(struct node *n) {
-    if (n != NULL) free(n);
+    if (n == NULL) return;
+
+    free(n->links);
+
+    if (n->pool == NULL) {
+        free(n);
+    } else {
+        n->links = NULL;
+        n->height = 0;
+        n->next = n->pool->free;
+        n->pool->free = n;
+    }
 }
 
 /**
@@ -275,25 +566,28 @@ void list_free_node(struct node *n) {
 int list_cleanup(struct list *l) {
     if(l == NULL) return 1;
 
-    if (l->length != 0) {
-        struct node *nodes[l->length];
+    // The slabs of a pool that only this list uses are freed at once, so
+    // only other nodes and index links need a walk over the list.
+    int walk = l->pool == NULL || l->pool->refs > 1 || l->foreign > 0
+               || l->index != NULL;
+    struct node *n = walk ? l->head : NULL;
 
-        if (l->head != NULL) {
-            nodes[0] = l->head;
+    // Free nodes from memory, reading the next node before each free.
+    while (n != NULL) {
+        struct node *next = n->next;
 
-            // Get all nodes from list.
-            for (size_t i = 1; i < l->length; i++) {
-                nodes[i] = nodes[i - 1]->next;
-            }
-
-            // Free nodes from memory.
-            for (size_t i = 0; i < l->length; i++) {
-                list_free_node(nodes[i]);
-            }
+        if (n->pool != NULL && n->pool == l->pool && l->pool->refs == 1) {
+            free(n->links);
+        } else {
+            list_free_node(n);
         }
+
+        n = next;
     }
 
-    if(l != NULL) free(l);
+    pool_release(l->pool);
+    free(l->index);
+    free(l);
 
     return 0;
 }
@@ -336,8 +630,6 @@ int list_insert_after(struct list *l, struct node *n, struct node *m) {
 
         n->list = l;
         l->length++;
-
-        return 0;
     } else {
         m->next = n;
         n->prev = m;
@@ -346,9 +638,11 @@ int list_insert_after(struct list *l, struct node *n, struct node *m) {
 
         l->tail = n;
         l->length++;
-
-        return 0;
     }
+
+    node_linked(l, n);
+
+    return 0;
 }
 
 /**
@@ -375,8 +669,6 @@ int list_insert_before(struct list *l, struct node *n, struct node *m) {
 
         n->list = l;
         l->length++;
-
-        return 0;
     } else {
         n->next = m;
         m->prev = n;
@@ -385,9 +677,11 @@ int list_insert_before(struct list *l, struct node *n, struct node *m) {
 
         l->head = n;
         l->length++;
-
-        return 0;
     }
+
+    node_linked(l, n);
+
+    return 0;
 }
 
 /**
@@ -410,24 +704,38 @@ size_t list_length(const struct list *l) {
  * @return
  */
 struct node *list_get_ith(const struct list *l, size_t i) {
-    if (l == NULL) return NULL;
+    if (l == NULL || i >= l->length) return NULL;
+
+    struct node *n = l->head;
+    size_t position = 1;
 
-    if (l->length != 0) {
-        struct node *nodes[l->length];
+    // Position 0 is the head of the index, the nodes start at 1.
+    if (l->index != NULL) {
+        struct node *x = &l->index->head;
+        size_t pos = 0;
 
-        if (l->head != NULL) {
-            nodes[0] = l->head;
+        for (int k = l->index->level; k >= 1; k--) {
+            struct skip_link *link = &x->links[k - 1];
 
-            // Get all nodes from list.
-            for (size_t n = 1; n < l->length; n++) {
-                nodes[n] = nodes[n - 1]->next;
+            while (link->next != NULL && pos + link->width <= i + 1) {
+                pos += link->width;
+                x = link->next;
+                link = &x->links[k - 1];
             }
+        }
 
-            return nodes[i];
+        if (x != &l->index->head) {
+            n = x;
+            position = pos;
         }
     }
 
-    return NULL;
+    while (position <= i && n != NULL) {
+        n = n->next;
+        position++;
+    }
+
+    return n;
 }
 
 /**
@@ -439,43 +747,463 @@ struct node *list_get_ith(const struct list *l, size_t i) {
  */
 struct list *list_cut_after(struct list *l, struct node *n) {
     if (l == NULL || n == NULL) return NULL;
-    if (l->length < 2 || l->head == NULL) return NULL;
+    if (l->length < 2 || l->head == NULL || l != n->list) return NULL;
 
-    struct node *nodes[l->length];
+    struct list *new_list = list_init();
 
-    nodes[0] = l->head;
+    if (new_list == NULL) return NULL;
+    if (n->next == NULL) return new_list;
 
-    size_t node_position = 0;
+    // The nodes of the second half leave the index, which is rebuilt for
+    // the first half afterwards.
+    int indexed = l->index != NULL;
 
-    // Get all nodes from list.
-    for (size_t i = 1; i < l->length; i++) {
-        nodes[i] = nodes[i - 1]->next;
+    list_index_drop(l);
 
-        if (nodes[i] == n) node_position = i + 1;
-    }
+    new_list->head = n->next;
+    new_list->tail = l->tail;
+    new_list->head->prev = NULL;
 
-    struct list *new_list = list_init();
+    // The second half keeps taking nodes from the same pool.
+    new_list->pool = l->pool;
 
-    size_t new_list_length = 0;
-    new_list->head = n->next;
+    if (l->pool != NULL) l->pool->refs++;
+
+    // Move nodes from first list to the new list.
+    for (struct node *m = new_list->head; m != NULL; m = m->next) {
+        m->list = new_list;
+        new_list->length++;
+
+        if (m->pool != l->pool) {
+            new_list->foreign++;
+            l->foreign--;
+        }
+    }
 
     l->tail = n;
+    l->length -= new_list->length;
     n->next = NULL;
 
-    // Move nodes from first list to the new list.
-    for (size_t i = node_position; i < l->length; i++) {
-        nodes[i]->list = new_list;
+    if (indexed) list_index_build(l);
+
+    return new_list;
+}
+
+/**
+ * Place the cursor on the first node of the list.
+ *
+ * @param it the cursor.
+ * @param l the list.
+ */
+void list_iter_begin(struct list_iter *it, struct list *l) {
+    if (it == NULL) return;
+
+    it->list = l;
+    it->node = list_head(l);
+}
+
+/**
+ * Place the cursor past the end of the list.
+ *
+ * @param it the cursor.
+ * @param l the list.
+ */
+void list_iter_end(struct list_iter *it, struct list *l) {
+    if (it == NULL) return;
+
+    it->list = l;
+    it->node = NULL;
+}
+
+/**
+ * Place the cursor on a node of the list.
+ *
+ * @param it the cursor.
+ * @param l the list.
+ * @param n the node.
+ * @return
+ */
+int list_iter_at(struct list_iter *it, struct list *l, struct node *n) {
+    if (it == NULL || l == NULL || n == NULL) return 1;
+    if (l != n->list) return 1;
+
+    it->list = l;
+    it->node = n;
+
+    return 0;
+}
 
-        new_list_length++;
+/**
+ * Get the node under the cursor.
+ *
+ * @param it the cursor.
+ * @return
+ */
+struct node *list_iter_node(const struct list_iter *it) {
+    if (it == NULL) return NULL;
+
+    return it->node;
+}
+
+/**
+ * Move the cursor to the next node.
+ *
+ * @param it the cursor.
+ * @return
+ */
+int list_iter_next(struct list_iter *it) {
+    if (it == NULL || it->node == NULL) return 1;
+
+    it->node = it->node->next;
+
+    return 0;
+}
+
+/**
+ * Move the cursor to the previous node.
+ *
+ * @param it the cursor.
+ * @return
+ */
+int list_iter_prev(struct list_iter *it) {
+    if (it == NULL || it->list == NULL) return 1;
+
+    struct node *prev_node = it->node == NULL ? it->list->tail
+                                              : it->node->prev;
+
+    if (prev_node == NULL) return 1;
+
+    it->node = prev_node;
+
+    return 0;
+}
+
+/**
+ * Insert node n before the node under the cursor.
+ *
+ * @param it the cursor.
+ * @param n the node you want to insert.
+ * @return
+ */
+int list_iter_insert(struct list_iter *it, struct node *n) {
+    if (it == NULL || n == NULL || it->list == NULL) return 1;
+    if (n->list != NULL) return 1;
+
+    if (it->node == NULL) return list_add_back(it->list, n);
+
+    return list_insert_before(it->list, n, it->node);
+}
+
+/**
+ * Build an index over the list for positional access.
+ *
+ * @param l the list.
+ * @return
+ */
+int list_index_build(struct list *l) {
+    if (l == NULL) return 1;
+    if (l->index != NULL) return 0;
+
+    struct list_index *idx = malloc(sizeof(struct list_index));
+
+    if (idx == NULL) return 1;
+
+    idx->head.list = l;
+    idx->head.next = NULL;
+    idx->head.prev = NULL;
+    idx->head.num = 0;
+    idx->head.height = INDEX_MAX_LEVEL;
+    idx->head.links = idx->head_links;
+    idx->level = 0;
+    idx->seed = 0x9e3779b97f4a7c15;
+
+    struct node *last[INDEX_MAX_LEVEL];
+    size_t last_pos[INDEX_MAX_LEVEL];
+
+    for (int k = 0; k < INDEX_MAX_LEVEL; k++) {
+        idx->head_links[k] = (struct skip_link) { NULL, NULL, 0 };
+        last[k] = &idx->head;
+        last_pos[k] = 0;
+    }
+
+    size_t pos = 0;
+
+    // Link the towers in list order, so every level is built in one pass.
+    for (struct node *n = l->head; n != NULL; n = n->next) {
+        int height = index_height(idx);
+
+        pos++;
 
-        // Set tail and determine the lengths of both lists.
-        if (i == l->length - 1) {
-            new_list->tail = nodes[i];
-            new_list->length = new_list_length;
+        if (height > 0) {
+            n->links = malloc(sizeof(struct skip_link) * (size_t) height);
 
-            l->length = l->length - new_list_length;
+            if (n->links == NULL) height = 0;
         }
+
+        n->height = height;
+
+        for (int k = 0; k < height; k++) {
+            last[k]->links[k].next = n;
+            last[k]->links[k].width = pos - last_pos[k];
+            n->links[k] = (struct skip_link) { NULL, last[k], 0 };
+            last[k] = n;
+            last_pos[k] = pos;
+        }
+
+        if (height > idx->level) idx->level = height;
     }
 
-    return new_list;
+    l->index = idx;
+
+    return 0;
+}
+
+/**
+ * Remove the index from the list.
+ *
+ * @param l the list.
+ */
+void list_index_drop(struct list *l) {
+    if (l == NULL || l->index == NULL) return;
+
+    for (struct node *n = l->head; n != NULL; n = n->next) {
+        free(n->links);
+        n->links = NULL;
+        n->height = 0;
+    }
+
+    free(l->index);
+    l->index = NULL;
+}
+
+/**
+ * Insert node n at position i.
+ *
+ * @param l the list.
+ * @param n the node.
+ * @param i the position of n after inserting.
+ * @return
+ */
+int list_insert_at(struct list *l, struct node *n, size_t i) {
+    if (l == NULL || n == NULL || i > l->length) return 1;
+    if (n->list != NULL) return 1;
+
+    if (i == l->length) return list_add_back(l, n);
+
+    return list_insert_before(l, n, list_get_ith(l, i));
+}
+
+/**
+ * Get the position of node n in the list.
+ *
+ * @param l the list.
+ * @param n the node.
+ * @return
+ */
+size_t list_node_rank(const struct list *l, const struct node *n) {
+    if (l == NULL || n == NULL || l != n->list) return SIZE_MAX;
+
+    size_t rank = 0;
+
+    if (l->index != NULL) {
+        struct node *update[INDEX_MAX_LEVEL + 1];
+        size_t dist[INDEX_MAX_LEVEL + 1];
+        int top = l->index->level + 1;
+
+        // No node reaches the top level, so its walk ends at the head.
+        index_find(l->index, n, top, update, dist);
+
+        return dist[top - 1] - 1;
+    }
+
+    for (const struct node *m = n->prev; m != NULL; m = m->prev) rank++;
+
+    return rank;
+}
+
+/**
+ * Reserve bytes in memory for a list with a pool of nodes.
+ *
+ * @return
+ */
+struct list *list_init_pooled(void) {
+    struct list *l = list_init();
+
+    if (l == NULL) return NULL;
+
+    l->pool = malloc(sizeof(struct node_pool));
+
+    if (l->pool == NULL) {
+        free(l);
+
+        return NULL;
+    }
+
+    l->pool->slabs = NULL;
+    l->pool->free = NULL;
+    l->pool->refs = 1;
+
+    return l;
+}
+
+/**
+ * Take a node from the pool of the list and add num into it.
+ *
+ * @param l the list.
+ * @param num number in node.
+ * @return
+ */
+struct node *list_new_pooled_node(struct list *l, int num) {
+    if (l == NULL) return NULL;
+    if (l->pool == NULL) return list_new_node(num);
+
+    struct node *n = pool_take(l->pool);
+
+    if (n == NULL) return NULL;
+
+    n->list = NULL;
+    n->prev = NULL;
+    n->next = NULL;
+    n->num = num;
+    n->height = 0;
+    n->links = NULL;
+    n->pool = l->pool;
+
+    return n;
+}
+
+/**
+ * Check if node b, which comes after node a, belongs strictly before a.
+ *
+ * @param a the first node.
+ * @param b the node after a.
+ * @param descending 1 for descending order, 0 for ascending order.
+ * @return
+ */
+static int out_of_order(const struct node *a, const struct node *b,
+                        int descending) {
+    return descending ? b->num > a->num : b->num < a->num;
+}
+
+/**
+ * Cut the run that starts at *run off the nodes after it. A run that is
+ * strictly in the wrong order is reversed, which keeps equal numbers in
+ * their order because it has none.
+ *
+ * @param run the first node, set to the first node of the sorted run.
+ * @param descending 1 for descending order, 0 for ascending order.
+ * @return the first node after the run.
+ */
+static struct node *cut_run(struct node **run, int descending) {
+    struct node *last = *run;
+    struct node *rest;
+
+    if (last->next != NULL && out_of_order(last, last->next, descending)) {
+        rest = last->next;
+        last->next = NULL;
+
+        while (rest != NULL && out_of_order(*run, rest, descending)) {
+            struct node *next = rest->next;
+
+            rest->next = *run;
+            *run = rest;
+            rest = next;
+        }
+
+        return rest;
+    }
+
+    while (last->next != NULL && !out_of_order(last, last->next, descending)) {
+        last = last->next;
+    }
+
+    rest = last->next;
+    last->next = NULL;
+
+    return rest;
+}
+
+/**
+ * Merge the sorted runs a and b, where b came after a, into one run. On
+ * equal numbers the node of a goes first.
+ *
+ * @param a the first run.
+ * @param b the second run.
+ * @param descending 1 for descending order, 0 for ascending order.
+ * @return the first node of the merged run.
+ */
+static struct node *merge_runs(struct node *a, struct node *b,
+                               int descending) {
+    struct node *head = NULL;
+    struct node **tail = &head;
+
+    while (a != NULL && b != NULL) {
+        struct node **from = out_of_order(a, b, descending) ? &b : &a;
+
+        *tail = *from;
+        tail = &(*from)->next;
+        *from = *tail;
+    }
+
+    *tail = a != NULL ? a : b;
+
+    return head;
+}
+
+/**
+ * Order list with a bottom-up natural merge sort. The runs already in the
+ * list are merged like a binary counter: pending[k] holds the merge of 2^k
+ * runs, so runs of equal size are merged while they are still in the
+ * cache. A sorted list is a single run and takes one pass. Only the links
+ * of the nodes change and equal numbers keep their order.
+ *
+ * @param l the list.
+ * @param descending 1 for descending order, 0 for ascending order.
+ * @return
+ */
+int list_sort(struct list *l, int descending) {
+    if (l == NULL) return 1;
+    if (l->head == NULL) return 0;
+
+    // The links of the index follow the old order, so it is rebuilt.
+    int indexed = l->index != NULL;
+
+    list_index_drop(l);
+
+    struct node *pending[64] = { NULL };
+    struct node *rest = l->head;
+
+    // Sort the next links only and restore the prev links at the end.
+    while (rest != NULL) {
+        struct node *run = rest;
+        size_t k = 0;
+
+        rest = cut_run(&run, descending);
+
+        for (; pending[k] != NULL; k++) {
+            run = merge_runs(pending[k], run, descending);
+            pending[k] = NULL;
+        }
+
+        pending[k] = run;
+    }
+
+    // The higher counters hold the earlier runs.
+    struct node *head = NULL;
+
+    for (size_t k = 0; k < 64; k++) {
+        if (pending[k] != NULL) head = merge_runs(pending[k], head, descending);
+    }
+
+    struct node *prev = NULL;
+
+    for (struct node *n = head; n != NULL; n = n->next) {
+        n->prev = prev;
+        prev = n;
+    }
+
+    l->head = head;
+    l->tail = prev;
+
+    return indexed ? list_index_build(l) : 0;
 }
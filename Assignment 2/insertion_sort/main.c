@@ -7,9 +7,11 @@
 * PUBLIC FUNCTIONS:
 *   void ascending_order( l )
 *   void descending_order( l )
+*   int radix_sort( numbers, descending )
 *   void pair_wise_order( l )
 *   void remove_odd( l )
 *   void zip_alternating_order( l )
+*   void reorder_list( l, cfg )
 *   void insertion_sort( l, cfg )
 *   int parse_options( cfg, argc, argv[] )
 *   int main( argc, argv[] )
@@ -21,28 +23,28 @@
 *H*/
 
 #include <getopt.h>
+#include <limits.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
+#include "extsort.h"
 #include "list.h"
-#define BUF_SIZE 1024
+#include "list_ext.h"
+#include "output.h"
+#include "parse.h"
+#include "psort.h"
+#include "ulist.h"
 
-char buf[BUF_SIZE];
+/* At least this many numbers are radix sorted unless -m is specified,
+ * since insertion sort takes quadratic time. */
+#define RADIX_THRESHOLD 1024
 
-typedef struct node {
-    struct list *list;
-    struct node *next;
-    struct node *prev;
-    int num;
-} node;
-
-typedef struct list {
-    struct node *head;
-    struct node *tail;
-    size_t length;
-} list;
+/* Value getopt_long returns for --mem-limit, which has no short option. */
+#define OPT_MEM_LIMIT 256
 
 struct config {
     /* Set to 1 if -d is specified, 0 otherwise. */
@@ -56,30 +58,67 @@ struct config {
 
     /* Set to 1 if -z is specified, 0 otherwise. */
     int zip_alternating;
+
+    /* Set to 1 if -m is specified, 0 otherwise. */
+    int merge_sort;
+
+    /* Set to 1 if -r is specified, 0 otherwise. */
+    int radix_sort;
+
+    /* Number of threads given with -j, 1 otherwise. */
+    size_t jobs;
+
+    /* Bytes given with --mem-limit, 0 otherwise. */
+    size_t mem_limit;
 };
 
 /**
- * Order list in ascending order.
+ * Move node n back to its place among the sorted nodes before it. The
+ * cursor walks back from n to the first node that may stay before n, so
+ * equal numbers keep their order.
  *
  * @param l the list with nodes containing numbers.
+ * @param n the node to place.
+ * @param descending 1 for descending order, 0 for ascending order.
  */
-void ascending_order(struct list *l) {
-    for (size_t l_i = 0; l_i < l->length; l_i++) {
-        struct node *n = list_get_ith(l, l_i);
+static void insert_sorted(struct list *l, struct node *n, int descending) {
+    struct list_iter it;
 
-        if (n == NULL) break;
+    list_iter_at(&it, l, n);
 
-        for (size_t n_i = l_i; n_i--;) {
-            if (n->prev == NULL) continue;
+    while (list_iter_prev(&it) == 0) {
+        struct node *prev_n = list_iter_node(&it);
 
-            struct node *prev_n = list_get_ith(l, n_i);
+        int num = list_node_get_value(n);
+        int prev_num = list_node_get_value(prev_n);
 
-            if (n->num < prev_n->num) {
-                list_unlink_node(l, n);
-                list_insert_before(l, n, prev_n);
-            }
+        if (descending ? num <= prev_num : num >= prev_num) {
+            list_iter_next(&it);
+            break;
         }
     }
+
+    if (list_iter_node(&it) == n) return;
+
+    list_unlink_node(l, n);
+    list_iter_insert(&it, n);
+}
+
+/**
+ * Order list in ascending order.
+ *
+ * @param l the list with nodes containing numbers.
+ */
+void ascending_order(struct list *l) {
+    struct list_iter it;
+
+    list_iter_begin(&it, l);
+
+    // Read the next node before the current one moves back.
+    for (struct node *n; (n = list_iter_node(&it)) != NULL;) {
+        list_iter_next(&it);
+        insert_sorted(l, n, 0);
+    }
 }
 
 /**
@@ -88,22 +127,70 @@ void ascending_order(struct list *l) {
  * @param l the list with nodes containing numbers.
  */
 void descending_order(struct list *l) {
-    for (size_t l_i = 0; l_i < l->length; l_i++) {
-        struct node *n = list_get_ith(l, l_i);
+    struct list_iter it;
 
-        if (n == NULL) break;
+    list_iter_begin(&it, l);
 
-        for (size_t n_i = l_i; n_i--;) {
-            if (n->prev == NULL) continue;
+    // Read the next node before the current one moves back.
+    for (struct node *n; (n = list_iter_node(&it)) != NULL;) {
+        list_iter_next(&it);
+        insert_sorted(l, n, 1);
+    }
+}
 
-            struct node *prev_n = list_get_ith(l, n_i);
+/**
+ * Order the numbers with a least significant digit radix sort. They are
+ * copied to an array as unsigned keys, sorted a byte at a time and
+ * written back in order. Return 0 if successful, 1 if there was no memory
+ * for the arrays.
+ *
+ * @param numbers the unrolled list of numbers.
+ * @param descending 1 for descending order, 0 for ascending order.
+ * @return
+ */
+int radix_sort(struct ulist *numbers, int descending) {
+    size_t length = ulist_length(numbers);
 
-            if (n->num > prev_n->num) {
-                list_unlink_node(l, n);
-                list_insert_before(l, n, prev_n);
-            }
-        }
+    if (length < 2) return 0;
+
+    uint32_t *keys = malloc(sizeof(uint32_t) * length);
+    uint32_t *sorted = malloc(sizeof(uint32_t) * length);
+
+    if (keys == NULL || sorted == NULL) {
+        free(keys);
+        free(sorted);
+
+        return 1;
+    }
+
+    size_t i = 0;
+    struct ulist_iter it;
+    int *num;
+
+    // Subtracting INT_MIN puts the negative numbers below the positive
+    // ones as unsigned keys.
+    ulist_iter_begin(&it, numbers);
+
+    while ((num = ulist_iter_next(&it)) != NULL) {
+        keys[i++] = (uint32_t) ((int64_t) *num - INT_MIN);
     }
+
+    uint32_t *sorted_keys = radix_sort_keys(keys, sorted, length);
+
+    i = 0;
+    ulist_iter_begin(&it, numbers);
+
+    while ((num = ulist_iter_next(&it)) != NULL) {
+        uint32_t key = sorted_keys[descending ? length - 1 - i : i];
+
+        *num = (int) ((int64_t) key + INT_MIN);
+        i++;
+    }
+
+    free(keys);
+    free(sorted);
+
+    return 0;
 }
 
 /**
@@ -134,20 +221,14 @@ void zip_alternating_order(struct list *l) {
 }
 
 /**
- * Sort list based on config.
+ * Reorder the sorted list based on config.
  *
  * @param l the list.
  * @param cfg
  */
-void insertion_sort(struct list *l, struct config *cfg) {
+void reorder_list(struct list *l, struct config *cfg) {
     if (l == NULL || cfg == NULL) return;
 
-    if (cfg->descending_order) {
-        descending_order(l);
-    } else {
-        ascending_order(l);
-    }
-
     if (cfg->combine) {
         pair_wise_order(l);
     }
@@ -161,6 +242,96 @@ void insertion_sort(struct list *l, struct config *cfg) {
     }
 }
 
+/**
+ * Sort list based on config.
+ *
+ * @param l the list.
+ * @param cfg
+ */
+void insertion_sort(struct list *l, struct config *cfg) {
+    if (l == NULL || cfg == NULL) return;
+
+    // Without an index the merge sort only relinks nodes and cannot fail.
+    if (cfg->merge_sort) {
+        list_sort(l, cfg->descending_order);
+    } else if (cfg->descending_order) {
+        descending_order(l);
+    } else {
+        ascending_order(l);
+    }
+
+    reorder_list(l, cfg);
+}
+
+/**
+ * Move the numbers to a new list with a pooled node per number.
+ *
+ * @param numbers the unrolled list of numbers, freed by this function.
+ * @return the list or NULL if there was no memory for it.
+ */
+static struct list *to_list(struct ulist *numbers) {
+    struct list *l = list_init_pooled();
+    struct ulist_iter it;
+    int *num;
+
+    ulist_iter_begin(&it, numbers);
+
+    while (l != NULL && (num = ulist_iter_next(&it)) != NULL) {
+        struct node *n = list_new_pooled_node(l, *num);
+
+        if (n == NULL) {
+            list_cleanup(l);
+            l = NULL;
+        } else {
+            list_add_back(l, n);
+        }
+    }
+
+    ulist_cleanup(numbers);
+
+    return l;
+}
+
+/**
+ * Read a number of bytes with an optional K, M or G suffix for powers of
+ * 1024. Return 0 if successful, 1 if arg is not a size.
+ *
+ * @param arg the argument.
+ * @param bytes the number of bytes.
+ * @return
+ */
+static int parse_memory(const char *arg, size_t *bytes) {
+    char *end_ptr;
+    unsigned long long size = strtoull(arg, &end_ptr, 10);
+    unsigned shift = 0;
+
+    if (end_ptr == arg || *arg == '-') return 1;
+
+    switch (*end_ptr) {
+    case 'G':
+        shift = 30;
+        break;
+    case 'M':
+        shift = 20;
+        break;
+    case 'K':
+        shift = 10;
+        break;
+    case '\0':
+        break;
+    default:
+        return 1;
+    }
+
+    if (shift > 0 && *++end_ptr != '\0') return 1;
+
+    if (size > (SIZE_MAX >> shift)) return 1;
+
+    *bytes = (size_t) size << shift;
+
+    return 0;
+}
+
 /**
  * Decide which parse option to use based on the chosen option.
  *
@@ -173,8 +344,18 @@ int parse_options(struct config *cfg, int argc, char *argv[]) {
     memset(cfg, 0, sizeof(struct config));
 
     int c;
+    char *end_ptr;
+    long jobs;
+
+    static const struct option long_options[] = {
+        { "mem-limit", required_argument, NULL, OPT_MEM_LIMIT },
+        { NULL, 0, NULL, 0 }
+    };
+
+    cfg->jobs = 1;
 
-    while ((c = getopt(argc, argv, "dcoz")) != -1) {
+    while ((c = getopt_long(argc, argv, "dcozmrj:", long_options, NULL))
+           != -1) {
         switch (c) {
         case 'd':
             cfg->descending_order = 1;
@@ -187,6 +368,30 @@ int parse_options(struct config *cfg, int argc, char *argv[]) {
             break;
         case 'z':
             cfg->zip_alternating = 1;
+            break;
+        case 'm':
+            cfg->merge_sort = 1;
+            break;
+        case 'r':
+            cfg->radix_sort = 1;
+            break;
+        case 'j':
+            jobs = strtol(optarg, &end_ptr, 10);
+
+            if (end_ptr == optarg || *end_ptr != '\0' || jobs < 1) {
+                fprintf(stderr, "invalid number of jobs: %s\n", optarg);
+                return 1;
+            }
+
+            cfg->jobs = (size_t) jobs;
+            break;
+        case OPT_MEM_LIMIT:
+            if (parse_memory(optarg, &cfg->mem_limit) != 0
+                || cfg->mem_limit < EXTERNAL_MIN_MEMORY) {
+                fprintf(stderr, "invalid memory limit: %s\n", optarg);
+                return 1;
+            }
+
             break;
         default:
             fprintf(stderr, "invalid option: -%c\n", optopt);
@@ -194,6 +399,15 @@ int parse_options(struct config *cfg, int argc, char *argv[]) {
         }
     }
 
+    // The external sort has no list to reorder and sorts one run at a time.
+    if (cfg->mem_limit > 0
+        && (cfg->combine || cfg->remove_odd || cfg->zip_alternating
+            || cfg->jobs > 1)) {
+        fprintf(stderr, "--mem-limit cannot be combined with -c, -o, -z or "
+                        "-j\n");
+        return 1;
+    }
+
     return 0;
 }
 
@@ -209,39 +423,93 @@ int main(int argc, char *argv[]) {
 
     if (parse_options(&cfg, argc, argv) != 0) return 1;
 
-    struct list *l = list_init();
+    // With a memory limit the input is sorted in runs that are spilled.
+    if (cfg.mem_limit > 0) {
+        struct output *out = output_init(STDOUT_FILENO);
+        int error = out == NULL
+                    || external_sort(stdin, cfg.mem_limit, cfg.merge_sort,
+                                     cfg.descending_order, out) != 0;
 
-    char *end_ptr;
+        if (out != NULL && output_cleanup(out) != 0) error = 1;
 
-    while (fgets(buf, BUF_SIZE, stdin)) {
-        for (char *ptr = buf; *ptr != '\0';) {
-            int num = (int) strtol(ptr, &end_ptr, 10);
+        return error;
+    }
 
-            // If end_ptr moved to next char, because ptr is a number, add number to list.
-            if (ptr != end_ptr) {
-                struct node *n = list_new_node(num);
+    // Numbers are gathered in an unrolled list, with a few bytes each.
+    struct ulist *numbers = ulist_init();
 
-                list_add_front(l, n);
-            }
+    if (numbers == NULL) return 1;
 
-            // Move the pointer to the next character after the number.
-            ptr = end_ptr;
+    if (parse_numbers(stdin, numbers) != 0) {
+        ulist_cleanup(numbers);
 
-            // Skip whitespaces and new lines.
-            while (*ptr == ' ' || *ptr == '\n') ptr++;
-        }
+        return 1;
     }
 
-    insertion_sort(l, &cfg);
+    size_t length = ulist_length(numbers);
+    int reorder = cfg.combine || cfg.remove_odd || cfg.zip_alternating;
+    int parallel = cfg.jobs > 1;
+    int radix = !parallel
+                && (cfg.radix_sort
+                    || (!cfg.merge_sort && length >= RADIX_THRESHOLD));
+    struct output *out = output_init(STDOUT_FILENO);
+    int error = out == NULL;
+
+    // The merged chunks are written straight away, unless the list is
+    // reordered after sorting.
+    if (!error && parallel) {
+        error = parallel_sort(numbers, cfg.jobs, cfg.merge_sort,
+                              cfg.descending_order, reorder ? NULL : out);
+    }
 
-    // Output the sorted list.
-    for (size_t i = 0; i < l->length; i++) {
-        struct node *n = list_get_ith(l, i);
+    // Without memory for the arrays the list is merge sorted in place.
+    if (!error && radix && radix_sort(numbers, cfg.descending_order) != 0) {
+        radix = 0;
+        cfg.merge_sort = 1;
+    }
 
-        fprintf(stdout, "%d\n", n->num);
+    struct list *l = NULL;
+
+    // The list sorts and the options that reorder the list need a node per
+    // number.
+    if (!error && (reorder || (!radix && !parallel))) {
+        l = to_list(numbers);
+        numbers = NULL;
+
+        // The numbers are freed by to_list, also when it fails.
+        if (l == NULL) {
+            error = 1;
+        } else if (radix || parallel) {
+            reorder_list(l, &cfg);
+        } else {
+            insertion_sort(l, &cfg);
+        }
     }
 
+    struct list_iter it;
+    struct ulist_iter u_it;
+    int *num;
+
+    // Output the sorted numbers, which the parallel sort did without a
+    // list.
+    if (!error && l != NULL) {
+        for (list_iter_begin(&it, l); !error && list_iter_node(&it) != NULL;
+             list_iter_next(&it)) {
+            error = output_int(out,
+                               list_node_get_value(list_iter_node(&it)));
+        }
+    } else if (!error && !parallel) {
+        ulist_iter_begin(&u_it, numbers);
+
+        while (!error && (num = ulist_iter_next(&u_it)) != NULL) {
+            error = output_int(out, *num);
+        }
+    }
+
+    if (out != NULL && output_cleanup(out) != 0) error = 1;
+
     list_cleanup(l);
+    ulist_cleanup(numbers);
 
-    return 0;
-}
\ No newline at end of file
+    return error;
+}
@@ -0,0 +1,164 @@
+/*H**********************************************************************
+* FILENAME: output.c
+*
+* DESCRIPTION:
+*   Buffered writer for integers, formatted two digits at a time.
+*
+* PUBLIC FUNCTIONS:
+*   struct output *output_init( fd )
+*   int output_flush( o )
+*   int output_cleanup( o )
+*   int output_int( o, num )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 09-11-2023
+*
+*H*/
+
+// Needed for write
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "output.h"
+
+/* Longest line of a number, "-2147483648\n". */
+#define MAX_LINE 12
+
+struct output {
+    int fd;
+    size_t used;
+    char buffer[OUTPUT_BUFFER_SIZE];
+};
+
+/* The two digits of every number below 100. */
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233"
+    "34353637383940414243444546474849505152535455565758596061626364656667"
+    "6869707172737475767778798081828384858687888990919293949596979899";
+
+/**
+ * Count the decimal digits of v.
+ *
+ * @param v the value.
+ * @return
+ */
+static size_t count_digits(uint32_t v) {
+    size_t digits = 1;
+
+    while (v >= 100) {
+        v /= 100;
+        digits += 2;
+    }
+
+    return v >= 10 ? digits + 1 : digits;
+}
+
+/**
+ * Creates a writer for file descriptor fd.
+ *
+ * @param fd the file descriptor.
+ * @return
+ */
+struct output *output_init(int fd) {
+    struct output *o = malloc(sizeof(struct output));
+
+    if (o == NULL) return NULL;
+
+    o->fd = fd;
+    o->used = 0;
+
+    return o;
+}
+
+/**
+ * Write the buffer of o, also when write returns early.
+ *
+ * @param o the writer.
+ * @return
+ */
+int output_flush(struct output *o) {
+    if (o == NULL) return 1;
+
+    size_t done = 0;
+
+    while (done < o->used) {
+        ssize_t n = write(o->fd, o->buffer + done, o->used - done);
+
+        if (n < 0 && errno == EINTR) continue;
+
+        if (n <= 0) return 1;
+
+        done += (size_t) n;
+    }
+
+    o->used = 0;
+
+    return 0;
+}
+
+/**
+ * Flushes o and frees it.
+ *
+ * @param o the writer.
+ * @return
+ */
+int output_cleanup(struct output *o) {
+    if (o == NULL) return 1;
+
+    int error = output_flush(o);
+
+    free(o);
+
+    return error;
+}
+
+/**
+ * Appends num and a newline to the buffer of o. The digits are written
+ * from the back, two at a time from a table.
+ *
+ * @param o the writer.
+ * @param num the number.
+ * @return
+ */
+int output_int(struct output *o, int num) {
+    if (o == NULL) return 1;
+
+    if (OUTPUT_BUFFER_SIZE - o->used < MAX_LINE && output_flush(o) != 0) {
+        return 1;
+    }
+
+    char *p = o->buffer + o->used;
+    uint32_t v = (uint32_t) num;
+
+    if (num < 0) {
+        *p++ = '-';
+        v = 0 - v;
+    }
+
+    size_t digits = count_digits(v);
+    char *end = p + digits;
+
+    *end = '\n';
+
+    while (v >= 100) {
+        end -= 2;
+        memcpy(end, &digit_pairs[2 * (v % 100)], 2);
+        v /= 100;
+    }
+
+    if (v >= 10) {
+        memcpy(p, &digit_pairs[2 * v], 2);
+    } else {
+        *p = (char) ('0' + v);
+    }
+
+    o->used = (size_t) (p + digits + 1 - o->buffer);
+
+    return 0;
+}
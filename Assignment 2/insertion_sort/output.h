@@ -0,0 +1,26 @@
+/* Buffered writer for integers, one per line.
+ * The numbers are formatted two digits at a time into a large buffer,
+ * which is written to a file descriptor with a single write call when it
+ * is full, so there is no stdio call per number. */
+
+/* Number of bytes that are buffered before they are written. */
+#define OUTPUT_BUFFER_SIZE (1 << 16)
+
+/* Output data structure declaration. */
+struct output;
+
+/* Creates a writer for file descriptor FD and returns a pointer to it.
+ * Returns NULL if creating failed. */
+struct output *output_init(int fd);
+
+/* Writes the buffered output to the file descriptor of O.
+ * Returns 0 if successful, 1 if writing failed. */
+int output_flush(struct output *o);
+
+/* Flushes O and frees its memory.
+ * Returns 0 if successful, 1 if writing failed. */
+int output_cleanup(struct output *o);
+
+/* Appends NUM and a newline to the buffer of O.
+ * Returns 0 if successful, 1 if writing failed. */
+int output_int(struct output *o, int num);
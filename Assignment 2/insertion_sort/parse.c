@@ -0,0 +1,287 @@
+/*H**********************************************************************
+* FILENAME: parse.c
+*
+* DESCRIPTION:
+*   Bulk parser for the integers of a text stream, with eight digits per
+*   step in a 64-bit word.
+*
+* PUBLIC FUNCTIONS:
+*   struct parser *parser_init( in )
+*   void parser_cleanup( p )
+*   int parser_read( p, nums, max, count )
+*   int parse_numbers( in, numbers )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 09-11-2023
+*
+*H*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parse.h"
+#include "ulist.h"
+
+/* A byte repeated in all eight bytes of a word. */
+#define BYTES(b) (0x0101010101010101ULL * (b))
+
+/* Numbers per call of parser_read in parse_numbers. */
+#define PARSE_BATCH 1024
+
+/* The block that is being parsed and the state of the number that is being
+ * read, kept across blocks and calls. The numbers of a call are stored
+ * in nums until max of them are read. */
+struct parser {
+    FILE *in;
+    char *block;
+    const char *pos;
+    const char *end;
+    int eof;
+    uint64_t value;
+    int in_number;
+    int negative;
+    int saturated;
+    char sign;
+    int *nums;
+    size_t count;
+    size_t max;
+};
+
+static const uint64_t powers_of_ten[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+/**
+ * Load eight bytes from p into a word, with the first byte lowest.
+ *
+ * @param p the bytes.
+ * @return
+ */
+static uint64_t load(const char *p) {
+    uint64_t w;
+
+    memcpy(&w, p, sizeof(w));
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+
+    return w;
+}
+
+/**
+ * Count the digits at the start of word w, from 0 to 8. A byte is a
+ * digit if it is below 0x80, at least '0' and at most '9', which is
+ * tested for all bytes at once without a carry between bytes.
+ *
+ * @param w the word.
+ * @return
+ */
+static unsigned count_digits(uint64_t w) {
+    uint64_t high = BYTES(0x80);
+    uint64_t at_least_0 = (w | high) - BYTES('0');
+    uint64_t at_most_9 = BYTES(0x80 | '9') - (w & ~high);
+    uint64_t other = ~(at_least_0 & at_most_9 & ~w) & high;
+
+    if (other == 0) return 8;
+
+    return (unsigned) __builtin_ctzll(other) / 8;
+}
+
+/**
+ * Convert the k digits at the start of word w, 1 <= k <= 8. The digits are
+ * moved to the top of the word below '0' bytes, then pairs, quads and the
+ * two halves are combined with three multiplications.
+ *
+ * @param w the word.
+ * @param k the number of digits.
+ * @return
+ */
+static uint64_t convert_digits(uint64_t w, unsigned k) {
+    if (k < 8) w = (w << (8 * (8 - k))) | (BYTES('0') >> (8 * k));
+
+    w -= BYTES('0');
+    w = (w * 10 + (w >> 8)) & 0x00ff00ff00ff00ffULL;
+    w = (w * 100 + (w >> 16)) & 0x0000ffff0000ffffULL;
+    w = (w * 10000 + (w >> 32)) & 0xffffffffULL;
+
+    return w;
+}
+
+/**
+ * Store the number that was read, if there is one. There is room for it.
+ *
+ * @param p the parser.
+ */
+static void finish_number(struct parser *p) {
+    if (!p->in_number) return;
+
+    // Like strtol, values out of range become INT64_MIN or INT64_MAX.
+    uint64_t limit = (uint64_t) INT64_MAX + (uint64_t) p->negative;
+    uint64_t value = p->saturated || p->value > limit ? limit : p->value;
+
+    if (p->negative) value = 0 - value;
+
+    p->in_number = 0;
+    p->saturated = 0;
+    p->value = 0;
+    p->nums[p->count++] = (int) value;
+}
+
+/**
+ * Parse the block from the position of p until its end or until max
+ * numbers are stored. At least eight readable bytes follow the end of the
+ * block, none of them a digit.
+ *
+ * @param p the parser.
+ */
+static void parse_block(struct parser *p) {
+    const char *c = p->pos;
+
+    while (c < p->end && p->count < p->max) {
+        unsigned k = count_digits(load(c));
+
+        if (k == 0) {
+            finish_number(p);
+
+            // A sign only counts directly before a digit.
+            p->sign = *c == '-' || *c == '+' ? *c : 0;
+            c++;
+
+            continue;
+        }
+
+        if (!p->in_number) {
+            p->in_number = 1;
+            p->negative = p->sign == '-';
+        }
+
+        uint64_t digits = convert_digits(load(c), k);
+
+        // Leading zeros keep the value small, so only overflow saturates.
+        if (__builtin_mul_overflow(p->value, powers_of_ten[k], &p->value)
+            || __builtin_add_overflow(p->value, digits, &p->value)) {
+            p->saturated = 1;
+        }
+
+        p->sign = 0;
+        c += k;
+    }
+
+    p->pos = c;
+}
+
+/**
+ * Creates a parser for stream in.
+ *
+ * @param in the stream.
+ * @return
+ */
+struct parser *parser_init(FILE *in) {
+    if (in == NULL) return NULL;
+
+    struct parser *p = calloc(1, sizeof(struct parser));
+
+    if (p == NULL) return NULL;
+
+    // The zero bytes after a block end the digits of a word there.
+    p->block = malloc(PARSE_BLOCK_SIZE + 8);
+
+    if (p->block == NULL) {
+        free(p);
+
+        return NULL;
+    }
+
+    p->in = in;
+    p->pos = p->block;
+    p->end = p->block;
+
+    return p;
+}
+
+/**
+ * Frees parser p.
+ *
+ * @param p the parser.
+ */
+void parser_cleanup(struct parser *p) {
+    if (p == NULL) return;
+
+    free(p->block);
+    free(p);
+}
+
+/**
+ * Parse blocks of the stream until max numbers are read or the stream
+ * ends.
+ *
+ * @param p the parser.
+ * @param nums room for max numbers.
+ * @param max the number of numbers to read at most.
+ * @param count the number of numbers that were read.
+ * @return
+ */
+int parser_read(struct parser *p, int *nums, size_t max, size_t *count) {
+    if (p == NULL || nums == NULL || count == NULL) return 1;
+
+    p->nums = nums;
+    p->count = 0;
+    p->max = max;
+
+    while (p->count < p->max) {
+        if (p->pos < p->end) {
+            parse_block(p);
+        } else if (p->eof) {
+            break;
+        } else {
+            size_t size = fread(p->block, 1, PARSE_BLOCK_SIZE, p->in);
+
+            if (ferror(p->in)) return 1;
+
+            // The last number ends with the stream.
+            if (size == 0) {
+                p->eof = 1;
+                finish_number(p);
+            }
+
+            memset(p->block + size, 0, 8);
+            p->pos = p->block;
+            p->end = p->block + size;
+        }
+    }
+
+    *count = p->count;
+
+    return 0;
+}
+
+/**
+ * Read the stream in batches of numbers and append them to the list.
+ *
+ * @param in the stream.
+ * @param numbers the list the numbers are appended to.
+ * @return
+ */
+int parse_numbers(FILE *in, struct ulist *numbers) {
+    if (in == NULL || numbers == NULL) return 1;
+
+    struct parser *p = parser_init(in);
+    int nums[PARSE_BATCH];
+    size_t count = 1;
+    int error = p == NULL;
+
+    while (!error && count > 0) {
+        error = parser_read(p, nums, PARSE_BATCH, &count);
+
+        for (size_t i = 0; !error && i < count; i++) {
+            error = ulist_add_back(numbers, nums[i]);
+        }
+    }
+
+    parser_cleanup(p);
+
+    return error;
+}
@@ -0,0 +1,34 @@
+/* Bulk parser for the integers of a text stream.
+ * The stream is read in large blocks and the digits are found and
+ * converted eight bytes at a time in 64-bit words, so there is no call
+ * per number or branch per digit. A number is an optional '-' or '+'
+ * directly followed by decimal digits; every other byte separates
+ * numbers. Numbers continue across block boundaries. */
+
+#include <stdio.h>
+
+/* Unrolled list data structure declaration. */
+struct ulist;
+
+/* Parser data structure declaration. */
+struct parser;
+
+/* Number of bytes read from the stream at a time. */
+#define PARSE_BLOCK_SIZE (1 << 16)
+
+/* Creates a parser for stream IN and returns a pointer to it.
+ * Returns NULL if creating failed. */
+struct parser *parser_init(FILE *in);
+
+/* Frees parser P. The stream is not closed. */
+void parser_cleanup(struct parser *p);
+
+/* Reads up to MAX numbers from the stream of P into NUMS and stores how
+ * many were read in COUNT, which is less than MAX only at the end of the
+ * stream. Returns 0 if successful, 1 if reading failed. */
+int parser_read(struct parser *p, int *nums, size_t max, size_t *count);
+
+/* Reads all numbers from stream IN and appends them to NUMBERS. Numbers
+ * outside the range of an int are converted like (int) strtol does.
+ * Returns 0 if successful, 1 if reading or appending failed. */
+int parse_numbers(FILE *in, struct ulist *numbers);
@@ -0,0 +1,392 @@
+/*H**********************************************************************
+* FILENAME: psort.c
+*
+* DESCRIPTION:
+*   Sorts of unsigned keys and a parallel chunked sort with a k-way merge.
+*
+* PUBLIC FUNCTIONS:
+*   uint32_t *radix_sort_keys( keys, scratch, length )
+*   uint32_t *merge_sort_keys( keys, scratch, length )
+*   struct loser_tree *loser_tree_init( k )
+*   void loser_tree_cleanup( lt )
+*   size_t loser_tree_build( lt )
+*   size_t loser_tree_replay( lt )
+*   int parallel_sort( numbers, jobs, merge, descending, out )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 09-11-2023
+*
+*H*/
+
+// Needed for pthreads
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "output.h"
+#include "psort.h"
+#include "ulist.h"
+
+/* Runs of this many keys are insertion sorted before they are merged. */
+#define INSERTION_RUN 32
+
+/* A chunk of the keys, sorted by its own worker thread. */
+struct chunk {
+    uint32_t *keys;
+    uint32_t *scratch;
+    size_t length;
+    int merge;
+    uint32_t *sorted;
+};
+
+/**
+ * Sort the chunk given as argument.
+ *
+ * @param arg the chunk.
+ * @return
+ */
+static void *sort_chunk(void *arg) {
+    struct chunk *c = arg;
+
+    if (c->merge) {
+        c->sorted = merge_sort_keys(c->keys, c->scratch, c->length);
+    } else {
+        c->sorted = radix_sort_keys(c->keys, c->scratch, c->length);
+    }
+
+    return NULL;
+}
+
+/**
+ * Sorts the keys a byte at a time. All byte counts are made in one pass,
+ * and a byte that all keys share is skipped.
+ *
+ * @param keys the keys.
+ * @param scratch room for the same number of keys.
+ * @param length the number of keys.
+ * @return
+ */
+uint32_t *radix_sort_keys(uint32_t *keys, uint32_t *scratch, size_t length) {
+    if (length < 2) return keys;
+
+    size_t count[4][256] = { { 0 } };
+
+    for (size_t i = 0; i < length; i++) {
+        for (unsigned b = 0; b < 4; b++) {
+            count[b][(keys[i] >> (8 * b)) & 0xff]++;
+        }
+    }
+
+    for (unsigned b = 0; b < 4; b++) {
+        unsigned shift = 8 * b;
+
+        // All keys share this byte, so the pass would not move any.
+        if (count[b][(keys[0] >> shift) & 0xff] == length) continue;
+
+        size_t offset = 0;
+
+        for (size_t d = 0; d < 256; d++) {
+            size_t digits = count[b][d];
+
+            count[b][d] = offset;
+            offset += digits;
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            scratch[count[b][(keys[i] >> shift) & 0xff]++] = keys[i];
+        }
+
+        uint32_t *swap = keys;
+
+        keys = scratch;
+        scratch = swap;
+    }
+
+    return keys;
+}
+
+/**
+ * Sorts runs of the keys with insertion sort and merges pairs of runs
+ * from keys to scratch and back until one run is left.
+ *
+ * @param keys the keys.
+ * @param scratch room for the same number of keys.
+ * @param length the number of keys.
+ * @return
+ */
+uint32_t *merge_sort_keys(uint32_t *keys, uint32_t *scratch, size_t length) {
+    for (size_t start = 0; start < length; start += INSERTION_RUN) {
+        size_t end = length - start < INSERTION_RUN ? length
+                                                    : start + INSERTION_RUN;
+
+        for (size_t i = start + 1; i < end; i++) {
+            uint32_t key = keys[i];
+            size_t j = i;
+
+            for (; j > start && keys[j - 1] > key; j--) keys[j] = keys[j - 1];
+
+            keys[j] = key;
+        }
+    }
+
+    for (size_t width = INSERTION_RUN; width < length; width *= 2) {
+        for (size_t start = 0; start < length; start += 2 * width) {
+            size_t mid = length - start < width ? length : start + width;
+            size_t end = length - mid < width ? length : mid + width;
+            size_t a = start;
+            size_t b = mid;
+            size_t out = start;
+
+            while (a < mid && b < end) {
+                scratch[out++] = keys[b] < keys[a] ? keys[b++] : keys[a++];
+            }
+
+            while (a < mid) scratch[out++] = keys[a++];
+
+            while (b < end) scratch[out++] = keys[b++];
+        }
+
+        uint32_t *swap = keys;
+
+        keys = scratch;
+        scratch = swap;
+    }
+
+    return keys;
+}
+
+/**
+ * Play the matches of the subtree of node of loser tree lt. The leaves
+ * are the nodes k to 2k - 1, the loser of every match stays in its node
+ * and the winner moves up.
+ *
+ * @param lt the loser tree.
+ * @param node the root of the subtree.
+ * @return the winning source.
+ */
+static size_t play(struct loser_tree *lt, size_t node) {
+    if (node >= lt->k) return node - lt->k;
+
+    size_t left = play(lt, 2 * node);
+    size_t right = play(lt, 2 * node + 1);
+
+    if (lt->heads[right] < lt->heads[left]) {
+        lt->tree[node] = left;
+
+        return right;
+    }
+
+    lt->tree[node] = right;
+
+    return left;
+}
+
+/**
+ * Creates a loser tree for k sources.
+ *
+ * @param k the number of sources.
+ * @return
+ */
+struct loser_tree *loser_tree_init(size_t k) {
+    if (k == 0) return NULL;
+
+    struct loser_tree *lt = malloc(sizeof(struct loser_tree));
+
+    if (lt == NULL) return NULL;
+
+    lt->k = k;
+    lt->winner = 0;
+    lt->tree = malloc(sizeof(size_t) * k);
+    lt->heads = malloc(sizeof(uint64_t) * k);
+
+    if (lt->tree == NULL || lt->heads == NULL) {
+        loser_tree_cleanup(lt);
+
+        return NULL;
+    }
+
+    return lt;
+}
+
+/**
+ * Frees loser tree lt.
+ *
+ * @param lt the loser tree.
+ */
+void loser_tree_cleanup(struct loser_tree *lt) {
+    if (lt == NULL) return;
+
+    free(lt->tree);
+    free(lt->heads);
+    free(lt);
+}
+
+/**
+ * Plays all matches of lt.
+ *
+ * @param lt the loser tree.
+ * @return
+ */
+size_t loser_tree_build(struct loser_tree *lt) {
+    lt->winner = play(lt, 1);
+
+    return lt->winner;
+}
+
+/**
+ * Replays only the matches on the path from the leaf of the winner to the
+ * root, against the losers stored there.
+ *
+ * @param lt the loser tree.
+ * @return
+ */
+size_t loser_tree_replay(struct loser_tree *lt) {
+    size_t winner = lt->winner;
+
+    for (size_t node = (winner + lt->k) / 2; node > 0; node /= 2) {
+        if (lt->heads[lt->tree[node]] < lt->heads[winner]) {
+            size_t loser = winner;
+
+            winner = lt->tree[node];
+            lt->tree[node] = loser;
+        }
+    }
+
+    lt->winner = winner;
+
+    return winner;
+}
+
+/**
+ * Get the key of the next number of chunk c, or LOSER_TREE_EXHAUSTED if
+ * it has none.
+ *
+ * @param c the chunk.
+ * @return
+ */
+static uint64_t head_key(const struct chunk *c) {
+    return c->length > 0 ? *c->sorted : LOSER_TREE_EXHAUSTED;
+}
+
+/**
+ * Merge the sorted chunks with a loser tree.
+ *
+ * @param chunks the sorted chunks.
+ * @param k the number of chunks.
+ * @param descending 1 if the keys are inverted for descending order.
+ * @param numbers the list the numbers are written back to if out is NULL.
+ * @param out the writer or NULL.
+ * @return
+ */
+static int merge_chunks(struct chunk *chunks, size_t k, int descending,
+                        struct ulist *numbers, struct output *out) {
+    struct loser_tree *lt = loser_tree_init(k);
+
+    if (lt == NULL) return 1;
+
+    for (size_t i = 0; i < k; i++) lt->heads[i] = head_key(&chunks[i]);
+
+    size_t winner = loser_tree_build(lt);
+    uint32_t flip = descending ? UINT32_MAX : 0;
+    struct ulist_iter it;
+    int error = 0;
+
+    ulist_iter_begin(&it, numbers);
+
+    while (!error && lt->heads[winner] != LOSER_TREE_EXHAUSTED) {
+        uint32_t key = (uint32_t) lt->heads[winner] ^ flip;
+        int num = (int) ((int64_t) key + INT_MIN);
+
+        if (out != NULL) {
+            error = output_int(out, num);
+        } else {
+            *ulist_iter_next(&it) = num;
+        }
+
+        struct chunk *c = &chunks[winner];
+
+        c->sorted++;
+        c->length--;
+        lt->heads[winner] = head_key(c);
+        winner = loser_tree_replay(lt);
+    }
+
+    loser_tree_cleanup(lt);
+
+    return error;
+}
+
+/**
+ * Sort the numbers in chunks on jobs threads and merge them. A chunk that
+ * gets no thread is sorted by the calling thread.
+ *
+ * @param numbers the unrolled list of numbers.
+ * @param jobs the number of threads.
+ * @param merge 1 for a merge sort of the chunks, 0 for a radix sort.
+ * @param descending 1 for descending order, 0 for ascending order.
+ * @param out the writer or NULL.
+ * @return
+ */
+int parallel_sort(struct ulist *numbers, size_t jobs, int merge,
+                  int descending, struct output *out) {
+    if (numbers == NULL || jobs == 0) return 1;
+
+    size_t length = ulist_length(numbers);
+
+    if (length == 0) return 0;
+
+    // Every chunk holds at least one number.
+    if (jobs > length) jobs = length;
+
+    uint32_t *keys = malloc(sizeof(uint32_t) * length);
+    uint32_t *scratch = malloc(sizeof(uint32_t) * length);
+    struct chunk *chunks = malloc(sizeof(struct chunk) * jobs);
+    pthread_t *tids = malloc(sizeof(pthread_t) * jobs);
+    int *started = calloc(jobs, sizeof(int));
+    int error = 1;
+
+    if (keys != NULL && scratch != NULL && chunks != NULL && tids != NULL
+        && started != NULL) {
+        // Inverted keys sort in descending order of the numbers.
+        uint32_t flip = descending ? UINT32_MAX : 0;
+        struct ulist_iter it;
+        int *num;
+        size_t i = 0;
+
+        ulist_iter_begin(&it, numbers);
+
+        while ((num = ulist_iter_next(&it)) != NULL) {
+            keys[i++] = (uint32_t) ((int64_t) *num - INT_MIN) ^ flip;
+        }
+
+        for (size_t j = 0; j < jobs; j++) {
+            size_t lo = j * length / jobs;
+            size_t hi = (j + 1) * length / jobs;
+
+            chunks[j] = (struct chunk) {
+                keys + lo, scratch + lo, hi - lo, merge, NULL
+            };
+            started[j] = pthread_create(&tids[j], NULL, sort_chunk,
+                                        &chunks[j]) == 0;
+
+            if (!started[j]) sort_chunk(&chunks[j]);
+        }
+
+        for (size_t j = 0; j < jobs; j++) {
+            if (started[j]) pthread_join(tids[j], NULL);
+        }
+
+        error = merge_chunks(chunks, jobs, descending, numbers, out);
+    }
+
+    free(keys);
+    free(scratch);
+    free(chunks);
+    free(tids);
+    free(started);
+
+    return error;
+}
@@ -0,0 +1,60 @@
+/* Sorts of unsigned keys and a parallel sort of an unrolled list.
+ * The parallel sort copies the numbers to an array of keys, splits it into
+ * one chunk per worker thread and sorts the chunks at the same time. The
+ * sorted chunks are merged with a loser tree, which finds the next number
+ * with one comparison per level of the tree, and every number is written
+ * as soon as it wins. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Unrolled list data structure declaration. */
+struct ulist;
+
+/* Output data structure declaration. */
+struct output;
+
+/* Key of a source of a loser tree that has no keys left. */
+#define LOSER_TREE_EXHAUSTED UINT64_MAX
+
+/* Loser tree for a k-way merge of K sorted sources. HEADS holds the next
+ * key of every source and WINNER the source with the smallest one. Every
+ * internal node of TREE holds the loser of its match. */
+struct loser_tree {
+    size_t k;
+    size_t winner;
+    size_t *tree;
+    uint64_t *heads;
+};
+
+/* Sorts the LENGTH keys in KEYS with a least significant digit radix sort,
+ * using SCRATCH as room for LENGTH more keys.
+ * Returns the array, KEYS or SCRATCH, that holds the sorted keys. */
+uint32_t *radix_sort_keys(uint32_t *keys, uint32_t *scratch, size_t length);
+
+/* Sorts the LENGTH keys in KEYS with a bottom-up merge sort, using SCRATCH
+ * as room for LENGTH more keys.
+ * Returns the array, KEYS or SCRATCH, that holds the sorted keys. */
+uint32_t *merge_sort_keys(uint32_t *keys, uint32_t *scratch, size_t length);
+
+/* Creates a loser tree for K sources and returns a pointer to it. The
+ * heads are set by the caller before loser_tree_build is called.
+ * Returns NULL if creating failed. */
+struct loser_tree *loser_tree_init(size_t k);
+
+/* Frees loser tree LT. */
+void loser_tree_cleanup(struct loser_tree *lt);
+
+/* Plays all matches of LT and returns the winner. */
+size_t loser_tree_build(struct loser_tree *lt);
+
+/* Replays the matches of the winner of LT after its head changed and
+ * returns the new winner. */
+size_t loser_tree_replay(struct loser_tree *lt);
+
+/* Sorts NUMBERS in chunks on JOBS threads, with a merge sort if MERGE is 1
+ * and a radix sort otherwise, in descending order if DESCENDING is 1. The
+ * merged numbers are written to OUT, or back into NUMBERS if OUT is NULL.
+ * Returns 0 if successful, 1 if there was no memory or writing failed. */
+int parallel_sort(struct ulist *numbers, size_t jobs, int merge,
+                  int descending, struct output *out);
@@ -0,0 +1,344 @@
+/*H**********************************************************************
+* FILENAME: ulist.c
+*
+* DESCRIPTION:
+*   Unrolled linked list of integers, with a cache line per block.
+*
+* PUBLIC FUNCTIONS:
+*   struct ulist *ulist_init(void)
+*   int ulist_cleanup( u )
+*   size_t ulist_length( u )
+*   int ulist_add_back( u, num )
+*   int ulist_insert_at( u, i, num )
+*   int ulist_remove_at( u, i )
+*   int ulist_get( u, i, num )
+*   int ulist_set( u, i, num )
+*   void ulist_iter_begin( it, u )
+*   int *ulist_iter_next( it )
+*
+* AUTHOR: Thom Kok (Student nr: 15316491)
+*
+* START DATE: 09-11-2023
+*
+*H*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ulist.h"
+
+struct ublock {
+    struct ublock *next;
+    struct ublock *prev;
+    unsigned count;
+    int nums[ULIST_BLOCK_INTS];
+};
+
+_Static_assert(sizeof(struct ublock) == ULIST_BLOCK_SIZE,
+               "a block should fill a cache line");
+
+struct ulist {
+    struct ublock *head;
+    struct ublock *tail;
+    size_t length;
+};
+
+/**
+ * Reserve a cache line aligned block and link it after block prev, or at
+ * the front of the list if prev is NULL.
+ *
+ * @param u the list.
+ * @param prev the block before the new block.
+ * @return
+ */
+static struct ublock *new_block(struct ulist *u, struct ublock *prev) {
+    struct ublock *b = aligned_alloc(ULIST_BLOCK_SIZE, sizeof(struct ublock));
+
+    if (b == NULL) return NULL;
+
+    b->count = 0;
+    b->prev = prev;
+    b->next = prev != NULL ? prev->next : u->head;
+
+    if (b->next != NULL) {
+        b->next->prev = b;
+    } else {
+        u->tail = b;
+    }
+
+    if (prev != NULL) {
+        prev->next = b;
+    } else {
+        u->head = b;
+    }
+
+    return b;
+}
+
+/**
+ * Unlink block b from the list and free it.
+ *
+ * @param u the list.
+ * @param b the block.
+ */
+static void free_block(struct ulist *u, struct ublock *b) {
+    if (b->prev != NULL) {
+        b->prev->next = b->next;
+    } else {
+        u->head = b->next;
+    }
+
+    if (b->next != NULL) {
+        b->next->prev = b->prev;
+    } else {
+        u->tail = b->prev;
+    }
+
+    free(b);
+}
+
+/**
+ * Get the block with the i^th number and its slot in the block. The
+ * search starts from the end of the list that is closest.
+ *
+ * @param u the list.
+ * @param i the position, smaller than the length of the list.
+ * @param slot set to the slot of the number in the block.
+ * @return
+ */
+static struct ublock *find(const struct ulist *u, size_t i, size_t *slot) {
+    struct ublock *b;
+
+    if (i < u->length / 2) {
+        for (b = u->head; i >= b->count; b = b->next) i -= b->count;
+
+        *slot = i;
+    } else {
+        size_t rest = u->length - i;
+
+        for (b = u->tail; rest > b->count; b = b->prev) rest -= b->count;
+
+        *slot = b->count - rest;
+    }
+
+    return b;
+}
+
+/**
+ * Reserve bytes in memory for the list.
+ *
+ * @return
+ */
+struct ulist *ulist_init(void) {
+    struct ulist *u = malloc(sizeof(struct ulist));
+
+    if (u == NULL) return NULL;
+
+    u->head = NULL;
+    u->tail = NULL;
+    u->length = 0;
+
+    return u;
+}
+
+/**
+ * Free memory from the list and its blocks.
+ *
+ * @param u the list.
+ * @return
+ */
+int ulist_cleanup(struct ulist *u) {
+    if (u == NULL) return 1;
+
+    struct ublock *b = u->head;
+
+    while (b != NULL) {
+        struct ublock *next = b->next;
+
+        free(b);
+        b = next;
+    }
+
+    free(u);
+
+    return 0;
+}
+
+/**
+ * Get the number of integers in the list.
+ *
+ * @param u the list.
+ * @return
+ */
+size_t ulist_length(const struct ulist *u) {
+    if (u == NULL) return 0;
+
+    return u->length;
+}
+
+/**
+ * Add a number to the back of the list. Appending fills every block.
+ *
+ * @param u the list.
+ * @param num the number.
+ * @return
+ */
+int ulist_add_back(struct ulist *u, int num) {
+    if (u == NULL) return 1;
+
+    struct ublock *b = u->tail;
+
+    if (b == NULL || b->count == ULIST_BLOCK_INTS) {
+        b = new_block(u, u->tail);
+
+        if (b == NULL) return 1;
+    }
+
+    b->nums[b->count++] = num;
+    u->length++;
+
+    return 0;
+}
+
+/**
+ * Insert a number at position i.
+ *
+ * @param u the list.
+ * @param i the position of the number after inserting.
+ * @param num the number.
+ * @return
+ */
+int ulist_insert_at(struct ulist *u, size_t i, int num) {
+    if (u == NULL || i > u->length) return 1;
+    if (i == u->length) return ulist_add_back(u, num);
+
+    size_t slot;
+    struct ublock *b = find(u, i, &slot);
+
+    // Split a full block, so both halves have room to grow.
+    if (b->count == ULIST_BLOCK_INTS) {
+        struct ublock *half = new_block(u, b);
+        unsigned keep = ULIST_BLOCK_INTS / 2;
+
+        if (half == NULL) return 1;
+
+        half->count = b->count - keep;
+        memcpy(half->nums, b->nums + keep, sizeof(int) * half->count);
+        b->count = keep;
+
+        if (slot > keep) {
+            b = half;
+            slot -= keep;
+        }
+    }
+
+    memmove(b->nums + slot + 1, b->nums + slot,
+            sizeof(int) * (b->count - slot));
+    b->nums[slot] = num;
+    b->count++;
+    u->length++;
+
+    return 0;
+}
+
+/**
+ * Remove the number at position i.
+ *
+ * @param u the list.
+ * @param i the position.
+ * @return
+ */
+int ulist_remove_at(struct ulist *u, size_t i) {
+    if (u == NULL || i >= u->length) return 1;
+
+    size_t slot;
+    struct ublock *b = find(u, i, &slot);
+
+    memmove(b->nums + slot, b->nums + slot + 1,
+            sizeof(int) * (b->count - slot - 1));
+    b->count--;
+    u->length--;
+
+    if (b->count == 0) {
+        free_block(u, b);
+    } else if (b->count < ULIST_BLOCK_INTS / 2 && b->next != NULL
+               && b->count + b->next->count <= ULIST_BLOCK_INTS) {
+        struct ublock *next = b->next;
+
+        memcpy(b->nums + b->count, next->nums, sizeof(int) * next->count);
+        b->count += next->count;
+        free_block(u, next);
+    }
+
+    return 0;
+}
+
+/**
+ * Get the number at position i.
+ *
+ * @param u the list.
+ * @param i the position.
+ * @param num set to the number.
+ * @return
+ */
+int ulist_get(const struct ulist *u, size_t i, int *num) {
+    if (u == NULL || num == NULL || i >= u->length) return 1;
+
+    size_t slot;
+    struct ublock *b = find(u, i, &slot);
+
+    *num = b->nums[slot];
+
+    return 0;
+}
+
+/**
+ * Set the number at position i.
+ *
+ * @param u the list.
+ * @param i the position.
+ * @param num the number.
+ * @return
+ */
+int ulist_set(struct ulist *u, size_t i, int num) {
+    if (u == NULL || i >= u->length) return 1;
+
+    size_t slot;
+    struct ublock *b = find(u, i, &slot);
+
+    b->nums[slot] = num;
+
+    return 0;
+}
+
+/**
+ * Place the cursor on the first number of the list.
+ *
+ * @param it the cursor.
+ * @param u the list.
+ */
+void ulist_iter_begin(struct ulist_iter *it, const struct ulist *u) {
+    if (it == NULL) return;
+
+    it->block = u != NULL ? u->head : NULL;
+    it->slot = 0;
+}
+
+/**
+ * Get the number under the cursor and move the cursor to the next number.
+ *
+ * @param it the cursor.
+ * @return
+ */
+int *ulist_iter_next(struct ulist_iter *it) {
+    if (it == NULL) return NULL;
+
+    while (it->block != NULL && it->slot >= it->block->count) {
+        it->block = it->block->next;
+        it->slot = 0;
+    }
+
+    if (it->block == NULL) return NULL;
+
+    return &it->block->nums[it->slot++];
+}
@@ -0,0 +1,69 @@
+/* Unrolled linked list of integers.
+ * Every block of the list fills one cache line with the links to its
+ * neighbours and up to ULIST_BLOCK_INTS numbers, so a number costs about
+ * 6 bytes instead of a node of its own, and walking the list reads the
+ * numbers of a block from a single cache line.
+ * The numbers have no node of their own, so they are addressed by their
+ * position in the list or with a cursor. */
+
+#include <stddef.h>
+
+/* Size in bytes of a block, the size of a cache line. */
+#define ULIST_BLOCK_SIZE 64
+
+/* Number of integers that fit in a block next to its links and count. */
+#define ULIST_BLOCK_INTS \
+    ((ULIST_BLOCK_SIZE - 2 * sizeof(void *) - sizeof(unsigned)) / sizeof(int))
+
+/* Unrolled list data structure declaration. */
+struct ulist;
+
+/* Block of an unrolled list declaration. */
+struct ublock;
+
+/* Cursor into an unrolled list, on a number of a block or past the end. */
+struct ulist_iter {
+    struct ublock *block;
+    size_t slot;
+};
+
+/* Creates a new unrolled list and returns a pointer to it.
+ * Returns NULL on failure. */
+struct ulist *ulist_init(void);
+
+/* Cleans up the unrolled list U and all its blocks.
+ * Returns 0 if successful, 1 otherwise. */
+int ulist_cleanup(struct ulist *u);
+
+/* Returns the number of integers in U, or 0 if U is the NULL pointer. */
+size_t ulist_length(const struct ulist *u);
+
+/* Appends NUM at the back of U.
+ * Returns 0 if NUM was successfully appended, 1 otherwise. */
+int ulist_add_back(struct ulist *u, int num);
+
+/* Inserts NUM in U so that it becomes the I^th number. A full block is
+ * split into two half full blocks first.
+ * Returns 0 if NUM was successfully inserted, 1 otherwise. */
+int ulist_insert_at(struct ulist *u, size_t i, int num);
+
+/* Removes the I^th number of U. A block that becomes less than half full
+ * is merged with the next block if their numbers fit in one block.
+ * Returns 0 if the number was successfully removed, 1 otherwise. */
+int ulist_remove_at(struct ulist *u, size_t i);
+
+/* Stores the I^th number of U in NUM.
+ * Returns 0 if successful, 1 if there is no I^th number. */
+int ulist_get(const struct ulist *u, size_t i, int *num);
+
+/* Sets the I^th number of U to NUM.
+ * Returns 0 if successful, 1 if there is no I^th number. */
+int ulist_set(struct ulist *u, size_t i, int num);
+
+/* Places cursor IT on the first number of U. */
+void ulist_iter_begin(struct ulist_iter *it, const struct ulist *u);
+
+/* Returns a pointer to the number under cursor IT and moves the cursor to
+ * the next number, or returns NULL if IT is past the end. The number may
+ * be changed through the pointer until U is changed. */
+int *ulist_iter_next(struct ulist_iter *it);